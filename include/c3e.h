@@ -33,13 +33,31 @@
 #   error "Incompatible target architecture using C3E."
 #endif
 
+#include <c3e/archive.h>
 #include <c3e/assert.h>
+#include <c3e/checkpoint.h>
+#include <c3e/codec.h>
+#include <c3e/collective.h>
 #include <c3e/commons.h>
+#include <c3e/context.h>
+#include <c3e/csv.h>
+#include <c3e/disk_matrix.h>
+#include <c3e/dist_matrix.h>
+#include <c3e/graph.h>
+#include <c3e/loader.h>
 #include <c3e/matrix.h>
 #include <c3e/matrix_tuple.h>
+#include <c3e/memory.h>
+#include <c3e/montecarlo.h>
 #include <c3e/net.h>
+#include <c3e/npy.h>
+#include <c3e/pool.h>
+#include <c3e/pubsub.h>
 #include <c3e/random.h>
+#include <c3e/remote.h>
+#include <c3e/stream.h>
 #include <c3e/svd.h>
+#include <c3e/sync.h>
 #include <c3e/tensor.h>
 #include <c3e/trigo.h>
 #include <c3e/vector.h>
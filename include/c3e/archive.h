@@ -0,0 +1,258 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file archive.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Memory-mappable container files for matrices, vectors and tensors.
+ *
+ * A C3E archive holds any number of named arrays. All integers are stored in
+ * little-endian order, and the file is laid out as follows:
+ *
+ * - A 64-byte header: the magic number `C3E_ARCHIVE_MAGIC` (u32), the format
+ *   version (u16), two reserved bytes, the number of entries (u32), four reserved
+ *   bytes and the offset of the directory (u64), padded with zeros.
+ * - The payloads, each starting at a multiple of `C3E_ARCHIVE_ALIGNMENT` bytes.
+ *   Elements are stored row-major, either raw in the entry's element type or as
+ *   a buffer produced by `c3e_codec_encode()`.
+ * - The directory: one `c3e_archive_entry` per array.
+ *
+ * The payload of a tensor starts with one `c3e_archive_block` per matrix plus one
+ * for its data vector, followed by the aligned blocks themselves.
+ *
+ * Opening an archive maps the whole file, and raw arrays whose element type
+ * matches `c3e_number` are returned without copying: their `data` points into
+ * the mapping, which is shared between processes through the page cache.
+ */
+#ifndef C3E_ARCHIVE_H
+#define C3E_ARCHIVE_H
+
+#include <c3e/codec.h>
+#include <c3e/commons.h>
+#include <c3e/net.h>
+
+/**
+ * @def C3E_ARCHIVE_MAGIC
+ * @brief Magic number ("C3EA") opening every archive.
+ */
+#define C3E_ARCHIVE_MAGIC 0x41453343u
+
+/**
+ * @def C3E_ARCHIVE_VERSION
+ * @brief Version of the archive format written by this library.
+ */
+#define C3E_ARCHIVE_VERSION 1
+
+/**
+ * @def C3E_ARCHIVE_ALIGNMENT
+ * @brief Alignment of every payload within the file, in bytes.
+ */
+#define C3E_ARCHIVE_ALIGNMENT 64
+
+/**
+ * @def C3E_ARCHIVE_NAME_SIZE
+ * @brief Size of an entry name, including the terminating null character.
+ */
+#define C3E_ARCHIVE_NAME_SIZE 64
+
+/**
+ * @enum c3e_archive_kind
+ * @brief Kind of array held by an archive entry.
+ */
+typedef enum {
+    C3E_ARCHIVE_MATRIX = 0,     ///< A `c3e_matrix`.
+    C3E_ARCHIVE_VECTOR = 1,     ///< A `c3e_vector`, stored as a single column.
+    C3E_ARCHIVE_TENSOR = 2      ///< A `c3e_tensor`.
+} c3e_archive_kind;
+
+/**
+ * @struct c3e_archive_entry
+ * @brief Directory entry describing one array, 128 bytes on disk.
+ */
+typedef struct {
+    char name[C3E_ARCHIVE_NAME_SIZE];   ///< Null-terminated name of the array.
+    uint8_t kind;                       ///< A `c3e_archive_kind`.
+    uint8_t dtype;                      ///< A concrete `c3e_dtype`, never `C3E_DTYPE_NATIVE`.
+    uint8_t codec;                      ///< The `c3e_codec` of the payload.
+    uint8_t reserved;                   ///< Always zero.
+    uint32_t rows;                      ///< Rows of a matrix, size of a vector or dimensions of a tensor.
+    uint32_t cols;                      ///< Columns of a matrix, 1 for vectors and 0 for tensors.
+    uint32_t padding;                   ///< Always zero.
+    uint64_t dimension_size;            ///< Dimension size of a tensor, 0 otherwise.
+    uint64_t offset;                    ///< Offset of the payload in the file.
+    uint64_t size;                      ///< Size of the payload in bytes.
+    uint8_t unused[24];                 ///< Always zero.
+} c3e_archive_entry;
+
+/**
+ * @struct c3e_archive_block
+ * @brief Location of one matrix or data vector inside the payload of a tensor.
+ */
+typedef struct {
+    uint32_t rows;      ///< Number of rows.
+    uint32_t cols;      ///< Number of columns.
+    uint64_t offset;    ///< Offset of the block in the file.
+    uint64_t size;      ///< Size of the block in bytes.
+} c3e_archive_block;
+
+/**
+ * @struct c3e_archive_writer
+ * @brief An archive being written.
+ */
+typedef struct {
+    int fd;                         ///< Descriptor of the file being written.
+    uint64_t position;              ///< End of the last payload.
+    c3e_archive_entry* entries;     ///< Directory built so far.
+    uint32_t count;                 ///< Number of entries.
+    uint32_t capacity;              ///< Number of allocated entries.
+} c3e_archive_writer;
+
+/**
+ * @struct c3e_archive
+ * @brief An archive opened for reading.
+ */
+typedef struct {
+    int fd;                         ///< Descriptor of the file, kept open for `sendfile()`.
+    uint8_t* map;                   ///< Copy-on-write mapping of the whole file.
+    size_t size;                    ///< Size of the file.
+    c3e_archive_entry* entries;     ///< Directory, inside the mapping.
+    uint32_t count;                 ///< Number of entries.
+    void** objects;                 ///< Array loaded from every entry, NULL until requested.
+    c3e_number** buffers;           ///< Decoded elements of entries that could not be mapped.
+} c3e_archive;
+
+/**
+ * @brief Creates an archive, replacing any file at the same path.
+ *
+ * @param path Path of the file.
+ * @return Pointer to the writer, or NULL on failure.
+ */
+c3e_archive_writer* c3e_archive_create(const char* path);
+
+/**
+ * @brief Appends a matrix to an archive.
+ *
+ * @param writer Pointer to the writer.
+ * @param name Unique name of the array.
+ * @param matrix Pointer to the matrix.
+ * @param dtype Element type stored in the file.
+ * @param codec Codec of the payload; only used with native elements.
+ * @return `true` if the matrix was written, `false` otherwise.
+ */
+bool c3e_archive_put_matrix(c3e_archive_writer* writer, const char* name, c3e_matrix* matrix, c3e_dtype dtype, c3e_codec codec);
+
+/**
+ * @brief Appends a vector to an archive.
+ *
+ * @param writer Pointer to the writer.
+ * @param name Unique name of the array.
+ * @param vector Pointer to the vector.
+ * @param dtype Element type stored in the file.
+ * @param codec Codec of the payload; only used with native elements.
+ * @return `true` if the vector was written, `false` otherwise.
+ */
+bool c3e_archive_put_vector(c3e_archive_writer* writer, const char* name, c3e_vector* vector, c3e_dtype dtype, c3e_codec codec);
+
+/**
+ * @brief Appends a tensor to an archive.
+ *
+ * @param writer Pointer to the writer.
+ * @param name Unique name of the array.
+ * @param tensor Pointer to the tensor.
+ * @param dtype Element type stored in the file.
+ * @param codec Codec of the payloads; only used with native elements.
+ * @return `true` if the tensor was written, `false` otherwise.
+ */
+bool c3e_archive_put_tensor(c3e_archive_writer* writer, const char* name, c3e_tensor* tensor, c3e_dtype dtype, c3e_codec codec);
+
+/**
+ * @brief Writes the directory and the header, closes the file and frees the writer.
+ *
+ * @param writer Pointer to the writer.
+ * @return `true` if the archive is complete, `false` otherwise.
+ */
+bool c3e_archive_finish(c3e_archive_writer* writer);
+
+/**
+ * @brief Opens an archive by mapping it into memory.
+ *
+ * @param path Path of the file.
+ * @return Pointer to the archive, or NULL if it could not be mapped or is malformed.
+ */
+c3e_archive* c3e_archive_open(const char* path);
+
+/**
+ * @brief Unmaps an archive and frees every array obtained from it.
+ *
+ * @param archive Pointer to the archive.
+ */
+void c3e_archive_close(c3e_archive* archive);
+
+/**
+ * @brief Looks up an entry by name.
+ *
+ * @param archive Pointer to the archive.
+ * @param name Name of the array.
+ * @return Pointer to the entry, or NULL if there is none with this name.
+ */
+c3e_archive_entry* c3e_archive_find(c3e_archive* archive, const char* name);
+
+/**
+ * @brief Gets a matrix from an archive.
+ *
+ * The matrix belongs to the archive: it must not be freed nor resized, and is
+ * valid until `c3e_archive_close()`. Writes to it stay private to the process.
+ *
+ * @param archive Pointer to the archive.
+ * @param name Name of the matrix.
+ * @return Pointer to the matrix, or NULL if it is missing or malformed.
+ */
+c3e_matrix* c3e_archive_matrix(c3e_archive* archive, const char* name);
+
+/**
+ * @brief Gets a vector from an archive, with the same ownership as `c3e_archive_matrix()`.
+ *
+ * @param archive Pointer to the archive.
+ * @param name Name of the vector.
+ * @return Pointer to the vector, or NULL if it is missing or malformed.
+ */
+c3e_vector* c3e_archive_vector(c3e_archive* archive, const char* name);
+
+/**
+ * @brief Gets a tensor from an archive, with the same ownership as `c3e_archive_matrix()`.
+ *
+ * @param archive Pointer to the archive.
+ * @param name Name of the tensor.
+ * @return Pointer to the tensor, or NULL if it is missing or malformed.
+ */
+c3e_tensor* c3e_archive_tensor(c3e_archive* archive, const char* name);
+
+/**
+ * @brief Sends a matrix or vector of an archive straight from the file.
+ *
+ * Only entries stored without a codec can be sent this way. The message is read
+ * with `c3e_socket_typed_matrix_read()` or `c3e_socket_typed_vector_read()`.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for sending.
+ * @param archive Pointer to the archive.
+ * @param name Name of the array.
+ * @return `true` if the array was sent, `false` otherwise.
+ * @see c3e_socket_send_file_matrix
+ */
+bool c3e_socket_send_archive_entry(c3e_socket* socket, c3e_archive* archive, const char* name);
+
+#endif /* C3E_ARCHIVE_H */
\ No newline at end of file
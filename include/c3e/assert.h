@@ -46,7 +46,8 @@ void c3e_assert(bool condition);
  *
  * This function sets a custom handler function that will be called when an assertion fails.
  * The handler function should accept two parameters: a filename and a line number where the
- * assertion failed.
+ * assertion failed. The handler is stored in the context of the calling thread, and also
+ * applies to the parallel work that thread starts.
  *
  * @param event A pointer to the custom handler function. This function will be called when
  *              an assertion fails. The handler function should have the signature:
@@ -63,7 +64,7 @@ void c3e_assert_handler(void (*event)(const char* filename, int line));
  * `c3e_assert_handler()`. After calling this function, assertions will use the default
  * behavior, which is to terminate the program.
  */
-void c3e_assert_remove_handle();
+void c3e_assert_remove_handler();
 
 /**
  * @brief Checks if a custom assertion handler is currently set.
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file checkpoint.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Asynchronous, crash-consistent checkpoints of matrices, vectors and tensors.
+ *
+ * Adding an array to a checkpoint only copies its elements, so the caller may
+ * keep modifying it right away. Committing the checkpoint writes the copies as an
+ * archive on a background thread: the archive goes to a temporary file next to
+ * the destination, is flushed to the device and only then renamed over the
+ * destination, so a crash at any point leaves either the previous checkpoint or
+ * the new one, never a partial file. Checkpoints are read back with
+ * `c3e_archive_open()`.
+ */
+#ifndef C3E_CHECKPOINT_H
+#define C3E_CHECKPOINT_H
+
+#include <c3e/archive.h>
+#include <c3e/commons.h>
+#include <c3e/context.h>
+
+#include <pthread.h>
+
+/**
+ * @typedef c3e_checkpoint_callback
+ * @brief Function called on the background thread once a checkpoint is written or has failed.
+ *
+ * @param path Path of the checkpoint.
+ * @param success Whether the checkpoint was written and renamed into place.
+ * @param context Pointer given to `c3e_checkpoint_commit()`.
+ */
+typedef void (*c3e_checkpoint_callback)(const char* path, bool success, void* context);
+
+/**
+ * @struct c3e_checkpoint_entry
+ * @brief Snapshot of one array of a checkpoint.
+ */
+typedef struct {
+    char name[C3E_ARCHIVE_NAME_SIZE];   ///< Name of the array in the archive.
+    c3e_archive_kind kind;              ///< Kind of the array.
+    void* object;                       ///< Copy of the array, owned by the checkpoint.
+} c3e_checkpoint_entry;
+
+/**
+ * @struct c3e_checkpoint
+ * @brief A checkpoint being assembled or written.
+ */
+typedef struct {
+    char* path;                         ///< Destination of the checkpoint.
+    c3e_checkpoint_entry* entries;      ///< Snapshots taken so far.
+    uint32_t count;                     ///< Number of snapshots.
+    uint32_t capacity;                  ///< Number of allocated snapshots.
+    c3e_dtype dtype;                    ///< Element type stored in the archive.
+    c3e_checkpoint_callback callback;   ///< Completion callback, or NULL.
+    void* context;                      ///< Argument of the callback.
+    c3e_context_settings settings;      ///< Settings of the committing thread, used by the writer.
+    pthread_t thread;                   ///< Thread writing the checkpoint.
+    bool committed;                     ///< Whether the thread was started.
+    bool success;                       ///< Outcome, valid once the thread is done.
+} c3e_checkpoint;
+
+/**
+ * @brief Starts a checkpoint.
+ *
+ * @param path Path of the checkpoint, replaced once it is complete.
+ * @param dtype Element type stored in the archive.
+ * @return Pointer to the checkpoint, or NULL on failure.
+ */
+c3e_checkpoint* c3e_checkpoint_begin(const char* path, c3e_dtype dtype);
+
+/**
+ * @brief Snapshots a matrix into a checkpoint.
+ *
+ * @param checkpoint Pointer to a checkpoint that was not committed yet.
+ * @param name Unique name of the array.
+ * @param matrix Pointer to the matrix, free to change once this returns.
+ * @return `true` if the matrix was copied, `false` otherwise.
+ */
+bool c3e_checkpoint_add_matrix(c3e_checkpoint* checkpoint, const char* name, c3e_matrix* matrix);
+
+/**
+ * @brief Snapshots a vector into a checkpoint.
+ *
+ * @param checkpoint Pointer to a checkpoint that was not committed yet.
+ * @param name Unique name of the array.
+ * @param vector Pointer to the vector, free to change once this returns.
+ * @return `true` if the vector was copied, `false` otherwise.
+ */
+bool c3e_checkpoint_add_vector(c3e_checkpoint* checkpoint, const char* name, c3e_vector* vector);
+
+/**
+ * @brief Snapshots a tensor into a checkpoint.
+ *
+ * @param checkpoint Pointer to a checkpoint that was not committed yet.
+ * @param name Unique name of the array.
+ * @param tensor Pointer to the tensor, free to change once this returns.
+ * @return `true` if the tensor was copied, `false` otherwise.
+ */
+bool c3e_checkpoint_add_tensor(c3e_checkpoint* checkpoint, const char* name, c3e_tensor* tensor);
+
+/**
+ * @brief Starts writing a checkpoint on a background thread.
+ *
+ * @param checkpoint Pointer to the checkpoint.
+ * @param callback Function called once the checkpoint is written or has failed, or NULL.
+ * @param context Argument of the callback.
+ * @return `true` if the thread was started, `false` otherwise.
+ */
+bool c3e_checkpoint_commit(c3e_checkpoint* checkpoint, c3e_checkpoint_callback callback, void* context);
+
+/**
+ * @brief Waits for a checkpoint to be written and frees it.
+ *
+ * A checkpoint that was never committed is discarded without touching the file.
+ *
+ * @param checkpoint Pointer to the checkpoint.
+ * @return `true` if the checkpoint was written and renamed into place, `false` otherwise.
+ */
+bool c3e_checkpoint_wait(c3e_checkpoint* checkpoint);
+
+#endif /* C3E_CHECKPOINT_H */
\ No newline at end of file
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file codec.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Lossless compression of numerical arrays for the C3E library.
+ *
+ * This file provides codecs used to shrink arrays of `c3e_number` before they are
+ * sent over the network or written to disk. The `C3E_CODEC_XOR_LZ` codec XORs every
+ * element with its predecessor (as in Gorilla-style float compression) and shuffles
+ * the resulting bytes into planes, one per byte of an element. Planes holding a
+ * single value, such as the high-order bytes of slowly varying data, take one byte;
+ * the others are compressed with a fast LZ77 stage that skips ahead over data it
+ * cannot match, and stored as-is when that does not pay off.
+ *
+ * Integers, sparse arrays and piecewise constant data shrink by one to several
+ * orders of magnitude. The low-order mantissa bytes of measured or computed
+ * floating-point data are close to random, though: smooth double precision
+ * signals shrink by about 1.4 times and noisy ones by about 1.3 times, at several
+ * hundred megabytes per second. The codec thus only pays off on links slower than
+ * that, and sockets keep sending raw elements unless both peers negotiate it.
+ *
+ * It also provides the conversions between `c3e_number` and the reduced-precision
+ * element types (`float32` and `bfloat16`) that can be used on the wire when a
+ * consumer explicitly accepts the loss of precision.
+ */
+#ifndef C3E_CODEC_H
+#define C3E_CODEC_H
+
+#include <c3e/commons.h>
+
+/**
+ * @enum c3e_codec
+ * @brief Identifies a payload codec.
+ *
+ * Codecs are ordered from the cheapest to the most expensive, so that two peers
+ * can settle on the lowest codec both of them proposed.
+ */
+typedef enum {
+    C3E_CODEC_NONE = 0,     ///< Payload is sent as raw `c3e_number` elements.
+    C3E_CODEC_XOR_LZ = 1    ///< XOR-delta, byte shuffle and LZ77 compression.
+} c3e_codec;
+
+/**
+ * @enum c3e_dtype
+ * @brief Identifies the element type of a payload.
+ */
+typedef enum {
+    C3E_DTYPE_NATIVE = 0,   ///< Elements are `c3e_number`, as in memory.
+    C3E_DTYPE_FLOAT64 = 1,  ///< Elements are IEEE 754 double precision floats.
+    C3E_DTYPE_FLOAT32 = 2,  ///< Elements are IEEE 754 single precision floats.
+    C3E_DTYPE_BFLOAT16 = 3  ///< Elements are bfloat16, the upper half of a float32.
+} c3e_dtype;
+
+/**
+ * @def C3E_CODEC_HEADER_SIZE
+ * @brief Size in bytes of the header opening every encoded block.
+ */
+#define C3E_CODEC_HEADER_SIZE 16
+
+/**
+ * @def C3E_CODEC_BLOCK
+ * @brief Number of elements encoded in every block, 1 MiB of `c3e_number`.
+ */
+#define C3E_CODEC_BLOCK (((size_t) 1 << 20) / sizeof(c3e_number))
+
+/**
+ * @brief Computes the worst-case size of an encoded buffer.
+ *
+ * Incompressible blocks are stored as-is, so an encoded buffer never exceeds the
+ * raw size of the elements plus one codec header per block.
+ *
+ * @param codec The codec to be used.
+ * @param count The number of elements to be encoded.
+ * @return The capacity in bytes an output buffer must have for `c3e_codec_encode()`.
+ */
+size_t c3e_codec_bound(c3e_codec codec, size_t count);
+
+/**
+ * @brief Encodes an array of numbers with the specified codec.
+ *
+ * The elements are cut into blocks of `C3E_CODEC_BLOCK` elements, each encoded
+ * on its own behind its own header, so the scratch memory used does not depend
+ * on the number of elements. Encoding an array block by block and concatenating
+ * the results gives the same buffer.
+ *
+ * @param codec The codec to be used.
+ * @param data Pointer to the elements to be encoded.
+ * @param count The number of elements to be encoded.
+ * @param out Pointer to the output buffer.
+ * @param capacity The size of the output buffer in bytes.
+ * @return The number of bytes written to `out`, or 0 on failure.
+ */
+size_t c3e_codec_encode(c3e_codec codec, const c3e_number* data, size_t count, void* out, size_t capacity);
+
+/**
+ * @brief Decodes a buffer produced by `c3e_codec_encode()`.
+ *
+ * @param in Pointer to the encoded buffer.
+ * @param size The size of the encoded buffer in bytes.
+ * @param out Pointer to the output elements.
+ * @param count The number of elements expected in `out`.
+ * @return `true` if the buffer was decoded into exactly `count` elements, `false` otherwise.
+ */
+bool c3e_codec_decode(const void* in, size_t size, c3e_number* out, size_t count);
+
+/**
+ * @brief Retrieves the size in bytes of one element of the specified type.
+ *
+ * @param dtype The element type.
+ * @return The size in bytes of one element, or 0 for an unknown type.
+ */
+size_t c3e_dtype_size(c3e_dtype dtype);
+
+/**
+ * @brief Converts numbers into the specified element type.
+ *
+ * Conversions to `C3E_DTYPE_BFLOAT16` round to the nearest even value. The loops
+ * are written branch-free over contiguous arrays so that they are vectorized by
+ * the compiler.
+ *
+ * @param dtype The element type to be produced.
+ * @param in Pointer to the numbers to be converted.
+ * @param out Pointer to `count * c3e_dtype_size(dtype)` bytes of output.
+ * @param count The number of elements to be converted.
+ */
+void c3e_dtype_narrow(c3e_dtype dtype, const c3e_number* in, void* out, size_t count);
+
+/**
+ * @brief Converts elements of the specified type back into numbers.
+ *
+ * @param dtype The element type of the input.
+ * @param in Pointer to `count * c3e_dtype_size(dtype)` bytes of input.
+ * @param out Pointer to the numbers to be produced.
+ * @param count The number of elements to be converted.
+ */
+void c3e_dtype_widen(c3e_dtype dtype, const void* in, c3e_number* out, size_t count);
+
+#endif /* C3E_CODEC_H */
\ No newline at end of file
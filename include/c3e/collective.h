@@ -0,0 +1,180 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file collective.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Collective operations over groups of C3E processes.
+ *
+ * This file provides collective communication (all-reduce, reduce-scatter,
+ * all-gather and broadcast) among a group of processes connected with C3E
+ * sockets. Buffers are split into chunks that are sent and received at the same
+ * time, and every received chunk is reduced while the following ones are still
+ * in flight.
+ */
+#ifndef C3E_COLLECTIVE_H
+#define C3E_COLLECTIVE_H
+
+#include <c3e/commons.h>
+#include <c3e/net.h>
+
+/**
+ * @def C3E_COLLECTIVE_CHUNK
+ * @brief Number of elements transferred and reduced as one pipelined chunk.
+ */
+#define C3E_COLLECTIVE_CHUNK 16384
+
+/**
+ * @enum c3e_collective_algo
+ * @brief Selects the communication pattern of a collective operation.
+ */
+typedef enum {
+    C3E_COLLECTIVE_RING = 0,    ///< Bandwidth-optimal ring over all the processes.
+    C3E_COLLECTIVE_TREE = 1     ///< Latency-optimal binomial tree.
+} c3e_collective_algo;
+
+/**
+ * @struct c3e_group
+ * @brief A group of processes connected to each other.
+ */
+typedef struct {
+    uint32_t rank;          ///< Index of this process in the group.
+    uint32_t size;          ///< Number of processes in the group.
+    c3e_socket* peers;      ///< Connection to every other process, indexed by rank.
+    c3e_number* scratch;    ///< Chunk buffer used to receive operands being reduced.
+    bool borrowed;          ///< Whether the connections belong to a parent group.
+} c3e_group;
+
+/**
+ * @brief Joins a group of processes.
+ *
+ * Every process listens on `base_port + rank` of its own host, connects to every
+ * lower rank and accepts connections from every higher rank. All the processes of
+ * the group must call this function with the same hosts and base port.
+ *
+ * @param rank Index of this process in the group.
+ * @param size Number of processes in the group.
+ * @param hostnames IP address of the host of every rank.
+ * @param base_port Port number listened on by rank 0.
+ * @return Pointer to the connected group, or NULL on failure.
+ */
+c3e_group* c3e_group_init(uint32_t rank, uint32_t size, const char** hostnames, int base_port);
+
+/**
+ * @brief Closes every connection of a group and frees it.
+ *
+ * @param group Pointer to the group to be freed.
+ */
+void c3e_group_free(c3e_group* group);
+
+/**
+ * @brief Creates a group made of some of the processes of another group.
+ *
+ * The subgroup reuses the connections of its parent, which must outlive it, and
+ * ranks its members in the order given. Every member must call this function with
+ * the same list, which has to include the calling process. Collective operations
+ * must not run on a group and one of its subgroups at the same time.
+ *
+ * @param group Pointer to the parent group.
+ * @param ranks Ranks of the members in the parent group.
+ * @param count Number of members.
+ * @return Pointer to the subgroup, or NULL on failure.
+ */
+c3e_group* c3e_group_subset(c3e_group* group, const uint32_t* ranks, uint32_t count);
+
+/**
+ * @brief Computes the segment of a buffer owned by a rank.
+ *
+ * Buffers are split into `size` contiguous segments whose lengths differ by at
+ * most one element. Rank `index` owns segment `index` in `c3e_group_reduce_scatter()`
+ * and `c3e_group_all_gather()`.
+ *
+ * @param group Pointer to the group.
+ * @param count Number of elements in the buffer.
+ * @param index Index of the segment.
+ * @param offset Receives the index of the first element of the segment.
+ * @param length Receives the number of elements of the segment.
+ */
+void c3e_group_segment(c3e_group* group, size_t count, uint32_t index, size_t* offset, size_t* length);
+
+/**
+ * @brief Sums a buffer across the group, leaving the result on every process.
+ *
+ * @param group Pointer to the group.
+ * @param data Buffer of `count` elements, replaced by the element-wise sum.
+ * @param count Number of elements in the buffer.
+ * @param algo Communication pattern to be used.
+ * @return `true` if the operation completed, `false` otherwise.
+ */
+bool c3e_group_all_reduce(c3e_group* group, c3e_number* data, size_t count, c3e_collective_algo algo);
+
+/**
+ * @brief Sums a buffer across the group, leaving each rank with its own segment.
+ *
+ * After the call, only the segment owned by this rank (see `c3e_group_segment()`)
+ * holds the element-wise sum; the other segments hold partial sums.
+ *
+ * @param group Pointer to the group.
+ * @param data Buffer of `count` elements.
+ * @param count Number of elements in the buffer.
+ * @return `true` if the operation completed, `false` otherwise.
+ */
+bool c3e_group_reduce_scatter(c3e_group* group, c3e_number* data, size_t count);
+
+/**
+ * @brief Gathers the segment owned by every rank into every process.
+ *
+ * @param group Pointer to the group.
+ * @param data Buffer of `count` elements whose own segment is filled by this rank.
+ * @param count Number of elements in the buffer.
+ * @return `true` if the operation completed, `false` otherwise.
+ */
+bool c3e_group_all_gather(c3e_group* group, c3e_number* data, size_t count);
+
+/**
+ * @brief Copies a buffer from one rank to every process of the group.
+ *
+ * @param group Pointer to the group.
+ * @param data Buffer of `count` elements, read on `root` and written elsewhere.
+ * @param count Number of elements in the buffer.
+ * @param root Rank holding the data to be broadcast.
+ * @param algo Communication pattern: a pipelined chain or a binomial tree.
+ * @return `true` if the operation completed, `false` otherwise.
+ */
+bool c3e_group_broadcast(c3e_group* group, c3e_number* data, size_t count, uint32_t root, c3e_collective_algo algo);
+
+/**
+ * @brief Sums a matrix across the group, leaving the result on every process.
+ *
+ * @param group Pointer to the group.
+ * @param matrix Pointer to the matrix, with the same shape on every process.
+ * @param algo Communication pattern to be used.
+ * @return `true` if the operation completed, `false` otherwise.
+ */
+bool c3e_group_all_reduce_matrix(c3e_group* group, c3e_matrix* matrix, c3e_collective_algo algo);
+
+/**
+ * @brief Sums a vector across the group, leaving the result on every process.
+ *
+ * @param group Pointer to the group.
+ * @param vector Pointer to the vector, with the same size on every process.
+ * @param algo Communication pattern to be used.
+ * @return `true` if the operation completed, `false` otherwise.
+ */
+bool c3e_group_all_reduce_vector(c3e_group* group, c3e_vector* vector, c3e_collective_algo algo);
+
+#endif /* C3E_COLLECTIVE_H */
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file context.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Per-thread library context.
+ *
+ * The mutable state the library used to keep in globals lives in a context:
+ * the generators behind `c3e_random()` and `c3e_random_pseudo()`, the assertion
+ * handler, the allocator of element buffers, the executor of parallel loops,
+ * counters and the last error. Every thread has a default context of its own,
+ * created on first use, so threads using the library independently share no
+ * mutable state and take no lock for it. A thread may also switch to a context
+ * of its choosing, for example to give every request of a server its own
+ * reproducible generator.
+ *
+ * Parallel loops and tasks run their work under the settings of the thread that
+ * started them, so the assertion handler, allocator and executor it installed
+ * also apply on the threads of the pool; generators, counters and errors stay
+ * those of the thread actually running the work. Stream operations take the
+ * settings of the thread that enqueued them, and the threads the library starts
+ * for loaders, checkpoints, subscribers, remote connections and panel prefetches
+ * take those of the thread that started them.
+ */
+#ifndef C3E_CONTEXT_H
+#define C3E_CONTEXT_H
+
+#include <c3e/pool.h>
+#include <c3e/random.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @struct c3e_allocator
+ * @brief Allocator of element buffers, such as an arena of the application.
+ */
+typedef struct {
+    void* (*alloc)(size_t size, void* state);   ///< Returns a block of `size` bytes aligned to 64 bytes, or NULL.
+    void (*free)(void* data, void* state);      ///< Gives back a block returned by `alloc`.
+    void* state;                                ///< Last argument of both functions.
+} c3e_allocator;
+
+/**
+ * @struct c3e_context_settings
+ * @brief Settings of a context, inherited by the parallel work it starts.
+ */
+typedef struct {
+    void (*assert_handler)(const char* filename, int line);    ///< Called on failed assertions, or NULL to exit.
+    c3e_allocator allocator;                                    ///< Allocator of element buffers, or all NULL for the built-in one.
+    c3e_executor executor;                                      ///< Executor of parallel loops, or all NULL for the pool of C3E.
+} c3e_context_settings;
+
+/**
+ * @struct c3e_context_counters
+ * @brief Instrumentation counters of a context.
+ */
+typedef struct {
+    uint64_t allocations;       ///< Element buffers allocated.
+    uint64_t bytes;             ///< Bytes requested by those allocations.
+    uint64_t frees;             ///< Element buffers freed.
+    uint64_t parallel_loops;    ///< Parallel loops and reductions started.
+    uint64_t tasks;             ///< Tasks spawned on the pool.
+    uint64_t assertions;        ///< Assertions failed.
+} c3e_context_counters;
+
+/**
+ * @struct c3e_context
+ * @brief State of the library used by one thread at a time.
+ */
+typedef struct {
+    c3e_context_settings settings;  ///< Settings inherited by parallel work.
+    c3e_rng rng;                    ///< Generator of `c3e_random()`.
+    bool seeded;                    ///< Whether `rng` was seeded, from `/dev/urandom` on first use otherwise.
+    c3e_rng pseudo;                 ///< Generator of `c3e_random_pseudo()`, with a fixed seed.
+    c3e_context_counters counters;  ///< Instrumentation counters.
+    int error;                      ///< Last error, as an `errno` value, or 0.
+} c3e_context;
+
+/**
+ * @brief Initializes a context with default settings.
+ *
+ * @param context Context to be initialized.
+ * @param seed Seed of the generator of `c3e_random()`.
+ */
+void c3e_context_init(c3e_context* context, uint64_t seed);
+
+/**
+ * @brief Returns the context of the calling thread.
+ *
+ * @return The context installed with `c3e_context_use()`, or the default context of the thread.
+ */
+c3e_context* c3e_context_current(void);
+
+/**
+ * @brief Installs a context on the calling thread.
+ *
+ * The context must not be in use by another thread at the same time.
+ *
+ * @param context Context to be used, or NULL for the default context of the thread.
+ * @return Context used until then.
+ */
+c3e_context* c3e_context_use(c3e_context* context);
+
+/**
+ * @brief Returns and clears the last error of the context of the calling thread.
+ *
+ * Failed allocations of element buffers record `ENOMEM`, and failed assertions
+ * handed to a handler record `EINVAL`.
+ *
+ * @return The last error, or 0.
+ */
+int c3e_context_take_error(void);
+
+#endif /* C3E_CONTEXT_H */
\ No newline at end of file
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file csv.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Parallel reading and writing of matrices as delimited text.
+ *
+ * The reader maps the file, splits it on line boundaries into one chunk per
+ * thread, counts the rows of every chunk and then parses all the chunks at once
+ * straight into the rows of the resulting matrix. Numbers that fit the exact
+ * floating-point fast path are converted without `strtod()`.
+ *
+ * The writer formats blocks of rows in parallel, printing every element with the
+ * fewest significant digits that read back to the same value, and writes the
+ * blocks out in order.
+ */
+#ifndef C3E_CSV_H
+#define C3E_CSV_H
+
+#include <c3e/commons.h>
+
+/**
+ * @brief Reads a matrix from a delimited text file.
+ *
+ * Every non-empty line is a row, and every row must have as many fields as the
+ * first one. Fields may be surrounded by spaces or double quotes, empty fields
+ * are read as NaN, and both `\n` and `\r\n` line endings are accepted.
+ *
+ * @param path Path of the file.
+ * @param delimiter Field separator, such as `','` or `'\t'`.
+ * @param header Whether the first line holds column names and must be skipped.
+ * @param threads Number of chunks parsed in parallel, or 0 for one per thread of the pool.
+ * @return Pointer to the matrix, or NULL if the file could not be read, has no rows or is malformed.
+ */
+c3e_matrix* c3e_csv_read(const char* path, char delimiter, bool header, uint32_t threads);
+
+/**
+ * @brief Writes a matrix to a delimited text file, one row per line.
+ *
+ * @param path Path of the file.
+ * @param matrix Pointer to the matrix.
+ * @param delimiter Field separator, such as `','` or `'\t'`.
+ * @param threads Number of blocks formatted in parallel, or 0 for one per thread of the pool.
+ * @return `true` if the file was written, `false` otherwise.
+ */
+bool c3e_csv_write(const char* path, c3e_matrix* matrix, char delimiter, uint32_t threads);
+
+#endif /* C3E_CSV_H */
\ No newline at end of file
@@ -0,0 +1,239 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file disk_matrix.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Out-of-core matrices stored in files and processed in chunks of rows.
+ *
+ * A disk matrix keeps its elements in a file, row-major, after a header of
+ * `C3E_DISK_MATRIX_OFFSET` bytes. Operations never load the whole matrix: they
+ * map windows of consecutive rows, sized so that all the windows mapped at once
+ * stay within the memory budget of the matrix, and ask the kernel to read the
+ * next windows ahead while the current ones are being processed.
+ */
+#ifndef C3E_DISK_MATRIX_H
+#define C3E_DISK_MATRIX_H
+
+#include <c3e/commons.h>
+
+/**
+ * @def C3E_DISK_MATRIX_MAGIC
+ * @brief Magic number ("C3ED") opening every disk matrix file.
+ */
+#define C3E_DISK_MATRIX_MAGIC 0x44453343u
+
+/**
+ * @def C3E_DISK_MATRIX_OFFSET
+ * @brief Offset of the first element in the file, a multiple of the page size.
+ */
+#define C3E_DISK_MATRIX_OFFSET 4096
+
+/**
+ * @def C3E_DISK_MATRIX_BUDGET
+ * @brief Default memory budget of a disk matrix, in bytes.
+ */
+#define C3E_DISK_MATRIX_BUDGET ((size_t) 256 << 20)
+
+/**
+ * @struct c3e_disk_matrix
+ * @brief A matrix stored in a file.
+ */
+typedef struct {
+    int fd;             ///< Descriptor of the file.
+    uint32_t rows;      ///< Number of rows.
+    uint32_t cols;      ///< Number of columns.
+    size_t budget;      ///< Bytes that operations on this matrix may map at once.
+} c3e_disk_matrix;
+
+/**
+ * @struct c3e_disk_window
+ * @brief Consecutive rows of a disk matrix mapped into memory.
+ */
+typedef struct {
+    c3e_matrix view;    ///< The mapped rows; `data` points into the mapping.
+    void* map;          ///< Start of the mapping.
+    size_t length;      ///< Length of the mapping.
+    bool writable;      ///< Whether writes to `view` reach the file.
+} c3e_disk_window;
+
+/**
+ * @brief Creates a disk matrix filled with zeros, replacing any file at the same path.
+ *
+ * The file is sparse, so creating a large matrix does not write its elements.
+ *
+ * @param path Path of the file.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param budget Memory budget in bytes, or 0 for `C3E_DISK_MATRIX_BUDGET`.
+ * @return Pointer to the matrix, or NULL on failure.
+ */
+c3e_disk_matrix* c3e_disk_matrix_create(const char* path, uint32_t rows, uint32_t cols, size_t budget);
+
+/**
+ * @brief Opens an existing disk matrix for reading and writing.
+ *
+ * @param path Path of the file.
+ * @param budget Memory budget in bytes, or 0 for `C3E_DISK_MATRIX_BUDGET`.
+ * @return Pointer to the matrix, or NULL if the file could not be opened or is malformed.
+ */
+c3e_disk_matrix* c3e_disk_matrix_open(const char* path, size_t budget);
+
+/**
+ * @brief Closes the file of a disk matrix and frees the matrix; the file is kept.
+ *
+ * @param matrix Pointer to the matrix.
+ */
+void c3e_disk_matrix_close(c3e_disk_matrix* matrix);
+
+/**
+ * @brief Maps consecutive rows of a disk matrix.
+ *
+ * @param matrix Pointer to the matrix.
+ * @param row First row of the window.
+ * @param count Number of rows of the window.
+ * @param writable Whether the rows will be modified.
+ * @param window Window to be initialized.
+ * @return `true` if the rows were mapped, `false` otherwise.
+ */
+bool c3e_disk_matrix_map(c3e_disk_matrix* matrix, uint32_t row, uint32_t count, bool writable, c3e_disk_window* window);
+
+/**
+ * @brief Unmaps a window, starting the write-back of its modified rows.
+ *
+ * @param window Pointer to the window.
+ */
+void c3e_disk_matrix_unmap(c3e_disk_window* window);
+
+/**
+ * @brief Copies consecutive rows of a disk matrix into memory.
+ *
+ * @param matrix Pointer to the matrix.
+ * @param row First row to be read.
+ * @param count Number of rows to be read.
+ * @return Pointer to a new matrix holding the rows, or NULL on failure.
+ */
+c3e_matrix* c3e_disk_matrix_read_rows(c3e_disk_matrix* matrix, uint32_t row, uint32_t count);
+
+/**
+ * @brief Copies the rows of an in-memory matrix into a disk matrix.
+ *
+ * @param matrix Pointer to the disk matrix.
+ * @param row First row to be written.
+ * @param rows Pointer to the rows, with as many columns as the disk matrix.
+ * @return `true` if the rows were written, `false` otherwise.
+ */
+bool c3e_disk_matrix_write_rows(c3e_disk_matrix* matrix, uint32_t row, c3e_matrix* rows);
+
+/**
+ * @brief Adds two disk matrices element-wise.
+ *
+ * @param out Disk matrix receiving the result, which may be one of the operands.
+ * @param matrix Pointer to the first matrix.
+ * @param subject Pointer to the second matrix.
+ * @return `true` on success, `false` if a window could not be mapped.
+ */
+bool c3e_disk_matrix_add(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject);
+
+/**
+ * @brief Subtracts two disk matrices element-wise.
+ *
+ * @param out Disk matrix receiving the result, which may be one of the operands.
+ * @param matrix Pointer to the first matrix.
+ * @param subject Pointer to the matrix to subtract.
+ * @return `true` on success, `false` if a window could not be mapped.
+ */
+bool c3e_disk_matrix_sub(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject);
+
+/**
+ * @brief Multiplies two disk matrices element-wise.
+ *
+ * @param out Disk matrix receiving the result, which may be one of the operands.
+ * @param matrix Pointer to the first matrix.
+ * @param subject Pointer to the second matrix.
+ * @return `true` on success, `false` if a window could not be mapped.
+ */
+bool c3e_disk_matrix_dot(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject);
+
+/**
+ * @brief Adds a scalar to every element of a disk matrix.
+ *
+ * @param out Disk matrix receiving the result, which may be `matrix`.
+ * @param matrix Pointer to the matrix.
+ * @param x Scalar to be added.
+ * @return `true` on success, `false` if a window could not be mapped.
+ */
+bool c3e_disk_matrix_scalar_add(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_number x);
+
+/**
+ * @brief Multiplies every element of a disk matrix by a scalar.
+ *
+ * @param out Disk matrix receiving the result, which may be `matrix`.
+ * @param matrix Pointer to the matrix.
+ * @param x Scalar multiplier.
+ * @return `true` on success, `false` if a window could not be mapped.
+ */
+bool c3e_disk_matrix_scalar_mul(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_number x);
+
+/**
+ * @brief Sums the elements of a disk matrix.
+ *
+ * @param matrix Pointer to the matrix.
+ * @return Sum of the elements, or NaN if a window could not be mapped.
+ */
+c3e_number c3e_disk_matrix_sum(c3e_disk_matrix* matrix);
+
+/**
+ * @brief Finds the largest element of a disk matrix.
+ *
+ * @param matrix Pointer to the matrix.
+ * @return The largest element, or NaN if a window could not be mapped.
+ */
+c3e_number c3e_disk_matrix_max(c3e_disk_matrix* matrix);
+
+/**
+ * @brief Finds the smallest element of a disk matrix.
+ *
+ * @param matrix Pointer to the matrix.
+ * @return The smallest element, or NaN if a window could not be mapped.
+ */
+c3e_number c3e_disk_matrix_min(c3e_disk_matrix* matrix);
+
+/**
+ * @brief Multiplies a disk matrix by an in-memory vector.
+ *
+ * @param matrix Pointer to the matrix.
+ * @param vector Pointer to a vector with one element per column of the matrix.
+ * @return Pointer to a new vector with one element per row, or NULL on failure.
+ */
+c3e_vector* c3e_disk_matrix_gemv(c3e_disk_matrix* matrix, c3e_vector* vector);
+
+/**
+ * @brief Multiplies two disk matrices.
+ *
+ * Panels of rows of `matrix` and `out` are kept mapped while `subject` is streamed
+ * through them in chunks of rows, so `subject` is read once per panel. The budget
+ * of `out` is shared between the panels and the chunks.
+ *
+ * @param out Disk matrix receiving the product, distinct from both operands.
+ * @param matrix Pointer to the left matrix.
+ * @param subject Pointer to the right matrix.
+ * @return `true` on success, `false` if a window could not be mapped.
+ */
+bool c3e_disk_matrix_mul(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject);
+
+#endif /* C3E_DISK_MATRIX_H */
\ No newline at end of file
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file dist_matrix.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Matrices distributed in blocks over a group of processes.
+ *
+ * This file provides a matrix type partitioned in 2-D blocks over a grid of
+ * processes, together with a SUMMA matrix product. The product walks the inner
+ * dimension panel by panel; while the local blocks are multiplied with the
+ * current panels, the next ones are already being broadcast along the rows and
+ * the columns of the process grid.
+ */
+#ifndef C3E_DIST_MATRIX_H
+#define C3E_DIST_MATRIX_H
+
+#include <c3e/collective.h>
+#include <c3e/commons.h>
+
+/**
+ * @def C3E_DIST_MATRIX_PANEL
+ * @brief Default width of the panels broadcast by `c3e_dist_matrix_mul()`.
+ */
+#define C3E_DIST_MATRIX_PANEL 64
+
+/**
+ * @struct c3e_dist_matrix
+ * @brief The block of a distributed matrix held by one process.
+ *
+ * The process of rank `grid_row * grid_cols + grid_col` holds the block at that
+ * position of the grid. Block sizes along each dimension differ by at most one.
+ */
+typedef struct {
+    c3e_group* group;       ///< Group the matrix is distributed over, not owned.
+    c3e_group* row_group;   ///< Processes of the same grid row, ranked by grid column.
+    c3e_group* col_group;   ///< Processes of the same grid column, ranked by grid row.
+    uint32_t grid_rows;     ///< Number of rows of the process grid.
+    uint32_t grid_cols;     ///< Number of columns of the process grid.
+    uint32_t grid_row;      ///< Grid row of this process.
+    uint32_t grid_col;      ///< Grid column of this process.
+    uint32_t rows;          ///< Number of rows of the whole matrix.
+    uint32_t cols;          ///< Number of columns of the whole matrix.
+    uint32_t row_offset;    ///< Row of the whole matrix where the local block starts.
+    uint32_t col_offset;    ///< Column of the whole matrix where the local block starts.
+    c3e_matrix* local;      ///< The local block, initialized to zero.
+} c3e_dist_matrix;
+
+/**
+ * @brief Initializes the local block of a distributed matrix.
+ *
+ * Every process of the group must call this function with the same arguments.
+ *
+ * @param group Pointer to the group, whose size must be `grid_rows * grid_cols`.
+ * @param grid_rows Number of rows of the process grid.
+ * @param grid_cols Number of columns of the process grid.
+ * @param rows Number of rows of the whole matrix, at least `grid_rows`.
+ * @param cols Number of columns of the whole matrix, at least `grid_cols`.
+ * @return Pointer to the distributed matrix, or NULL on failure.
+ */
+c3e_dist_matrix* c3e_dist_matrix_init(c3e_group* group, uint32_t grid_rows, uint32_t grid_cols, uint32_t rows, uint32_t cols);
+
+/**
+ * @brief Frees the local block of a distributed matrix.
+ *
+ * @param matrix Pointer to the distributed matrix to be freed.
+ */
+void c3e_dist_matrix_free(c3e_dist_matrix* matrix);
+
+/**
+ * @brief Distributes a whole matrix held by one process.
+ *
+ * @param matrix Pointer to the distributed matrix receiving the blocks.
+ * @param source Matrix of the same shape on `root`; ignored elsewhere.
+ * @param root Rank holding the whole matrix.
+ * @return `true` if the block of this process was transferred, `false` otherwise.
+ */
+bool c3e_dist_matrix_scatter(c3e_dist_matrix* matrix, c3e_matrix* source, uint32_t root);
+
+/**
+ * @brief Assembles a distributed matrix on one process.
+ *
+ * @param matrix Pointer to the distributed matrix.
+ * @param target Matrix of the same shape on `root`; ignored elsewhere.
+ * @param root Rank assembling the whole matrix.
+ * @return `true` if the block of this process was transferred, `false` otherwise.
+ */
+bool c3e_dist_matrix_gather(c3e_dist_matrix* matrix, c3e_matrix* target, uint32_t root);
+
+/**
+ * @brief Computes the matrix product of two distributed matrices with SUMMA.
+ *
+ * Both operands must be distributed over the same group and process grid. Every
+ * process of the group must call this function with the same panel width.
+ *
+ * @param matrix Pointer to the left operand.
+ * @param subject Pointer to the right operand.
+ * @param panel Width of the broadcast panels, or 0 for `C3E_DIST_MATRIX_PANEL`.
+ * @return Pointer to the distributed product, or NULL on failure.
+ */
+c3e_dist_matrix* c3e_dist_matrix_mul(c3e_dist_matrix* matrix, c3e_dist_matrix* subject, uint32_t panel);
+
+#endif /* C3E_DIST_MATRIX_H */
\ No newline at end of file
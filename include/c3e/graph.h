@@ -0,0 +1,138 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file graph.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Task graphs scheduled on the thread pool by their data dependencies.
+ *
+ * Tasks are submitted in a sequential order, each declaring the blocks of data
+ * it reads and writes. The graph derives the dependencies from that order the
+ * way a sequential run would see them: a task reading a block waits for the
+ * last task writing it, and a task writing a block also waits for every task
+ * reading it since. Running the graph spawns every task on the thread pool as
+ * soon as the tasks it depends on are done, so work from later steps of an
+ * algorithm overlaps with the tail of earlier ones instead of waiting at a
+ * barrier after every step.
+ *
+ * Successors made ready by a task are spawned on the worker that ran it, the
+ * earliest submitted last so that it runs first, which keeps the critical path
+ * of factorizations moving ahead of the bulk updates.
+ */
+#ifndef C3E_GRAPH_H
+#define C3E_GRAPH_H
+
+#include <c3e/commons.h>
+#include <c3e/pool.h>
+
+/**
+ * @enum c3e_graph_mode
+ * @brief How a task accesses a block of data.
+ */
+typedef enum {
+    C3E_GRAPH_READ,         ///< The task only reads the block.
+    C3E_GRAPH_WRITE         ///< The task reads and writes the block.
+} c3e_graph_mode;
+
+/**
+ * @struct c3e_graph_access
+ * @brief Block of data accessed by a task.
+ */
+typedef struct {
+    const void* data;       ///< Address identifying the block.
+    c3e_graph_mode mode;    ///< Access of the task to the block.
+} c3e_graph_access;
+
+/**
+ * @struct c3e_graph_node
+ * @brief Task of a graph.
+ */
+typedef struct c3e_graph_node {
+    void (*run)(void*);                 ///< Function of the task.
+    void* argument;                     ///< Copy of the argument of the task.
+    struct c3e_graph* graph;            ///< Graph the task belongs to.
+    _Atomic uint32_t dependencies;      ///< Number of predecessors not done yet.
+    struct c3e_graph_node** successors; ///< Tasks depending on this one.
+    uint32_t successor_count;           ///< Number of successors.
+    uint32_t successor_capacity;        ///< Number of allocated successors.
+} c3e_graph_node;
+
+/**
+ * @struct c3e_graph_block
+ * @brief Last accesses to a block of data, in submission order.
+ */
+typedef struct {
+    const void* data;                   ///< Address of the block, or NULL for a free entry.
+    c3e_graph_node* writer;             ///< Last task writing the block, or NULL.
+    c3e_graph_node** readers;           ///< Tasks reading the block since that write.
+    uint32_t reader_count;              ///< Number of readers.
+    uint32_t reader_capacity;           ///< Number of allocated readers.
+} c3e_graph_block;
+
+/**
+ * @struct c3e_graph
+ * @brief A task graph being built or run.
+ */
+typedef struct c3e_graph {
+    c3e_graph_node** nodes;             ///< Tasks in submission order.
+    uint32_t count;                     ///< Number of tasks.
+    uint32_t capacity;                  ///< Number of allocated tasks.
+    c3e_graph_block* blocks;            ///< Open-addressing table of the blocks accessed.
+    uint32_t block_count;               ///< Number of blocks in the table.
+    uint32_t block_capacity;            ///< Size of the table, a power of two.
+    c3e_pool_group group;               ///< Tasks spawned while running.
+    bool failed;                        ///< Set when a submission ran out of memory.
+} c3e_graph;
+
+/**
+ * @brief Creates an empty task graph.
+ *
+ * @return Pointer to the graph, or NULL on failure.
+ */
+c3e_graph* c3e_graph_init(void);
+
+/**
+ * @brief Frees a task graph and the tasks it still holds.
+ *
+ * @param graph Pointer to the graph to be freed.
+ */
+void c3e_graph_free(c3e_graph* graph);
+
+/**
+ * @brief Adds a task to a graph.
+ *
+ * @param graph Pointer to the graph.
+ * @param run Function of the task.
+ * @param argument Argument of the task, copied into the graph.
+ * @param size Size in bytes of the argument.
+ * @param accesses Blocks of data accessed by the task.
+ * @param count Number of blocks accessed.
+ * @return `true` if the task was added, `false` otherwise.
+ */
+bool c3e_graph_submit(c3e_graph* graph, void (*run)(void*), const void* argument, size_t size, const c3e_graph_access* accesses, uint32_t count);
+
+/**
+ * @brief Runs every task of a graph on the thread pool and waits for them.
+ *
+ * The graph is emptied afterwards and may be filled again.
+ *
+ * @param graph Pointer to the graph.
+ * @return `true` if every task ran, `false` if a submission had failed, in which case no task ran.
+ */
+bool c3e_graph_run(c3e_graph* graph);
+
+#endif /* C3E_GRAPH_H */
\ No newline at end of file
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file loader.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Mini-batch loader gathering rows on background threads.
+ *
+ * A loader cuts one or more source matrices with the same number of rows, such
+ * as features and labels mapped in place by `c3e_archive_matrix()` or
+ * `c3e_npy_matrix()`, into batches of consecutive or shuffled rows. Worker
+ * threads gather the rows of upcoming batches into a ring of preallocated batch
+ * matrices while the caller computes on the current one, so reading from
+ * storage overlaps with compute.
+ *
+ * Batch `k` always goes to slot `k % depth`. Every slot carries a sequence
+ * number telling whether it is free for the worker filling batch `k` or ready for
+ * the caller consuming it, so workers and the caller hand slots over with atomic
+ * loads and stores only, and sleep on the sequence number when they are ahead.
+ *
+ * Batches are produced epoch after epoch without end. Every epoch visits every
+ * row once, the last batch of an epoch holding the remaining rows; shuffled
+ * epochs use a different permutation each, derived from the seed and the epoch
+ * number, so the order does not depend on the number of workers.
+ */
+#ifndef C3E_LOADER_H
+#define C3E_LOADER_H
+
+#include <c3e/commons.h>
+#include <c3e/context.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**
+ * @struct c3e_loader_slot
+ * @brief One batch of the ring.
+ */
+typedef struct {
+    c3e_matrix** matrices;          ///< Rows gathered from every source.
+    _Atomic uint32_t sequence;      ///< Batch the slot is free for, or that batch plus one once ready.
+} c3e_loader_slot;
+
+/**
+ * @struct c3e_loader
+ * @brief A mini-batch loader and its worker threads.
+ */
+typedef struct {
+    c3e_matrix** sources;           ///< Source matrices, not owned.
+    uint32_t count;                 ///< Number of sources.
+    uint32_t rows;                  ///< Rows of every source.
+    uint32_t batch_size;            ///< Rows of every full batch.
+    uint32_t batches;               ///< Batches in every epoch.
+    uint32_t depth;                 ///< Number of slots of the ring.
+    bool shuffle;                   ///< Whether rows are visited in random order.
+    uint64_t seed;                  ///< Seed of the permutations.
+    c3e_loader_slot* slots;         ///< Ring of batches.
+    pthread_t* workers;             ///< Worker threads.
+    uint32_t worker_count;          ///< Number of worker threads started.
+    _Atomic uint64_t claimed;       ///< Next batch to be claimed by a worker.
+    _Atomic bool stopping;          ///< Set when the loader is being freed.
+    uint64_t taken;                 ///< Next batch to be returned to the caller.
+    uint64_t released;              ///< Next batch to be given back by the caller.
+    c3e_context_settings settings;  ///< Settings of the creating thread, used by the workers.
+} c3e_loader;
+
+/**
+ * @brief Creates a loader and starts its workers.
+ *
+ * @param sources Source matrices, all with the same number of rows and none empty.
+ * @param count Number of sources.
+ * @param batch_size Rows of every full batch.
+ * @param depth Number of preallocated batches, at least 2.
+ * @param workers Number of worker threads, or 0 for one per online processor.
+ * @param shuffle Whether every epoch visits the rows in a different random order.
+ * @param seed Seed of the permutations.
+ * @return Pointer to the loader, or NULL on failure.
+ */
+c3e_loader* c3e_loader_init(c3e_matrix** sources, uint32_t count, uint32_t batch_size, uint32_t depth, uint32_t workers, bool shuffle, uint64_t seed);
+
+/**
+ * @brief Stops the workers and frees the loader and its batches.
+ *
+ * @param loader Pointer to the loader to be freed.
+ */
+void c3e_loader_free(c3e_loader* loader);
+
+/**
+ * @brief Waits for the next batch.
+ *
+ * The returned matrices hold the rows of the batch taken from every source, in
+ * the order of the sources. They belong to the loader and stay valid until the
+ * batch is given back with `c3e_loader_release()`; at most `depth` batches may be
+ * held at once.
+ *
+ * @param loader Pointer to the loader.
+ * @return Array of `count` matrices.
+ */
+c3e_matrix** c3e_loader_next(c3e_loader* loader);
+
+/**
+ * @brief Gives back the oldest batch returned by `c3e_loader_next()`.
+ *
+ * @param loader Pointer to the loader.
+ */
+void c3e_loader_release(c3e_loader* loader);
+
+#endif /* C3E_LOADER_H */
\ No newline at end of file
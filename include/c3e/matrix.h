@@ -60,6 +60,8 @@ c3e_matrix* c3e_matrix_init(int rows, int cols);
  * @brief Frees the memory allocated for a matrix.
  *
  * Deallocates the memory associated with the matrix structure and its data.
+ * The elements go back to `c3e_memory_free()`, which passes buffers it did not
+ * allocate, such as ones from `malloc()`, to `free()`.
  *
  * @param matrix Pointer to the matrix to be freed.
  */
@@ -374,6 +376,19 @@ c3e_number c3e_matrix_trace(c3e_matrix* matrix);
  */
 c3e_number c3e_matrix_determinant(c3e_matrix* matrix);
 
+/**
+ * @brief Checks whether a square matrix is singular.
+ *
+ * Runs an LU decomposition with partial pivoting in O(n^3) time, and reports the
+ * matrix as singular as soon as a column has no pivot larger than the tolerance
+ * used by `c3e_matrix_row_echelon()`. Unlike `c3e_matrix_determinant()`, it stays
+ * cheap for large matrices.
+ *
+ * @param matrix Pointer to the square matrix.
+ * @return `true` if the matrix is singular, `false` otherwise.
+ */
+bool c3e_matrix_singular(c3e_matrix* matrix);
+
 /**
  * @brief Computes the logarithm of the determinant of a matrix.
  *
@@ -510,6 +525,21 @@ c3e_matrix* c3e_matrix_qr_algo(c3e_matrix* matrix);
  */
 c3e_matrix* c3e_matrix_cholesky_decomp(c3e_matrix* matrix);
 
+/**
+ * @brief Performs a tiled Cholesky decomposition on the thread pool.
+ *
+ * The matrix is copied into square tiles, each stored contiguously. Factoring a
+ * diagonal tile, solving the tiles below it and updating the trailing tiles are
+ * submitted as tasks of a `c3e_graph`, so every tile operation starts as soon as
+ * the tiles it reads are final, and the next panels are factored while the
+ * updates of the previous ones are still running.
+ *
+ * @param matrix Pointer to a symmetric positive-definite matrix, of which only the lower triangle is read.
+ * @param tile Number of rows and columns of every tile.
+ * @return Pointer to the lower triangular matrix L such that L*L^T = A, or NULL if the matrix is not positive definite or on failure.
+ */
+c3e_matrix* c3e_matrix_cholesky_tiled(c3e_matrix* matrix, uint32_t tile);
+
 /**
  * @brief Determines the rank of a matrix.
  *
@@ -1267,4 +1297,28 @@ c3e_matrix* c3e_matrix_arg_min_vals(c3e_matrix* matrix, int dim);
  */
 c3e_matrix* c3e_matrix_arg_max_vals(c3e_matrix* matrix, int dim);
 
+/**
+ * @brief Gathers rows of a matrix into a new matrix.
+ *
+ * Rows are copied whole, so the same row may appear several times, as in bootstrap resampling.
+ *
+ * @param matrix Pointer to the source matrix.
+ * @param rows Indices of the rows to be gathered.
+ * @param count Number of rows to be gathered.
+ * @return Pointer to a matrix whose row `i` is row `rows[i]` of the source, or NULL on failure.
+ */
+c3e_matrix* c3e_matrix_gather_rows(c3e_matrix* matrix, const uint32_t* rows, uint32_t count);
+
+/**
+ * @brief Reorders the rows of a matrix in place.
+ *
+ * Follows the cycles of the permutation, so every row is moved once and only one row is
+ * buffered.
+ *
+ * @param matrix Pointer to the matrix.
+ * @param permutation Permutation of the row indices; row `i` becomes former row `permutation[i]`.
+ * @return `true` on success, `false` if the buffers could not be allocated.
+ */
+bool c3e_matrix_permute_rows(c3e_matrix* matrix, const uint32_t* permutation);
+
 #endif /* C3E_MATRIX_H */
\ No newline at end of file
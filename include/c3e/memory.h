@@ -0,0 +1,135 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file memory.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Accounting of element buffers, with a memory budget and spilling to disk.
+ *
+ * The elements of every matrix and vector created by the library are allocated
+ * here, and the bytes they take are accounted for. Buffers of at least
+ * `C3E_MEMORY_SPILL_SIZE` bytes are mapped anonymously; when an allocation would
+ * take the resident buffers over the budget, the idle ones that were used least
+ * recently are copied to an unlinked scratch file and their pages remapped onto
+ * it in place. Their addresses do not change: the kernel reads spilled pages back
+ * when they are touched and may drop them again under memory pressure, so jobs
+ * slow down instead of being killed.
+ *
+ * A buffer is copied out before its pages are remapped, so a store landing in
+ * between would be lost. Buffers are therefore busy when allocated and never
+ * spilled while busy; the owner marks a buffer idle with `c3e_memory_idle()` once
+ * no thread writes it anymore, and busy again with `c3e_memory_touch()` before
+ * writing it, which waits for a spill of the buffer in progress. The copy is
+ * written without holding the lock of the allocator, so other threads keep
+ * allocating while a buffer is spilled.
+ *
+ * Spilling is thus opt-in. Within the library, `c3e_svd_init()` marks its left
+ * and right bases idle while it decomposes, and `c3e_matrix_inverse()` frees
+ * its temporaries as soon as they are consumed. Every other buffer, including
+ * the elements of matrices returned to the caller, stays resident until it is
+ * passed to `c3e_memory_idle()`.
+ *
+ * Buffers allocated while the context of the calling thread has an allocator
+ * come from that allocator instead; they are neither counted against the budget
+ * nor spilled, and go back to the same allocator when freed, from any thread.
+ */
+#ifndef C3E_MEMORY_H
+#define C3E_MEMORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @def C3E_MEMORY_SPILL_SIZE
+ * @brief Size in bytes from which buffers can be spilled to disk.
+ */
+#define C3E_MEMORY_SPILL_SIZE ((size_t) 64 << 10)
+
+/**
+ * @brief Allocates a zero-initialized element buffer.
+ *
+ * @param size Size of the buffer in bytes.
+ * @return Pointer to the buffer, aligned to 64 bytes, or NULL on failure.
+ */
+void* c3e_memory_alloc(size_t size);
+
+/**
+ * @brief Frees a buffer obtained from `c3e_memory_alloc()`.
+ *
+ * The allocator keeps track of the buffers it hands out. Any other pointer,
+ * such as elements a caller allocated with `malloc()` and placed in a matrix
+ * or vector, is passed to `free()`.
+ *
+ * @param data Pointer to the buffer, or NULL.
+ */
+void c3e_memory_free(void* data);
+
+/**
+ * @brief Marks a buffer as idle, so that it may be spilled.
+ *
+ * No thread may write the buffer until it is passed to `c3e_memory_touch()`.
+ * Idle buffers are spilled in the order they were marked idle, and marking a
+ * buffer idle spills buffers right away if the budget is exceeded.
+ *
+ * @param data Pointer to a buffer obtained from `c3e_memory_alloc()`.
+ */
+void c3e_memory_idle(void* data);
+
+/**
+ * @brief Marks a buffer as busy again, so that it is not spilled.
+ *
+ * Waits for a spill of the buffer in progress. A buffer already spilled stays
+ * in the scratch file, where writes to it are kept.
+ *
+ * @param data Pointer to a buffer obtained from `c3e_memory_alloc()`.
+ */
+void c3e_memory_touch(void* data);
+
+/**
+ * @brief Sets the number of bytes that resident buffers may take.
+ *
+ * Lowering the budget spills buffers right away until it is met or nothing is
+ * left to spill.
+ *
+ * @param budget Budget in bytes, or 0 for no limit.
+ */
+void c3e_memory_set_budget(size_t budget);
+
+/**
+ * @brief Sets the directory of the scratch file, `TMPDIR` or `/tmp` by default.
+ *
+ * Only takes effect before the first buffer is spilled.
+ *
+ * @param directory Path of the directory.
+ */
+void c3e_memory_set_scratch(const char* directory);
+
+/**
+ * @brief Gets the number of bytes taken by buffers kept in memory.
+ *
+ * @return Resident bytes.
+ */
+size_t c3e_memory_resident(void);
+
+/**
+ * @brief Gets the number of bytes of buffers spilled to the scratch file.
+ *
+ * @return Spilled bytes.
+ */
+size_t c3e_memory_spilled(void);
+
+#endif /* C3E_MEMORY_H */
\ No newline at end of file
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file montecarlo.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Parallel driver for Monte Carlo integration and simulation.
+ *
+ * The paths of a simulation are cut into batches of fixed size. Workers, run as
+ * tasks of the thread pool, claim batches one after the other and run a user
+ * kernel on each, which draws from a generator set to a stream of its own, given
+ * by the batch number, and writes one row of outputs per path. Every worker owns
+ * a scratch vector and an output buffer allocated once before the run, so the
+ * kernel never allocates.
+ *
+ * Workers reduce the outputs of each batch to a mean and a sum of squared
+ * deviations per output. The batches are then merged pairwise with Chan's
+ * formulas, level by level in parallel, always in the same order. Since neither
+ * the streams nor the order of the reduction depend on which worker ran which
+ * batch, a run gives bit-identical results for any number of threads.
+ */
+#ifndef C3E_MONTECARLO_H
+#define C3E_MONTECARLO_H
+
+#include <c3e/commons.h>
+#include <c3e/random.h>
+
+/**
+ * @typedef c3e_montecarlo_kernel
+ * @brief Function simulating one batch of paths.
+ *
+ * @param rng Generator set to the stream of the batch.
+ * @param first Index of the first path of the batch.
+ * @param paths Number of paths of the batch.
+ * @param scratch Scratch vector of the worker, or NULL if none was requested.
+ * @param values Array of `paths` rows of `outputs` numbers to be filled, one row per path.
+ * @param context Pointer given to `c3e_montecarlo_run()`.
+ */
+typedef void (*c3e_montecarlo_kernel)(c3e_rng* rng, uint64_t first, uint32_t paths, c3e_vector* scratch, c3e_number* values, void* context);
+
+/**
+ * @struct c3e_montecarlo
+ * @brief Estimates of a Monte Carlo run.
+ */
+typedef struct {
+    uint64_t paths;             ///< Number of paths simulated.
+    uint32_t outputs;           ///< Number of outputs of every path.
+    c3e_vector* mean;           ///< Mean of every output.
+    c3e_vector* variance;       ///< Sample variance of every output.
+    c3e_vector* error;          ///< Standard error of every mean.
+} c3e_montecarlo;
+
+/**
+ * @brief Runs a Monte Carlo simulation on a pool of workers.
+ *
+ * @param kernel Function simulating a batch of paths.
+ * @param context Argument of the kernel.
+ * @param paths Number of paths to be simulated, at least 2.
+ * @param outputs Number of outputs of every path.
+ * @param batch_size Number of paths of every full batch.
+ * @param scratch_size Size of the scratch vector of every worker, or 0 for none.
+ * @param seed Seed of the streams of the batches.
+ * @param threads Number of workers, or 0 for one per thread of the pool.
+ * @return Pointer to the estimates, or NULL on failure.
+ */
+c3e_montecarlo* c3e_montecarlo_run(c3e_montecarlo_kernel kernel, void* context, uint64_t paths, uint32_t outputs, uint32_t batch_size, size_t scratch_size, uint64_t seed, uint32_t threads);
+
+/**
+ * @brief Frees the estimates of a Monte Carlo run.
+ *
+ * @param result Pointer to the estimates to be freed.
+ */
+void c3e_montecarlo_free(c3e_montecarlo* result);
+
+#endif /* C3E_MONTECARLO_H */
\ No newline at end of file
@@ -27,6 +27,7 @@
 #ifndef C3E_NET_H
 #define C3E_NET_H
 
+#include <c3e/codec.h>
 #include <c3e/commons.h>
 
 #include <arpa/inet.h>
@@ -40,14 +41,107 @@
  * - `port`: The port number on which the server is listening.
  * - `sockfd`: The file descriptor for the socket.
  * - `server_addr`: The server's address, including the hostname and port number.
+ * - `codec`: The payload codec negotiated with the peer, `C3E_CODEC_NONE` by default.
  */
 typedef struct {
     char* hostname; ///< The hostname or IP address of the server.
     int port;       ///< The port number on which the server is listening.
     int sockfd;     ///< The file descriptor for the socket.
     struct sockaddr_in server_addr; ///< The server's address structure.
+    c3e_codec codec;    ///< The payload codec negotiated with the peer.
 } c3e_socket;
 
+/**
+ * @def C3E_MESSAGE_MAGIC
+ * @brief Magic number ("C3EM") opening every typed matrix or vector message.
+ */
+#define C3E_MESSAGE_MAGIC 0x4D453343u
+
+/**
+ * @struct c3e_message_header
+ * @brief Header preceding the payload of a typed matrix or vector message.
+ *
+ * The header declares the element type used on the wire, so a receiver always
+ * knows whether the sender reduced the precision of the payload. Vectors are
+ * sent as a single column.
+ */
+typedef struct {
+    uint32_t magic;     ///< Always `C3E_MESSAGE_MAGIC`.
+    uint8_t dtype;      ///< Element type of the payload, a `c3e_dtype`.
+    uint8_t codec;      ///< Codec of the payload, a `c3e_codec`.
+    uint16_t reserved;  ///< Reserved, always zero.
+    uint32_t rows;      ///< Number of rows of the matrix, or size of the vector.
+    uint32_t cols;      ///< Number of columns of the matrix, 1 for vectors.
+} c3e_message_header;
+
+/**
+ * @def C3E_STREAM_MAGIC
+ * @brief Magic number ("C3ES") opening every chunked matrix stream.
+ */
+#define C3E_STREAM_MAGIC 0x53453343u
+
+/**
+ * @def C3E_STREAM_VERSION
+ * @brief Version of the chunked matrix stream framing.
+ */
+#define C3E_STREAM_VERSION 1
+
+/**
+ * @struct c3e_stream_header
+ * @brief Header sent once at the beginning of a chunked matrix stream.
+ *
+ * Shapes are 64-bit so that streams are not limited by the 32-bit
+ * `rows` and `cols` fields of `c3e_matrix` nor by their product.
+ */
+typedef struct {
+    uint32_t magic;         ///< Always `C3E_STREAM_MAGIC`.
+    uint16_t version;       ///< Framing version, `C3E_STREAM_VERSION`.
+    uint8_t dtype;          ///< Element encoding on the wire.
+    uint8_t codec;          ///< Payload codec on the wire.
+    uint64_t rows;          ///< Total number of rows in the stream.
+    uint64_t cols;          ///< Number of columns of every row.
+    uint32_t chunk_rows;    ///< Maximum number of rows in one chunk.
+    uint32_t reserved;      ///< Reserved, always zero.
+} c3e_stream_header;
+
+/**
+ * @struct c3e_stream_chunk
+ * @brief Frame header preceding the payload of every chunk in a stream.
+ */
+typedef struct {
+    uint64_t row_offset;    ///< Index of the first row carried by the chunk.
+    uint32_t row_count;     ///< Number of rows carried by the chunk.
+    uint32_t payload_size;  ///< Size in bytes of the payload following this frame.
+} c3e_stream_chunk;
+
+/**
+ * @struct c3e_matrix_stream
+ * @brief State of one side of a chunked matrix stream.
+ *
+ * The same structure is used by the sending side (opened with
+ * `c3e_matrix_stream_open()`) and by the receiving side (opened with
+ * `c3e_matrix_stream_accept()`). Flow control is driven by the receiver,
+ * which grants the sender a number of chunk credits; the sender blocks
+ * once its credits are exhausted until the receiver has consumed
+ * enough chunks to grant more.
+ */
+typedef struct {
+    c3e_socket* socket;     ///< Socket the stream is transferred on.
+    uint64_t rows;          ///< Total number of rows in the stream.
+    uint64_t cols;          ///< Number of columns of every row.
+    uint32_t chunk_rows;    ///< Maximum number of rows in one chunk.
+    uint32_t window;        ///< Number of chunks the receiver may buffer.
+    uint64_t position;      ///< Number of rows transferred so far.
+    uint64_t chunks;        ///< Total number of chunks in the stream.
+    uint64_t granted;       ///< Number of chunk credits granted so far (receiver).
+    uint32_t credits;       ///< Available credits (sender) or credits pending return (receiver).
+    c3e_dtype dtype;        ///< Element type of the chunk payloads.
+    c3e_codec codec;        ///< Codec applied to the chunk payloads.
+    c3e_matrix* block;      ///< Reusable row block holding the last received chunk (receiver).
+    void* buffer;           ///< Scratch buffer holding encoded chunk payloads.
+    size_t buffer_size;     ///< Size in bytes of the scratch buffer.
+} c3e_matrix_stream;
+
 /**
  * @brief Initializes a socket with the specified hostname and port.
  *
@@ -60,6 +154,39 @@ typedef struct {
  */
 void c3e_socket_init(c3e_socket* socket, const char* hostname, int port);
 
+/**
+ * @brief Connects a socket to the specified hostname and port.
+ *
+ * Unlike `c3e_socket_init()`, this function reports failures instead of asserting,
+ * so callers can retry while the peer is still starting up.
+ *
+ * @param socket A pointer to a `c3e_socket` structure to be initialized.
+ * @param hostname The hostname or IP address of the server.
+ * @param port The port number on which the server is listening.
+ * @return `true` if the connection was established, `false` otherwise.
+ */
+bool c3e_socket_connect(c3e_socket* socket, const char* hostname, int port);
+
+/**
+ * @brief Creates a listening socket bound to the specified hostname and port.
+ *
+ * @param socket A pointer to a `c3e_socket` structure to be initialized.
+ * @param hostname The IP address to bind to.
+ * @param port The port number to listen on.
+ * @param backlog The maximum number of pending connections.
+ * @return `true` if the socket is listening, `false` otherwise.
+ */
+bool c3e_socket_listen(c3e_socket* socket, const char* hostname, int port, int backlog);
+
+/**
+ * @brief Accepts a connection on a listening socket.
+ *
+ * @param server A pointer to the listening `c3e_socket`.
+ * @param client A pointer to a `c3e_socket` structure receiving the accepted connection.
+ * @return `true` if a connection was accepted, `false` otherwise.
+ */
+bool c3e_socket_accept(c3e_socket* server, c3e_socket* client);
+
 /**
  * @brief Closes the network socket.
  *
@@ -69,10 +196,26 @@ void c3e_socket_init(c3e_socket* socket, const char* hostname, int port);
  */
 void c3e_socket_close(c3e_socket* socket);
 
+/**
+ * @brief Negotiates the payload codec used on the connection.
+ *
+ * Both peers must call this function. Each peer proposes a codec and both adopt the
+ * lowest of the two proposals, so a peer that does not want compression keeps the
+ * connection uncompressed. Once negotiated, matrices, vectors, tensors and streams
+ * sent over the socket have their element payloads encoded with the codec, one
+ * block of `C3E_CODEC_BLOCK` elements at a time, each preceded by its size.
+ *
+ * @param socket A pointer to the `c3e_socket` structure of the connection.
+ * @param codec The codec proposed by this peer.
+ * @return `true` if the negotiation succeeded, `false` otherwise.
+ */
+bool c3e_socket_negotiate_codec(c3e_socket* socket, c3e_codec codec);
+
 /**
  * @brief Sends data through the socket.
  *
  * This function transmits data over the network through the specified socket.
+ * A peer that went away makes the call fail instead of raising `SIGPIPE`.
  *
  * @param socket A pointer to the `c3e_socket` structure used for sending data.
  * @param data A pointer to the data to be sent.
@@ -138,6 +281,89 @@ void c3e_socket_send_vector(c3e_socket* socket, c3e_vector* vector);
  */
 void c3e_socket_send_number(c3e_socket* socket, c3e_number number);
 
+/**
+ * @brief Sends a matrix object through the socket with the specified element type.
+ *
+ * The message header declares `dtype`, and the elements are down-converted in
+ * bounded batches while being sent. Any type other than `C3E_DTYPE_NATIVE` opts
+ * into the loss of precision; such payloads are not compressed by the negotiated
+ * codec. The message is read with `c3e_socket_typed_matrix_read()`.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for sending the matrix.
+ * @param matrix A pointer to the `c3e_matrix` object to be sent.
+ * @param dtype The element type used on the wire.
+ * @return `true` if the matrix was sent successfully, `false` otherwise.
+ */
+bool c3e_socket_send_matrix_typed(c3e_socket* socket, c3e_matrix* matrix, c3e_dtype dtype);
+
+/**
+ * @brief Sends a vector object through the socket with the specified element type.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for sending the vector.
+ * @param vector A pointer to the `c3e_vector` object to be sent.
+ * @param dtype The element type used on the wire.
+ * @return `true` if the vector was sent successfully, `false` otherwise.
+ * @see c3e_socket_send_matrix_typed
+ */
+bool c3e_socket_send_vector_typed(c3e_socket* socket, c3e_vector* vector, c3e_dtype dtype);
+
+/**
+ * @brief Sends a tensor object through the socket with the specified element type.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for sending the tensor.
+ * @param tensor A pointer to the `c3e_tensor` object to be sent.
+ * @param dtype The element type used on the wire for its matrices and data.
+ * @return `true` if the tensor was sent successfully, `false` otherwise.
+ * @see c3e_socket_send_matrix_typed
+ */
+bool c3e_socket_send_tensor_typed(c3e_socket* socket, c3e_tensor* tensor, c3e_dtype dtype);
+
+/**
+ * @brief Sends a matrix stored in a file without copying it through user space.
+ *
+ * The elements must be laid out row-major in the file, starting at `offset`, as
+ * values of the type `dtype`. The message header is queued with `MSG_MORE` and the
+ * payload is handed to `sendfile()`, so that both leave in the same segments and
+ * the elements go straight from the page cache to the socket. The message is read
+ * with `c3e_socket_typed_matrix_read()`, and is never compressed.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for sending the matrix.
+ * @param fd File descriptor of the file holding the elements.
+ * @param offset Position of the first element in the file, in bytes.
+ * @param rows Number of rows of the stored matrix.
+ * @param cols Number of columns of the stored matrix.
+ * @param dtype Element type of the stored values.
+ * @return `true` if the matrix was sent successfully, `false` otherwise.
+ */
+bool c3e_socket_send_file_matrix(c3e_socket* socket, int fd, uint64_t offset, uint32_t rows, uint32_t cols, c3e_dtype dtype);
+
+/**
+ * @brief Receives a matrix sent with `c3e_socket_send_matrix_typed()`.
+ *
+ * The elements are up-converted to `c3e_number` according to the element type
+ * declared in the message header.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for receiving the matrix.
+ * @return A pointer to the received `c3e_matrix` object. NULL if the operation fails.
+ */
+c3e_matrix* c3e_socket_typed_matrix_read(c3e_socket* socket);
+
+/**
+ * @brief Receives a vector sent with `c3e_socket_send_vector_typed()`.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for receiving the vector.
+ * @return A pointer to the received `c3e_vector` object. NULL if the operation fails.
+ */
+c3e_vector* c3e_socket_typed_vector_read(c3e_socket* socket);
+
+/**
+ * @brief Receives a tensor sent with `c3e_socket_send_tensor_typed()`.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for receiving the tensor.
+ * @return A pointer to the received `c3e_tensor` object. NULL if the operation fails.
+ */
+c3e_tensor* c3e_socket_typed_tensor_read(c3e_socket* socket);
+
 /**
  * @brief Receives and deserializes a tensor object from the socket.
  *
@@ -179,4 +405,99 @@ c3e_vector* c3e_socket_vector_read(c3e_socket* socket);
  */
 c3e_number c3e_socket_number_read(c3e_socket* socket);
 
+/**
+ * @brief Opens the sending side of a chunked matrix stream.
+ *
+ * Sends the stream header announcing a matrix of `rows` x `cols` elements
+ * split into chunks of at most `chunk_rows` rows, then waits for the
+ * receiver's initial credit grant. Chunks are converted to `dtype` before
+ * being sent; any type other than `C3E_DTYPE_NATIVE` opts into the loss of
+ * precision and disables the negotiated codec for this stream.
+ *
+ * @param stream A pointer to the `c3e_matrix_stream` structure to be initialized.
+ * @param socket A pointer to the `c3e_socket` structure used for sending.
+ * @param rows The total number of rows to be streamed.
+ * @param cols The number of columns of every row.
+ * @param chunk_rows The maximum number of rows sent in one chunk.
+ * @param dtype The element type used on the wire.
+ * @return `true` if the stream was opened successfully, `false` otherwise.
+ */
+bool c3e_matrix_stream_open(c3e_matrix_stream* stream, c3e_socket* socket, uint64_t rows, uint64_t cols, uint32_t chunk_rows, c3e_dtype dtype);
+
+/**
+ * @brief Writes consecutive rows to an open matrix stream.
+ *
+ * The rows are framed into chunks of `chunk_rows` rows each. When the sender
+ * runs out of credits it blocks until the receiver grants more. `count` must
+ * be a multiple of `chunk_rows`, unless the call writes the final rows of the
+ * stream.
+ *
+ * @param stream A pointer to the sending `c3e_matrix_stream`.
+ * @param data Pointer to `count` rows of `cols` elements in row-major order.
+ * @param count The number of rows to be written.
+ * @return `true` if all the rows were sent, `false` otherwise.
+ */
+bool c3e_matrix_stream_write(c3e_matrix_stream* stream, const c3e_number* data, uint64_t count);
+
+/**
+ * @brief Opens the receiving side of a chunked matrix stream.
+ *
+ * Reads the stream header, allocates a single reusable row block and grants
+ * the sender `window` chunk credits. Headers whose columns or chunk rows exceed
+ * `INT_MAX`, or whose chunks would not fit the 32-bit payload size, are
+ * rejected before anything is allocated. The stream must be closed even if it
+ * was not accepted.
+ *
+ * @param stream A pointer to the `c3e_matrix_stream` structure to be initialized.
+ * @param socket A pointer to the `c3e_socket` structure used for receiving.
+ * @param window The number of chunks the sender may have in flight.
+ * @return `true` if the stream was accepted successfully, `false` otherwise.
+ */
+bool c3e_matrix_stream_accept(c3e_matrix_stream* stream, c3e_socket* socket, uint32_t window);
+
+/**
+ * @brief Receives the next row block of a matrix stream.
+ *
+ * Returning a block hands the credit of the previously returned block back to
+ * the sender. The returned matrix is owned by the stream and is overwritten by
+ * the next call, so consumers should process it (e.g. accumulate a running
+ * matrix-vector product) before asking for the next one.
+ *
+ * @param stream A pointer to the receiving `c3e_matrix_stream`.
+ * @param row_offset Optional pointer receiving the index of the first row of the block.
+ * @return A pointer to the row block, or NULL when the stream ended or failed.
+ */
+c3e_matrix* c3e_matrix_stream_next(c3e_matrix_stream* stream, uint64_t* row_offset);
+
+/**
+ * @brief Releases the resources held by a matrix stream.
+ *
+ * Both the sending and the receiving side of a stream must be closed.
+ *
+ * @param stream A pointer to the `c3e_matrix_stream` to be closed.
+ */
+void c3e_matrix_stream_close(c3e_matrix_stream* stream);
+
+/**
+ * @brief Sends a matrix object through the socket as a chunked stream.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for sending the matrix.
+ * @param matrix A pointer to the `c3e_matrix` object to be sent.
+ * @param chunk_rows The maximum number of rows sent in one chunk.
+ * @return `true` if the matrix was sent successfully, `false` otherwise.
+ */
+bool c3e_socket_send_matrix_stream(c3e_socket* socket, c3e_matrix* matrix, uint32_t chunk_rows);
+
+/**
+ * @brief Receives a whole matrix sent as a chunked stream.
+ *
+ * This is a convenience over `c3e_matrix_stream_next()` for matrices that fit
+ * in memory and in the shape limits of `c3e_matrix`.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for receiving the matrix.
+ * @param window The number of chunks the sender may have in flight.
+ * @return A pointer to the received `c3e_matrix` object. NULL if the operation fails.
+ */
+c3e_matrix* c3e_socket_matrix_stream_read(c3e_socket* socket, uint32_t window);
+
 #endif /* C3E_NET_H */
\ No newline at end of file
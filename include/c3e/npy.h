@@ -0,0 +1,206 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file npy.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Reading and writing NumPy `.npy` and `.npz` files.
+ *
+ * This file reads `.npy` files and the stored (uncompressed) members of `.npz`
+ * archives holding float32 or float64 arrays of up to two dimensions, in C or
+ * Fortran order and in either byte order. Files are mapped into memory, and an
+ * array that is C-ordered, in the byte order of the host and of the same type as
+ * `c3e_number` is returned without copying. Other arrays are converted once into
+ * buffers owned by the file.
+ *
+ * The writers produce version 1.0 `.npy` data in the byte order of the host. In
+ * `.npz` archives, every member is padded so that its elements start on a 64-byte
+ * boundary and can be mapped when read back.
+ */
+#ifndef C3E_NPY_H
+#define C3E_NPY_H
+
+#include <c3e/codec.h>
+#include <c3e/commons.h>
+
+/**
+ * @def C3E_NPY_NAME_SIZE
+ * @brief Size of an array name, including the terminating null character.
+ */
+#define C3E_NPY_NAME_SIZE 64
+
+/**
+ * @struct c3e_npy_array
+ * @brief Description of an array found in a `.npy` or `.npz` file.
+ */
+typedef struct {
+    char name[C3E_NPY_NAME_SIZE];   ///< Member name without `.npy`, empty for a `.npy` file.
+    c3e_dtype dtype;                ///< `C3E_DTYPE_FLOAT32` or `C3E_DTYPE_FLOAT64`.
+    bool big_endian;                ///< Whether the elements are big-endian.
+    bool fortran_order;             ///< Whether the elements are stored column-major.
+    uint32_t dimensions;            ///< Number of dimensions, from 0 to 2.
+    uint32_t rows;                  ///< First dimension, or 1 for a scalar.
+    uint32_t cols;                  ///< Second dimension, or 1 for fewer than two dimensions.
+    uint64_t offset;                ///< Offset of the elements in the file.
+} c3e_npy_array;
+
+/**
+ * @struct c3e_npy_file
+ * @brief A `.npy` or `.npz` file opened for reading.
+ */
+typedef struct {
+    int fd;                         ///< Descriptor of the file.
+    uint8_t* map;                   ///< Copy-on-write mapping of the whole file.
+    size_t size;                    ///< Size of the file.
+    c3e_npy_array* arrays;          ///< Every readable array.
+    uint32_t count;                 ///< Number of arrays.
+    c3e_matrix** matrices;          ///< Matrix obtained from every array, NULL until requested.
+    c3e_vector** vectors;           ///< Vector obtained from every array, NULL until requested.
+    c3e_number** buffers;           ///< Converted elements of arrays that could not be mapped.
+} c3e_npy_file;
+
+/**
+ * @struct c3e_npz_member
+ * @brief A member written to a `.npz` archive.
+ */
+typedef struct {
+    char name[C3E_NPY_NAME_SIZE + 4];   ///< File name of the member, with `.npy`.
+    uint32_t crc;                       ///< CRC-32 of the member.
+    uint64_t size;                      ///< Size of the member in bytes.
+    uint64_t offset;                    ///< Offset of the local header of the member.
+} c3e_npz_member;
+
+/**
+ * @struct c3e_npz_writer
+ * @brief A `.npz` archive being written.
+ */
+typedef struct {
+    int fd;                         ///< Descriptor of the file being written.
+    uint64_t position;              ///< End of the last member.
+    c3e_npz_member* members;        ///< Members written so far.
+    uint32_t count;                 ///< Number of members.
+    uint32_t capacity;              ///< Number of allocated members.
+} c3e_npz_writer;
+
+/**
+ * @brief Writes a matrix to a `.npy` file.
+ *
+ * @param path Path of the file.
+ * @param matrix Pointer to the matrix.
+ * @param dtype `C3E_DTYPE_FLOAT32`, `C3E_DTYPE_FLOAT64` or `C3E_DTYPE_NATIVE`.
+ * @return `true` if the file was written, `false` otherwise.
+ */
+bool c3e_npy_save_matrix(const char* path, c3e_matrix* matrix, c3e_dtype dtype);
+
+/**
+ * @brief Writes a vector to a `.npy` file as a one-dimensional array.
+ *
+ * @param path Path of the file.
+ * @param vector Pointer to the vector.
+ * @param dtype `C3E_DTYPE_FLOAT32`, `C3E_DTYPE_FLOAT64` or `C3E_DTYPE_NATIVE`.
+ * @return `true` if the file was written, `false` otherwise.
+ */
+bool c3e_npy_save_vector(const char* path, c3e_vector* vector, c3e_dtype dtype);
+
+/**
+ * @brief Creates a `.npz` archive, replacing any file at the same path.
+ *
+ * @param path Path of the file.
+ * @return Pointer to the writer, or NULL on failure.
+ */
+c3e_npz_writer* c3e_npz_create(const char* path);
+
+/**
+ * @brief Appends a matrix to a `.npz` archive.
+ *
+ * @param writer Pointer to the writer.
+ * @param name Unique name of the array, without `.npy`.
+ * @param matrix Pointer to the matrix.
+ * @param dtype `C3E_DTYPE_FLOAT32`, `C3E_DTYPE_FLOAT64` or `C3E_DTYPE_NATIVE`.
+ * @return `true` if the matrix was written, `false` otherwise.
+ */
+bool c3e_npz_put_matrix(c3e_npz_writer* writer, const char* name, c3e_matrix* matrix, c3e_dtype dtype);
+
+/**
+ * @brief Appends a vector to a `.npz` archive as a one-dimensional array.
+ *
+ * @param writer Pointer to the writer.
+ * @param name Unique name of the array, without `.npy`.
+ * @param vector Pointer to the vector.
+ * @param dtype `C3E_DTYPE_FLOAT32`, `C3E_DTYPE_FLOAT64` or `C3E_DTYPE_NATIVE`.
+ * @return `true` if the vector was written, `false` otherwise.
+ */
+bool c3e_npz_put_vector(c3e_npz_writer* writer, const char* name, c3e_vector* vector, c3e_dtype dtype);
+
+/**
+ * @brief Writes the central directory, closes the file and frees the writer.
+ *
+ * @param writer Pointer to the writer.
+ * @return `true` if the archive is complete, `false` otherwise.
+ */
+bool c3e_npz_finish(c3e_npz_writer* writer);
+
+/**
+ * @brief Opens a `.npy` file or a `.npz` archive by mapping it into memory.
+ *
+ * Members of a `.npz` archive that are compressed, or that hold anything other
+ * than a float32 or float64 array of up to two dimensions, are skipped.
+ *
+ * @param path Path of the file.
+ * @return Pointer to the file, or NULL if it could not be mapped or is malformed.
+ */
+c3e_npy_file* c3e_npy_open(const char* path);
+
+/**
+ * @brief Unmaps a file and frees every array obtained from it.
+ *
+ * @param file Pointer to the file.
+ */
+void c3e_npy_close(c3e_npy_file* file);
+
+/**
+ * @brief Looks up an array by name.
+ *
+ * @param file Pointer to the file.
+ * @param name Name of the array, or NULL for the first one.
+ * @return Pointer to the array, or NULL if there is none with this name.
+ */
+c3e_npy_array* c3e_npy_find(c3e_npy_file* file, const char* name);
+
+/**
+ * @brief Gets an array as a matrix.
+ *
+ * One-dimensional arrays become a single column. The matrix belongs to the file:
+ * it must not be freed nor resized, and is valid until `c3e_npy_close()`. Writes
+ * to it stay private to the process.
+ *
+ * @param file Pointer to the file.
+ * @param name Name of the array, or NULL for the first one.
+ * @return Pointer to the matrix, or NULL if the array is missing.
+ */
+c3e_matrix* c3e_npy_matrix(c3e_npy_file* file, const char* name);
+
+/**
+ * @brief Gets an array with a single row or column as a vector, with the same ownership as `c3e_npy_matrix()`.
+ *
+ * @param file Pointer to the file.
+ * @param name Name of the array, or NULL for the first one.
+ * @return Pointer to the vector, or NULL if the array is missing or not a vector.
+ */
+c3e_vector* c3e_npy_vector(c3e_npy_file* file, const char* name);
+
+#endif /* C3E_NPY_H */
\ No newline at end of file
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file pool.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Work-stealing thread pool shared by all parallel kernels of C3E.
+ *
+ * Every parallel kernel of the library runs on one process-wide pool, so nested
+ * and concurrent kernels never start more threads than the pool holds. The pool
+ * is started with one worker per online processor on first use, or explicitly
+ * with `c3e_pool_start()` to choose the number of workers and pin them to CPUs.
+ *
+ * A parallel loop cuts its range into chunks and splits the chunks in halves
+ * recursively. The worker splitting a range pushes the upper half onto its own
+ * deque and goes on with the lower half, while idle workers steal the oldest,
+ * largest halves from the other end of the deque. A worker waiting for a stolen
+ * half runs other tasks in the meantime, so a loop nested in a task of another
+ * loop is spread over the whole pool instead of blocking a worker. Callers
+ * outside the pool hand the whole range to the workers and sleep until it is
+ * done.
+ *
+ * Applications having a thread pool of their own may install it as executor
+ * with `c3e_pool_set_executor()`. Loops then submit helper tasks to the executor
+ * and claim chunks together with the calling thread, which runs every chunk no
+ * helper has claimed, so the loop finishes even if the executor never runs the
+ * helpers.
+ *
+ * Threads blocking on I/O, such as the workers of `c3e_loader` or the threads of
+ * `c3e_checkpoint` and `c3e_subscriber`, stay outside the pool.
+ */
+#ifndef C3E_POOL_H
+#define C3E_POOL_H
+
+#include <c3e/commons.h>
+
+#include <stdatomic.h>
+
+/**
+ * @typedef c3e_parallel_body
+ * @brief Function processing a range of a parallel loop.
+ *
+ * @param first First index of the range.
+ * @param last Index past the end of the range.
+ * @param context Pointer given to the loop.
+ */
+typedef void (*c3e_parallel_body)(size_t first, size_t last, void* context);
+
+/**
+ * @typedef c3e_parallel_reduce_body
+ * @brief Function computing the partial result of a range of a parallel reduction.
+ *
+ * @param first First index of the range.
+ * @param last Index past the end of the range.
+ * @param partial Uninitialized storage receiving the partial result of the range.
+ * @param context Pointer given to the reduction.
+ */
+typedef void (*c3e_parallel_reduce_body)(size_t first, size_t last, void* partial, void* context);
+
+/**
+ * @typedef c3e_parallel_join
+ * @brief Function merging the partial result of a range into that of the range just before it.
+ *
+ * @param partial Partial result of the lower range, updated in place.
+ * @param other Partial result of the upper range.
+ * @param context Pointer given to the reduction.
+ */
+typedef void (*c3e_parallel_join)(void* partial, const void* other, void* context);
+
+/**
+ * @struct c3e_pool_group
+ * @brief Set of tasks spawned on the pool that can be waited for together.
+ */
+typedef struct {
+    _Atomic uint32_t pending;   ///< Number of tasks spawned and not finished yet.
+} c3e_pool_group;
+
+/**
+ * @struct c3e_executor
+ * @brief Thread pool of the application, running the parallel loops of C3E in place of its own pool.
+ */
+typedef struct {
+    void (*submit)(void (*task)(void*), void* argument, void* executor);    ///< Schedules `task(argument)` on some thread.
+    uint32_t concurrency;                                                   ///< Number of threads of the executor.
+    void* executor;                                                         ///< Last argument of `submit`.
+} c3e_executor;
+
+/**
+ * @brief Starts the pool, replacing the running one.
+ *
+ * Must not be called while parallel work is in progress.
+ *
+ * @param workers Number of workers, or 0 for one per online processor.
+ * @param cpus CPU each worker is pinned to, or NULL to let the system place them.
+ * @return `true` if all the workers were started, `false` otherwise.
+ */
+bool c3e_pool_start(uint32_t workers, const uint32_t* cpus);
+
+/**
+ * @brief Stops the workers of the pool.
+ *
+ * The pool starts again on the next parallel loop. Must not be called while
+ * parallel work is in progress.
+ */
+void c3e_pool_stop(void);
+
+/**
+ * @brief Installs the executor of the application.
+ *
+ * The executor is kept in the context of the calling thread, see `context.h`,
+ * and applies to the loops and tasks that thread starts, including the loops
+ * nested in them.
+ *
+ * @param executor Executor to be copied, or NULL to go back to the pool of C3E.
+ */
+void c3e_pool_set_executor(const c3e_executor* executor);
+
+/**
+ * @brief Returns the number of threads parallel loops run on.
+ *
+ * @return Number of workers of the pool, or concurrency of the installed executor.
+ */
+uint32_t c3e_pool_size(void);
+
+/**
+ * @brief Runs a loop over a range in parallel.
+ *
+ * @param first First index of the range.
+ * @param last Index past the end of the range.
+ * @param grain Number of indices of every chunk, or 0 to cut the range into a few chunks per thread.
+ * @param body Function processing every chunk.
+ * @param context Argument of the body.
+ */
+void c3e_parallel_for(size_t first, size_t last, size_t grain, c3e_parallel_body body, void* context);
+
+/**
+ * @brief Reduces a range in parallel.
+ *
+ * The partial results of the chunks are merged along a fixed binary tree, so
+ * for a given grain the result does not depend on the scheduling, even when the
+ * merge is not associative in floating point.
+ *
+ * @param first First index of the range.
+ * @param last Index past the end of the range, greater than `first`.
+ * @param grain Number of indices of every chunk, or 0 to cut the range into a few chunks per thread.
+ * @param result Storage receiving the result.
+ * @param size Size in bytes of a result.
+ * @param body Function computing the partial result of every chunk.
+ * @param join Function merging two partial results.
+ * @param context Argument of the body and of the join.
+ */
+void c3e_parallel_reduce(size_t first, size_t last, size_t grain, void* result, size_t size, c3e_parallel_reduce_body body, c3e_parallel_join join, void* context);
+
+/**
+ * @brief Runs a function on every element of an array of task arguments in parallel.
+ *
+ * @param task Function to be run.
+ * @param tasks Array of task arguments.
+ * @param size Size in bytes of an element of the array.
+ * @param count Number of elements.
+ */
+void c3e_parallel_invoke(void (*task)(void*), void* tasks, size_t size, uint32_t count);
+
+/**
+ * @brief Initializes an empty task group.
+ *
+ * @param group Pointer to the group.
+ */
+void c3e_pool_group_init(c3e_pool_group* group);
+
+/**
+ * @brief Spawns a task on the pool.
+ *
+ * A task spawned by a worker goes onto the deque of that worker and is the next
+ * one it runs unless stolen; tasks spawned from other threads are queued for the
+ * workers, or handed to the installed executor.
+ *
+ * @param group Group the task belongs to.
+ * @param task Function to be run.
+ * @param argument Argument of the function.
+ */
+void c3e_pool_spawn(c3e_pool_group* group, void (*task)(void*), void* argument);
+
+/**
+ * @brief Waits for every task of a group, including tasks spawned by them into the group.
+ *
+ * A worker waiting for a group runs other tasks in the meantime.
+ *
+ * @param group Pointer to the group.
+ */
+void c3e_pool_group_wait(c3e_pool_group* group);
+
+#endif /* C3E_POOL_H */
\ No newline at end of file
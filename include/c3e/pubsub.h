@@ -0,0 +1,142 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file pubsub.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Fan-out of matrix streams to many subscribers.
+ *
+ * This file provides a broker that delivers every published matrix to a set of
+ * subscribers. Each frame is serialized once into a reference-counted buffer
+ * shared by the queues of all the subscribers, and every subscriber is fed by its
+ * own sender thread, so the cost of publishing does not grow with the number of
+ * subscribers. Frames use the typed message format and are read on the other end
+ * with `c3e_socket_typed_matrix_read()`.
+ */
+#ifndef C3E_PUBSUB_H
+#define C3E_PUBSUB_H
+
+#include <c3e/codec.h>
+#include <c3e/commons.h>
+#include <c3e/context.h>
+#include <c3e/net.h>
+
+#include <pthread.h>
+
+/**
+ * @enum c3e_broker_policy
+ * @brief Selects what happens when the queue of a subscriber is full.
+ */
+typedef enum {
+    C3E_BROKER_DROP_OLDEST = 0,     ///< The oldest queued frame is discarded.
+    C3E_BROKER_BACKPRESSURE = 1     ///< The publisher waits until the subscriber catches up.
+} c3e_broker_policy;
+
+/**
+ * @struct c3e_frame
+ * @brief A serialized matrix shared by the queues of the subscribers.
+ */
+typedef struct {
+    void* data;         ///< Serialized message.
+    size_t size;        ///< Size of the message in bytes.
+    uint32_t refs;      ///< Number of queues and senders holding the frame.
+} c3e_frame;
+
+struct c3e_broker;
+
+/**
+ * @struct c3e_subscriber
+ * @brief A subscriber of a broker and its queue of pending frames.
+ */
+typedef struct {
+    struct c3e_broker* broker;      ///< Broker the subscriber belongs to.
+    c3e_socket socket;              ///< Connection to the subscriber, owned by the broker.
+    c3e_broker_policy policy;       ///< What happens when the queue is full.
+    c3e_frame** queue;              ///< Circular queue of pending frames.
+    uint32_t head;                  ///< Index of the oldest pending frame.
+    uint32_t count;                 ///< Number of pending frames.
+    bool alive;                     ///< Whether the connection is still usable.
+    uint64_t dropped;               ///< Number of frames discarded for this subscriber.
+    pthread_t thread;               ///< Sender thread of the subscriber.
+    pthread_cond_t ready;           ///< Signaled when a frame is queued.
+    c3e_context_settings settings;  ///< Settings of the subscribing thread, used by the sender.
+} c3e_subscriber;
+
+/**
+ * @struct c3e_broker
+ * @brief Delivers published matrices to every subscriber.
+ */
+typedef struct c3e_broker {
+    c3e_subscriber** subscribers;   ///< Every subscriber, alive or not.
+    uint32_t count;                 ///< Number of subscribers.
+    uint32_t capacity;              ///< Number of allocated subscriber slots.
+    uint32_t depth;                 ///< Capacity of the queue of each subscriber.
+    c3e_dtype dtype;                ///< Element type of the published frames.
+    c3e_codec codec;                ///< Codec applied to native frames.
+    bool stopping;                  ///< Set when the broker is being freed.
+    pthread_mutex_t lock;           ///< Protects the queues and reference counts.
+    pthread_cond_t space;           ///< Signaled when a queue has room again.
+} c3e_broker;
+
+/**
+ * @brief Creates a broker.
+ *
+ * @param depth Maximum number of frames queued for each subscriber.
+ * @param dtype Element type of the frames on the wire.
+ * @param codec Codec applied to frames of `C3E_DTYPE_NATIVE` elements.
+ * @return Pointer to the broker, or NULL on failure.
+ */
+c3e_broker* c3e_broker_init(uint32_t depth, c3e_dtype dtype, c3e_codec codec);
+
+/**
+ * @brief Sends the frames still queued, disconnects every subscriber and frees the broker.
+ *
+ * @param broker Pointer to the broker to be freed.
+ */
+void c3e_broker_free(c3e_broker* broker);
+
+/**
+ * @brief Adds a subscriber.
+ *
+ * The subscriber receives every frame published after this call. The broker takes
+ * ownership of the socket and closes it when the broker is freed.
+ *
+ * @param broker Pointer to the broker.
+ * @param socket A pointer to the socket connected to the subscriber.
+ * @param policy What happens when the queue of the subscriber is full.
+ * @return Pointer to the subscriber, or NULL on failure.
+ */
+c3e_subscriber* c3e_broker_subscribe(c3e_broker* broker, c3e_socket* socket, c3e_broker_policy policy);
+
+/**
+ * @brief Publishes a matrix to every live subscriber.
+ *
+ * @param broker Pointer to the broker.
+ * @param matrix Pointer to the matrix to be published.
+ * @return `true` if the frame was queued, `false` if it could not be serialized.
+ */
+bool c3e_broker_publish(c3e_broker* broker, c3e_matrix* matrix);
+
+/**
+ * @brief Counts the subscribers whose connection is still usable.
+ *
+ * @param broker Pointer to the broker.
+ * @return Number of live subscribers.
+ */
+uint32_t c3e_broker_alive(c3e_broker* broker);
+
+#endif /* C3E_PUBSUB_H */
\ No newline at end of file
@@ -23,17 +23,334 @@
  * This file provides functions for generating random numbers within the C3E library. It includes
  * utilities for generating random numbers with varying characteristics, including pseudorandom
  * values and numbers within a specified range.
+ *
+ * Seeded generation relies on Philox4x32-10, a counter-based generator: block `n` of a stream is
+ * the encryption of the 128-bit counter made of `n` and the stream number, under a key derived
+ * from the seed. Any block can thus be computed on its own, which makes bulk fills cheap to
+ * vectorize and lets independent streams share a seed.
+ *
+ * A generator is plain state: it may be copied, but must not be drawn from by several threads at
+ * once. Threads either get a stream each, or copies of one generator moved with `c3e_rng_seek()`
+ * to disjoint ranges, as `c3e_rng_fill_parallel()` does to produce the same elements whatever the
+ * number of threads.
+ *
+ * Non-uniform distributions are drawn from the same generators. Their bulk fills first fill the
+ * array with uniform numbers at the speed of `c3e_rng_fill()` and then transform it in place, so
+ * they write straight into the `data` of a matrix or vector.
  */
 #ifndef C3E_RANDOM_H
 #define C3E_RANDOM_H
 
 #include <c3e/commons.h>
 
+/**
+ * @struct c3e_rng
+ * @brief State of a Philox4x32-10 stream.
+ *
+ * Every `c3e_number` is made of two consecutive 32-bit words of the stream, or of one word when
+ * `C3E_32BIT_NUMBER` is defined.
+ */
+typedef struct {
+    uint32_t key[2];    ///< Key derived from the seed.
+    uint64_t stream;    ///< Stream number, the upper half of the counter.
+    uint64_t counter;   ///< Next block to be generated.
+    uint32_t block[4];  ///< Words of the last block generated.
+    uint32_t used;      ///< Number of words of `block` already consumed.
+} c3e_rng;
+
+/**
+ * @struct c3e_alias
+ * @brief Alias table sampling a categorical distribution in constant time.
+ */
+typedef struct {
+    uint32_t count;             ///< Number of categories.
+    c3e_number* probability;    ///< Probability of keeping each category instead of its alias.
+    uint32_t* alias;            ///< Alternative category of each category.
+} c3e_alias;
+
+/**
+ * @def C3E_RESERVOIR_SKIP
+ * @brief Returned by `c3e_reservoir_offer()` for items left out of the sample.
+ */
+#define C3E_RESERVOIR_SKIP UINT32_MAX
+
+/**
+ * @struct c3e_reservoir
+ * @brief Uniform sample of fixed size from a stream of unknown length.
+ */
+typedef struct {
+    uint64_t* indices;      ///< Stream index of the item held by every slot.
+    uint32_t capacity;      ///< Size of the sample.
+    uint32_t count;         ///< Number of slots filled so far.
+    uint64_t seen;          ///< Number of items offered so far.
+    uint64_t next;          ///< Index of the next item to be kept once the sample is full.
+    c3e_number weight;      ///< Running weight of Li's algorithm L.
+} c3e_reservoir;
+
+/**
+ * @brief Seeds a generator.
+ *
+ * @param rng Generator to be initialized.
+ * @param seed Seed; equal seeds and streams produce equal sequences.
+ * @param stream Stream number, selecting one of 2^64 independent sequences of the seed.
+ */
+void c3e_rng_init(c3e_rng* rng, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief Draws the next 32-bit word of a generator.
+ *
+ * @param rng Pointer to the generator.
+ * @return A uniformly distributed word.
+ */
+uint32_t c3e_rng_next(c3e_rng* rng);
+
+/**
+ * @brief Draws a uniformly distributed number.
+ *
+ * @param rng Pointer to the generator.
+ * @return A number in the range [0.0, 1.0).
+ */
+c3e_number c3e_rng_uniform(c3e_rng* rng);
+
+/**
+ * @brief Fills an array with uniformly distributed numbers.
+ *
+ * Produces the same numbers as `count` calls to `c3e_rng_uniform()` scaled to the range, but
+ * generates whole blocks at once.
+ *
+ * @param rng Pointer to the generator.
+ * @param data Array to be filled.
+ * @param count Number of elements.
+ * @param min Lower bound of the range (inclusive).
+ * @param max Upper bound of the range (exclusive).
+ */
+void c3e_rng_fill(c3e_rng* rng, c3e_number* data, size_t count, c3e_number min, c3e_number max);
+
+/**
+ * @brief Moves a generator to a position of its stream.
+ *
+ * @param rng Pointer to the generator.
+ * @param position Index of the next `c3e_number` to be drawn, counted from the start of the stream.
+ */
+void c3e_rng_seek(c3e_rng* rng, uint64_t position);
+
+/**
+ * @brief Fills an array with uniformly distributed numbers on several threads.
+ *
+ * The array is split into one range per thread, and every thread draws its range from a copy of
+ * the generator moved to the start of that range. The elements and the final state of the
+ * generator are the same as with `c3e_rng_fill()`, whatever the number of threads.
+ *
+ * @param rng Pointer to the generator.
+ * @param data Array to be filled.
+ * @param count Number of elements.
+ * @param min Lower bound of the range (inclusive).
+ * @param max Upper bound of the range (exclusive).
+ * @param threads Number of parallel tasks, or 0 for one per thread of the pool.
+ */
+void c3e_rng_fill_parallel(c3e_rng* rng, c3e_number* data, size_t count, c3e_number min, c3e_number max, uint32_t threads);
+
+/**
+ * @brief Draws an integer below a bound without modulo bias, with Lemire's method.
+ *
+ * @param rng Pointer to the generator.
+ * @param bound Exclusive upper bound, not 0.
+ * @return An integer in the range [0, bound).
+ */
+uint32_t c3e_rng_below(c3e_rng* rng, uint32_t bound);
+
+/**
+ * @brief Shuffles an array of indices uniformly.
+ *
+ * Arrays of up to 65536 elements are shuffled with Fisher-Yates. Larger arrays are cut into
+ * blocks of that size shuffled in parallel, which are then merged pairwise, also in parallel,
+ * with the MergeShuffle algorithm of Bacher et al. Every block and merge draws from its own
+ * stream derived from the generator, so the result does not depend on the number of threads.
+ *
+ * @param rng Pointer to the generator.
+ * @param indices Array to be shuffled.
+ * @param count Number of elements.
+ * @param threads Number of parallel tasks, or 0 for one per thread of the pool.
+ * @return `true` on success, `false` if the merge buffer could not be allocated.
+ */
+bool c3e_rng_shuffle(c3e_rng* rng, uint32_t* indices, uint32_t count, uint32_t threads);
+
+/**
+ * @brief Fills an array with a uniformly random permutation of `0` to `count - 1`.
+ *
+ * @param rng Pointer to the generator.
+ * @param indices Array to be filled.
+ * @param count Number of elements.
+ * @param threads Number of parallel tasks, or 0 for one per thread of the pool.
+ * @return `true` on success, `false` if the merge buffer could not be allocated.
+ */
+bool c3e_rng_permutation(c3e_rng* rng, uint32_t* indices, uint32_t count, uint32_t threads);
+
+/**
+ * @brief Draws distinct indices below a population size, in random order, with Floyd's algorithm.
+ *
+ * Takes time and memory proportional to `count`, however large the population.
+ *
+ * @param rng Pointer to the generator.
+ * @param population Number of items to choose from.
+ * @param indices Array receiving the chosen indices.
+ * @param count Number of indices to draw, at most `population`.
+ * @return `true` on success, `false` if the table of chosen indices could not be allocated.
+ */
+bool c3e_rng_sample(c3e_rng* rng, uint32_t population, uint32_t* indices, uint32_t count);
+
+/**
+ * @brief Creates an empty reservoir.
+ *
+ * @param capacity Size of the sample.
+ * @return Pointer to the reservoir, or NULL on failure.
+ */
+c3e_reservoir* c3e_reservoir_init(uint32_t capacity);
+
+/**
+ * @brief Frees a reservoir.
+ *
+ * @param reservoir Pointer to the reservoir.
+ */
+void c3e_reservoir_free(c3e_reservoir* reservoir);
+
+/**
+ * @brief Offers the next item of the stream to a reservoir.
+ *
+ * Items are kept with Li's algorithm L, which draws random numbers only for the items it keeps,
+ * so offering an item that is left out costs a comparison.
+ *
+ * @param reservoir Pointer to the reservoir.
+ * @param rng Pointer to the generator.
+ * @return Slot where the item must be stored, or `C3E_RESERVOIR_SKIP`.
+ */
+uint32_t c3e_reservoir_offer(c3e_reservoir* reservoir, c3e_rng* rng);
+
+/**
+ * @brief Draws a normally distributed number with the Box-Muller transform.
+ *
+ * @param rng Pointer to the generator.
+ * @param mean Mean of the distribution.
+ * @param stddev Standard deviation of the distribution.
+ * @return A normally distributed number.
+ */
+c3e_number c3e_rng_normal(c3e_rng* rng, c3e_number mean, c3e_number stddev);
+
+/**
+ * @brief Fills an array with normally distributed numbers.
+ *
+ * Every pair of elements is made from one pair of uniform numbers.
+ *
+ * @param rng Pointer to the generator.
+ * @param data Array to be filled.
+ * @param count Number of elements.
+ * @param mean Mean of the distribution.
+ * @param stddev Standard deviation of the distribution.
+ */
+void c3e_rng_fill_normal(c3e_rng* rng, c3e_number* data, size_t count, c3e_number mean, c3e_number stddev);
+
+/**
+ * @brief Draws an exponentially distributed number.
+ *
+ * @param rng Pointer to the generator.
+ * @param rate Rate of the distribution, the inverse of its mean.
+ * @return A number in the range [0, +inf).
+ */
+c3e_number c3e_rng_exponential(c3e_rng* rng, c3e_number rate);
+
+/**
+ * @brief Fills an array with exponentially distributed numbers.
+ *
+ * @param rng Pointer to the generator.
+ * @param data Array to be filled.
+ * @param count Number of elements.
+ * @param rate Rate of the distribution, the inverse of its mean.
+ */
+void c3e_rng_fill_exponential(c3e_rng* rng, c3e_number* data, size_t count, c3e_number rate);
+
+/**
+ * @brief Draws a gamma distributed number with the method of Marsaglia and Tsang.
+ *
+ * @param rng Pointer to the generator.
+ * @param shape Shape of the distribution, greater than 0.
+ * @param scale Scale of the distribution, greater than 0.
+ * @return A number in the range (0, +inf).
+ */
+c3e_number c3e_rng_gamma(c3e_rng* rng, c3e_number shape, c3e_number scale);
+
+/**
+ * @brief Fills an array with gamma distributed numbers.
+ *
+ * @param rng Pointer to the generator.
+ * @param data Array to be filled.
+ * @param count Number of elements.
+ * @param shape Shape of the distribution, greater than 0.
+ * @param scale Scale of the distribution, greater than 0.
+ */
+void c3e_rng_fill_gamma(c3e_rng* rng, c3e_number* data, size_t count, c3e_number shape, c3e_number scale);
+
+/**
+ * @brief Draws a Poisson distributed count.
+ *
+ * Means below 10 multiply uniform numbers; larger means use the transformed rejection of
+ * Hörmann (PTRS), which evaluates `c3e_log_gamma()` on rare rejections only.
+ *
+ * @param rng Pointer to the generator.
+ * @param mean Mean of the distribution, not negative.
+ * @return A non-negative integer.
+ */
+c3e_number c3e_rng_poisson(c3e_rng* rng, c3e_number mean);
+
+/**
+ * @brief Fills an array with Poisson distributed counts.
+ *
+ * @param rng Pointer to the generator.
+ * @param data Array to be filled.
+ * @param count Number of elements.
+ * @param mean Mean of the distribution, not negative.
+ */
+void c3e_rng_fill_poisson(c3e_rng* rng, c3e_number* data, size_t count, c3e_number mean);
+
+/**
+ * @brief Builds the alias table of a categorical distribution with Vose's method.
+ *
+ * @param weights Non-negative weights of the categories, not all zero.
+ * @param count Number of categories.
+ * @return Pointer to the table, or NULL on failure.
+ */
+c3e_alias* c3e_alias_init(const c3e_number* weights, uint32_t count);
+
+/**
+ * @brief Frees an alias table.
+ *
+ * @param alias Pointer to the table.
+ */
+void c3e_alias_free(c3e_alias* alias);
+
+/**
+ * @brief Draws a category from an alias table, using one uniform number.
+ *
+ * @param rng Pointer to the generator.
+ * @param alias Pointer to the table.
+ * @return Index of the category.
+ */
+uint32_t c3e_rng_categorical(c3e_rng* rng, c3e_alias* alias);
+
+/**
+ * @brief Fills an array with categories drawn from an alias table.
+ *
+ * @param rng Pointer to the generator.
+ * @param alias Pointer to the table.
+ * @param data Array to be filled with category indices.
+ * @param count Number of elements.
+ */
+void c3e_rng_fill_categorical(c3e_rng* rng, c3e_alias* alias, c3e_number* data, size_t count);
+
 /**
  * @brief Generates a random number.
  *
- * This function produces a random floating-point number from `/dev/urandom`.
- * The number generated is uniformly distributed within this range.
+ * This function draws from the generator of the context of the calling thread, seeded once
+ * from `/dev/urandom` unless the context was given a seed with `c3e_context_init()`.
  *
  * @return A random number in the range [0.0, 1.0).
  */
@@ -43,8 +360,8 @@ c3e_number c3e_random();
  * @brief Generates a pseudorandom number.
  *
  * This function produces a pseudorandom floating-point number between 0.0 and 1.0. Unlike `c3e_random()`,
- * this function may use a different algorithm or seed for generating pseudorandom numbers, providing
- * a potentially different distribution or pattern of randomness.
+ * it draws from a generator with a fixed seed, kept in the context of the calling thread, so every
+ * thread sees the same reproducible sequence.
  *
  * @return A pseudorandom number in the range [0.0, 1.0).
  */
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file remote.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Remote execution of matrix operations.
+ *
+ * This file provides a compute service that runs C3E matrix operations on behalf
+ * of its clients. Operands are uploaded once and stay resident on the server under
+ * a name; requests refer to them by name and either store their result under a new
+ * name or send it back. Clients may send any number of requests before reading the
+ * results, which come back in the order of the requests.
+ */
+#ifndef C3E_REMOTE_H
+#define C3E_REMOTE_H
+
+#include <c3e/commons.h>
+#include <c3e/net.h>
+
+#include <pthread.h>
+
+/**
+ * @def C3E_REMOTE_MAGIC
+ * @brief Magic number ("C3ER") opening every request and response.
+ */
+#define C3E_REMOTE_MAGIC 0x52453343u
+
+/**
+ * @def C3E_REMOTE_NAME_SIZE
+ * @brief Size of an operand name, including the terminating null character.
+ */
+#define C3E_REMOTE_NAME_SIZE 32
+
+/**
+ * @enum c3e_remote_op
+ * @brief Operations understood by the compute service.
+ */
+typedef enum {
+    C3E_REMOTE_PUT = 0,         ///< Stores the uploaded matrix under the output name.
+    C3E_REMOTE_GET = 1,         ///< Returns the left operand.
+    C3E_REMOTE_DROP = 2,        ///< Removes the left operand from the server.
+    C3E_REMOTE_ADD = 3,         ///< `c3e_matrix_add()` of both operands.
+    C3E_REMOTE_SUB = 4,         ///< `c3e_matrix_sub()` of both operands.
+    C3E_REMOTE_MUL = 5,         ///< `c3e_matrix_mul()` of both operands.
+    C3E_REMOTE_DOT = 6,         ///< `c3e_matrix_dot()` of both operands.
+    C3E_REMOTE_TRANSPOSE = 7,   ///< `c3e_matrix_transpose()` of the left operand.
+    C3E_REMOTE_INVERSE = 8,     ///< `c3e_matrix_inverse()` of the left operand.
+    C3E_REMOTE_SCALAR_ADD = 9,  ///< `c3e_matrix_scalar_add()` of the left operand.
+    C3E_REMOTE_SCALAR_MUL = 10  ///< `c3e_matrix_scalar_mul()` of the left operand.
+} c3e_remote_op;
+
+/**
+ * @enum c3e_remote_reply
+ * @brief Selects how the result of a request is returned.
+ */
+typedef enum {
+    C3E_REMOTE_REPLY_HANDLE = 0,    ///< Only the shape is returned; the result stays on the server.
+    C3E_REMOTE_REPLY_VALUE = 1      ///< The result is sent back with the response.
+} c3e_remote_reply;
+
+/**
+ * @enum c3e_remote_status
+ * @brief Outcome of a request.
+ */
+typedef enum {
+    C3E_REMOTE_OK = 0,          ///< The request succeeded.
+    C3E_REMOTE_NOT_FOUND = 1,   ///< An operand name is not resident on the server.
+    C3E_REMOTE_INVALID = 2,     ///< The operands do not suit the operation.
+    C3E_REMOTE_FAILED = 3       ///< The server ran out of memory.
+} c3e_remote_status;
+
+/**
+ * @struct c3e_remote_result
+ * @brief Response to one request, as read by the client.
+ */
+typedef struct {
+    c3e_remote_status status;   ///< Outcome of the request.
+    uint32_t rows;              ///< Number of rows of the result.
+    uint32_t cols;              ///< Number of columns of the result.
+    c3e_matrix* value;          ///< The result if it was requested by value, NULL otherwise.
+} c3e_remote_result;
+
+/**
+ * @struct c3e_remote_operand
+ * @brief A resident matrix, kept alive while requests are still using it.
+ */
+typedef struct {
+    c3e_matrix* matrix;     ///< The operand.
+    uint32_t refs;          ///< Number of holders: its name and the running requests.
+} c3e_remote_operand;
+
+/**
+ * @struct c3e_remote_entry
+ * @brief A named operand of the store.
+ */
+typedef struct {
+    char name[C3E_REMOTE_NAME_SIZE];    ///< Name of the operand.
+    c3e_remote_operand* operand;        ///< The operand.
+} c3e_remote_entry;
+
+/**
+ * @struct c3e_remote_store
+ * @brief The named operands resident on a server, shared by all its connections.
+ */
+typedef struct {
+    c3e_remote_entry* entries;  ///< Named operands.
+    uint32_t count;             ///< Number of resident operands.
+    uint32_t capacity;          ///< Number of allocated entries.
+    pthread_mutex_t lock;       ///< Protects the entries and reference counts.
+} c3e_remote_store;
+
+/**
+ * @brief Creates an empty operand store.
+ *
+ * @return Pointer to the store, or NULL on failure.
+ */
+c3e_remote_store* c3e_remote_store_init(void);
+
+/**
+ * @brief Frees an operand store and every resident operand.
+ *
+ * @param store Pointer to the store to be freed.
+ */
+void c3e_remote_store_free(c3e_remote_store* store);
+
+/**
+ * @brief Serves the requests of one client until it disconnects.
+ *
+ * @param store Pointer to the store holding the resident operands.
+ * @param client A pointer to the socket connected to the client.
+ * @return `true` if the client disconnected between requests, `false` on error.
+ */
+bool c3e_remote_serve(c3e_remote_store* store, c3e_socket* client);
+
+/**
+ * @brief Runs the compute service, serving each client from its own thread.
+ *
+ * This function only returns when accepting a connection fails.
+ *
+ * @param store Pointer to the store shared by all the clients.
+ * @param hostname IP address to listen on.
+ * @param port Port number to listen on.
+ * @return `false` if the service could not be started or stopped accepting clients.
+ */
+bool c3e_remote_daemon(c3e_remote_store* store, const char* hostname, int port);
+
+/**
+ * @brief Uploads a matrix and keeps it resident on the server.
+ *
+ * The server answers with a result like any other request.
+ *
+ * @param socket A pointer to the socket connected to the server.
+ * @param name Name of the operand, replacing any operand of the same name.
+ * @param matrix Pointer to the matrix to be uploaded.
+ * @return `true` if the request was sent, `false` otherwise.
+ */
+bool c3e_remote_upload(c3e_socket* socket, const char* name, c3e_matrix* matrix);
+
+/**
+ * @brief Sends a request without waiting for its result.
+ *
+ * @param socket A pointer to the socket connected to the server.
+ * @param op Operation to be performed.
+ * @param out Name under which the result is stored, or NULL to keep it transient.
+ * @param left Name of the left operand.
+ * @param right Name of the right operand, or NULL for unary operations.
+ * @param scalar Scalar operand of `C3E_REMOTE_SCALAR_ADD` and `C3E_REMOTE_SCALAR_MUL`.
+ * @param reply How the result is returned.
+ * @return `true` if the request was sent, `false` otherwise.
+ */
+bool c3e_remote_request(c3e_socket* socket, c3e_remote_op op, const char* out, const char* left, const char* right, c3e_number scalar, c3e_remote_reply reply);
+
+/**
+ * @brief Reads the result of the oldest request still unanswered.
+ *
+ * @param socket A pointer to the socket connected to the server.
+ * @param result Receives the result; its value must be freed by the caller.
+ * @return `true` if a result was read, `false` otherwise.
+ */
+bool c3e_remote_receive(c3e_socket* socket, c3e_remote_result* result);
+
+#endif /* C3E_REMOTE_H */
\ No newline at end of file
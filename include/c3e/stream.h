@@ -0,0 +1,177 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file stream.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Streams running operations asynchronously, in order, with events as futures.
+ *
+ * A stream owns a background thread running the operations enqueued on it one
+ * after the other, in the order they were enqueued, while the caller goes on.
+ * Enqueuing an operation returns an event, which completes with the result of
+ * the operation and can be polled or waited for.
+ *
+ * Operations of different streams run concurrently. A stream can be made to
+ * wait for an event of another stream before its next operation, so pipelines
+ * express their dependencies and overlap everything else. Operations are free to
+ * block, for example on the network, since the thread of a stream is not part of
+ * the thread pool; parallel kernels called from an operation still run on the
+ * pool.
+ *
+ * Like parallel loops, an operation runs under the context settings of the
+ * thread that enqueued it: its assertion handler, allocator and executor.
+ */
+#ifndef C3E_STREAM_H
+#define C3E_STREAM_H
+
+#include <c3e/commons.h>
+#include <c3e/context.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**
+ * @typedef c3e_stream_op
+ * @brief Operation run by a stream.
+ *
+ * @param argument Pointer given when the operation was enqueued.
+ * @return Result of the operation, handed to the waiters of its event.
+ */
+typedef void* (*c3e_stream_op)(void* argument);
+
+/**
+ * @struct c3e_event
+ * @brief Completion and result of an operation of a stream.
+ */
+typedef struct {
+    _Atomic uint32_t done;          ///< Set once the operation has returned.
+    void* result;                   ///< Result of the operation, valid once done.
+    _Atomic uint32_t references;    ///< Holders of the event, freed when the last one releases it.
+} c3e_event;
+
+/**
+ * @struct c3e_stream_entry
+ * @brief Entry of the queue of a stream.
+ */
+typedef struct c3e_stream_entry {
+    c3e_stream_op op;                   ///< Operation to be run, or NULL.
+    void* argument;                     ///< Argument of the operation.
+    c3e_event* awaited;                 ///< Event to be waited for before the operation, or NULL.
+    c3e_event* event;                   ///< Event completed after the operation, or NULL.
+    c3e_context_settings settings;      ///< Settings of the thread that enqueued the operation.
+    struct c3e_stream_entry* next;      ///< Next entry of the queue.
+} c3e_stream_entry;
+
+/**
+ * @struct c3e_stream
+ * @brief A stream and its thread.
+ */
+typedef struct {
+    pthread_t thread;           ///< Thread running the operations.
+    pthread_mutex_t lock;       ///< Lock of the queue.
+    pthread_cond_t ready;       ///< Signalled when an entry is enqueued or the stream is freed.
+    c3e_stream_entry* head;     ///< Next entry to be run.
+    c3e_stream_entry* tail;     ///< Last entry enqueued.
+    bool stopping;              ///< Set when the stream is being freed.
+} c3e_stream;
+
+/**
+ * @brief Creates a stream and starts its thread.
+ *
+ * @return Pointer to the stream, or NULL on failure.
+ */
+c3e_stream* c3e_stream_init(void);
+
+/**
+ * @brief Runs the operations left on a stream, stops its thread and frees it.
+ *
+ * @param stream Pointer to the stream to be freed.
+ */
+void c3e_stream_free(c3e_stream* stream);
+
+/**
+ * @brief Enqueues an operation on a stream.
+ *
+ * @param stream Pointer to the stream.
+ * @param op Operation to be run.
+ * @param argument Argument of the operation, which must stay valid until it has run.
+ * @return Event of the operation, to be released with `c3e_event_release()`, or NULL on failure.
+ */
+c3e_event* c3e_stream_enqueue(c3e_stream* stream, c3e_stream_op op, void* argument);
+
+/**
+ * @brief Makes the operations enqueued next on a stream wait for an event.
+ *
+ * The event may belong to any stream, but waiting on an event of an operation
+ * enqueued later on the same stream never completes.
+ *
+ * @param stream Pointer to the stream.
+ * @param event Event to be waited for, which the stream holds until then.
+ * @return `true` if the dependency was enqueued, `false` otherwise.
+ */
+bool c3e_stream_wait_event(c3e_stream* stream, c3e_event* event);
+
+/**
+ * @brief Records an event completing once every operation enqueued so far has run.
+ *
+ * @param stream Pointer to the stream.
+ * @return Event with a NULL result, to be released with `c3e_event_release()`, or NULL on failure.
+ */
+c3e_event* c3e_stream_record(c3e_stream* stream);
+
+/**
+ * @brief Waits for every operation enqueued so far on a stream.
+ *
+ * @param stream Pointer to the stream.
+ * @return `true` once the operations have run, `false` if the wait could not be enqueued.
+ */
+bool c3e_stream_synchronize(c3e_stream* stream);
+
+/**
+ * @brief Enqueues the product of two matrices on a stream.
+ *
+ * @param stream Pointer to the stream.
+ * @param matrix Left operand, which must not change until the product has run.
+ * @param subject Right operand, which must not change until the product has run.
+ * @return Event whose result is the product, owned by the caller, or NULL on failure.
+ */
+c3e_event* c3e_stream_matrix_mul(c3e_stream* stream, c3e_matrix* matrix, c3e_matrix* subject);
+
+/**
+ * @brief Tells whether the operation of an event has run.
+ *
+ * @param event Pointer to the event.
+ * @return `true` if the event is complete, `false` otherwise.
+ */
+bool c3e_event_query(c3e_event* event);
+
+/**
+ * @brief Waits for the operation of an event.
+ *
+ * @param event Pointer to the event.
+ * @return Result of the operation.
+ */
+void* c3e_event_wait(c3e_event* event);
+
+/**
+ * @brief Gives up a reference to an event, freeing it with the last one.
+ *
+ * @param event Pointer to the event.
+ */
+void c3e_event_release(c3e_event* event);
+
+#endif /* C3E_STREAM_H */
\ No newline at end of file
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+/**
+ * @file sync.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Delta synchronization of matrices between nodes.
+ *
+ * This file provides a tile-based replication mechanism for matrices. The sender
+ * splits a matrix into tiles and remembers a hash of every tile as it was last
+ * sent. Each synchronization transmits only the tiles that changed, together with
+ * their coordinates, and the receiver patches its replica in place.
+ */
+#ifndef C3E_SYNC_H
+#define C3E_SYNC_H
+
+#include <c3e/commons.h>
+#include <c3e/net.h>
+
+/**
+ * @def C3E_SYNC_MAGIC
+ * @brief Magic number ("C3ED") opening every delta synchronization message.
+ */
+#define C3E_SYNC_MAGIC 0x44453343u
+
+/**
+ * @enum c3e_sync_mode
+ * @brief Selects how changed tiles are detected.
+ */
+typedef enum {
+    C3E_SYNC_HASH = 0,      ///< Every tile is hashed and compared with the last sent version.
+    C3E_SYNC_TRACKED = 1    ///< Only tiles marked with `c3e_matrix_sync_mark()` are sent.
+} c3e_sync_mode;
+
+/**
+ * @struct c3e_matrix_sync
+ * @brief Tracks the replicated state of a matrix on the sending side.
+ */
+typedef struct {
+    c3e_matrix* matrix;     ///< The tracked matrix, not owned by the synchronizer.
+    c3e_sync_mode mode;     ///< How changed tiles are detected.
+    uint32_t tile_rows;     ///< Number of rows of a tile.
+    uint32_t tile_cols;     ///< Number of columns of a tile.
+    uint32_t tiles_down;    ///< Number of tiles along the rows of the matrix.
+    uint32_t tiles_across;  ///< Number of tiles along the columns of the matrix.
+    uint64_t* hashes;       ///< Hash of every tile as it was last sent.
+    bool* dirty;            ///< Dirty flag of every tile.
+    uint32_t last_sent;     ///< Number of tiles transmitted by the last synchronization.
+} c3e_matrix_sync;
+
+/**
+ * @brief Creates a synchronizer for a matrix.
+ *
+ * Every tile starts dirty, so the first synchronization transmits the whole matrix.
+ *
+ * @param matrix Pointer to the matrix to be replicated.
+ * @param tile_rows Number of rows of a tile.
+ * @param tile_cols Number of columns of a tile.
+ * @param mode How changed tiles are detected.
+ * @return Pointer to the new synchronizer, or NULL on failure.
+ */
+c3e_matrix_sync* c3e_matrix_sync_init(c3e_matrix* matrix, uint32_t tile_rows, uint32_t tile_cols, c3e_sync_mode mode);
+
+/**
+ * @brief Frees a synchronizer. The tracked matrix is left untouched.
+ *
+ * @param sync Pointer to the synchronizer to be freed.
+ */
+void c3e_matrix_sync_free(c3e_matrix_sync* sync);
+
+/**
+ * @brief Marks a rectangular region of the tracked matrix as modified.
+ *
+ * Every tile overlapping the region is sent by the next synchronization, whatever
+ * the detection mode.
+ *
+ * @param sync Pointer to the synchronizer.
+ * @param row Index of the first modified row.
+ * @param col Index of the first modified column.
+ * @param rows Number of modified rows.
+ * @param cols Number of modified columns.
+ */
+void c3e_matrix_sync_mark(c3e_matrix_sync* sync, uint32_t row, uint32_t col, uint32_t rows, uint32_t cols);
+
+/**
+ * @brief Sends the tiles changed since the last synchronization.
+ *
+ * If any part of the delta cannot be sent, the changed tiles stay pending and
+ * are sent again with the next delta.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for sending.
+ * @param sync Pointer to the synchronizer.
+ * @return `true` if the delta was sent successfully, `false` otherwise.
+ */
+bool c3e_matrix_sync_send(c3e_socket* socket, c3e_matrix_sync* sync);
+
+/**
+ * @brief Sends the same delta to several replicas.
+ *
+ * The changed tiles are detected and packed once, then sent to every socket. All
+ * replicas must have been synchronized from this synchronizer since they were
+ * created.
+ *
+ * @param sockets Array of pointers to the sockets of the replicas.
+ * @param count Number of sockets in the array.
+ * @param sync Pointer to the synchronizer.
+ * @return `true` if the delta was sent to every replica, `false` otherwise.
+ */
+bool c3e_matrix_sync_broadcast(c3e_socket** sockets, uint32_t count, c3e_matrix_sync* sync);
+
+/**
+ * @brief Receives a delta and patches a replica in place.
+ *
+ * The replica is only patched once the whole delta was received, so a truncated
+ * delta leaves it untouched. A delta announcing more tiles than the replica has
+ * is rejected before anything is allocated.
+ *
+ * @param socket A pointer to the `c3e_socket` structure used for receiving.
+ * @param matrix Pointer to the replica, with the same shape as the tracked matrix.
+ * @return The number of tiles patched, or -1 on failure.
+ */
+int c3e_matrix_sync_receive(c3e_socket* socket, c3e_matrix* matrix);
+
+#endif /* C3E_SYNC_H */
\ No newline at end of file
@@ -58,7 +58,9 @@ c3e_vector* c3e_vector_create(size_t size, c3e_number* data);
 /**
  * @brief Frees the memory allocated for a vector.
  *
- * Releases the memory occupied by the vector and its elements.
+ * Releases the memory occupied by the vector and its elements. The elements
+ * go back to `c3e_memory_free()`, which passes buffers it did not allocate,
+ * such as ones from `malloc()`, to `free()`.
  *
  * @param vector A pointer to the vector to be freed.
  */
@@ -0,0 +1,574 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/archive.h>
+#include <c3e/assert.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define C3E_ARCHIVE_HEADER_SIZE 64
+#define C3E_ARCHIVE_BATCH       65536
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t count;
+    uint32_t padding;
+    uint64_t directory;
+    uint8_t unused[40];
+} c3e_archive_header;
+
+static inline uint64_t c3e_archive_align(uint64_t position) {
+    return (position + C3E_ARCHIVE_ALIGNMENT - 1) & ~((uint64_t) C3E_ARCHIVE_ALIGNMENT - 1);
+}
+
+static inline c3e_dtype c3e_archive_native(void) {
+#ifndef C3E_32BIT_NUMBER
+    return C3E_DTYPE_FLOAT64;
+#else
+    return C3E_DTYPE_FLOAT32;
+#endif
+}
+
+static bool c3e_archive_write(int fd, const void* data, size_t size, uint64_t offset) {
+    const char* bytes = (const char*) data;
+
+    while(size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, (off_t) offset);
+
+        if(written < 0 && errno == EINTR)
+            continue;
+        else if(written <= 0)
+            return false;
+
+        bytes += written;
+        size -= (size_t) written;
+        offset += (uint64_t) written;
+    }
+
+    return true;
+}
+
+static bool c3e_archive_write_block(c3e_archive_writer* writer, const c3e_number* data, size_t count, c3e_dtype dtype, c3e_codec codec, uint64_t* offset, uint64_t* size) {
+    bool written = true;
+    *offset = c3e_archive_align(writer->position);
+
+    if(codec != C3E_CODEC_NONE) {
+        size_t capacity = c3e_codec_bound(codec, count);
+        void* buffer = malloc(capacity);
+
+        if(buffer == NULL)
+            return false;
+
+        *size = c3e_codec_encode(codec, data, count, buffer, capacity);
+        written = *size != 0 && c3e_archive_write(writer->fd, buffer, *size, *offset);
+
+        free(buffer);
+    }
+    else if(dtype == c3e_archive_native()) {
+        *size = count * sizeof(c3e_number);
+        written = c3e_archive_write(writer->fd, data, *size, *offset);
+    }
+    else {
+        size_t width = c3e_dtype_size(dtype);
+        size_t batch = count < C3E_ARCHIVE_BATCH ? count : C3E_ARCHIVE_BATCH;
+        void* buffer = malloc(batch * width);
+
+        if(buffer == NULL && batch != 0)
+            return false;
+
+        *size = count * width;
+        for(size_t i = 0; written && i < count; i += batch) {
+            size_t length = count - i < batch ? count - i : batch;
+
+            c3e_dtype_narrow(dtype, data + i, buffer, length);
+            written = c3e_archive_write(writer->fd, buffer, length * width, *offset + i * width);
+        }
+
+        free(buffer);
+    }
+
+    if(written)
+        writer->position = *offset + *size;
+    return written;
+}
+
+static c3e_archive_entry* c3e_archive_add(c3e_archive_writer* writer, const char* name, c3e_archive_kind kind, c3e_dtype* dtype, c3e_codec* codec) {
+    c3e_assert(writer != NULL);
+    c3e_assert(name != NULL && strlen(name) < C3E_ARCHIVE_NAME_SIZE);
+    c3e_assert(c3e_dtype_size(*dtype) != 0);
+
+    for(uint32_t i = 0; i < writer->count; i++)
+        c3e_assert(strcmp(writer->entries[i].name, name) != 0);
+
+    if(writer->count == writer->capacity) {
+        uint32_t capacity = writer->capacity == 0 ? 16 : writer->capacity * 2;
+        c3e_archive_entry* entries = (c3e_archive_entry*) realloc(
+            writer->entries,
+            capacity * sizeof(c3e_archive_entry)
+        );
+
+        if(entries == NULL)
+            return NULL;
+
+        writer->entries = entries;
+        writer->capacity = capacity;
+    }
+
+    if(*dtype == C3E_DTYPE_NATIVE)
+        *dtype = c3e_archive_native();
+    if(*dtype != c3e_archive_native())
+        *codec = C3E_CODEC_NONE;
+
+    c3e_archive_entry* entry = &writer->entries[writer->count];
+    memset(entry, 0, sizeof(c3e_archive_entry));
+
+    strcpy(entry->name, name);
+    entry->kind = (uint8_t) kind;
+    entry->dtype = (uint8_t) *dtype;
+    entry->codec = (uint8_t) *codec;
+
+    return entry;
+}
+
+static bool c3e_archive_fits(c3e_archive* archive, uint64_t offset, uint64_t size) {
+    return offset <= archive->size && size <= archive->size - offset;
+}
+
+static bool c3e_archive_mappable(c3e_archive_entry* entry) {
+    return entry->codec == C3E_CODEC_NONE && entry->dtype == c3e_archive_native();
+}
+
+static c3e_number* c3e_archive_elements(c3e_archive* archive, c3e_archive_entry* entry, uint64_t offset, uint64_t size, size_t count, c3e_number* target) {
+    if(!c3e_archive_fits(archive, offset, size))
+        return NULL;
+
+    const uint8_t* payload = archive->map + offset;
+    if(c3e_archive_mappable(entry))
+        return size == count * sizeof(c3e_number) ? (c3e_number*) payload : NULL;
+    else if(target == NULL)
+        return NULL;
+    else if(entry->codec != C3E_CODEC_NONE)
+        return c3e_codec_decode(payload, size, target, count) ? target : NULL;
+    else if(size != count * c3e_dtype_size((c3e_dtype) entry->dtype))
+        return NULL;
+
+    c3e_dtype_widen((c3e_dtype) entry->dtype, payload, target, count);
+    return target;
+}
+
+static c3e_number* c3e_archive_reserve(c3e_archive* archive, uint32_t index, size_t count) {
+    if(c3e_archive_mappable(&archive->entries[index]))
+        return NULL;
+
+    archive->buffers[index] = (c3e_number*) malloc((count == 0 ? 1 : count) * sizeof(c3e_number));
+    return archive->buffers[index];
+}
+
+static void c3e_archive_release(c3e_archive* archive, uint32_t index) {
+    void* object = archive->objects[index];
+
+    if(object != NULL && archive->entries[index].kind == C3E_ARCHIVE_TENSOR) {
+        c3e_tensor* tensor = (c3e_tensor*) object;
+
+        if(tensor->matrices != NULL)
+            for(uint32_t i = 0; i < tensor->dimensions; i++)
+                free(tensor->matrices[i]);
+
+        free(tensor->matrices);
+        free(tensor->data);
+    }
+
+    free(object);
+    free(archive->buffers[index]);
+
+    archive->objects[index] = NULL;
+    archive->buffers[index] = NULL;
+}
+
+static int64_t c3e_archive_index(c3e_archive* archive, const char* name, c3e_archive_kind kind) {
+    c3e_archive_entry* entry = c3e_archive_find(archive, name);
+
+    if(entry == NULL || entry->kind != kind)
+        return -1;
+    return entry - archive->entries;
+}
+
+c3e_archive_writer* c3e_archive_create(const char* path) {
+    c3e_assert(path != NULL);
+
+    c3e_archive_writer* writer = (c3e_archive_writer*) malloc(sizeof(c3e_archive_writer));
+    if(writer == NULL)
+        return NULL;
+
+    writer->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    writer->position = C3E_ARCHIVE_HEADER_SIZE;
+    writer->entries = NULL;
+    writer->count = 0;
+    writer->capacity = 0;
+
+    if(writer->fd < 0) {
+        free(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+bool c3e_archive_put_matrix(c3e_archive_writer* writer, const char* name, c3e_matrix* matrix, c3e_dtype dtype, c3e_codec codec) {
+    c3e_assert(matrix != NULL);
+
+    c3e_archive_entry* entry = c3e_archive_add(writer, name, C3E_ARCHIVE_MATRIX, &dtype, &codec);
+    if(entry == NULL)
+        return false;
+
+    entry->rows = matrix->rows;
+    entry->cols = matrix->cols;
+
+    if(!c3e_archive_write_block(
+        writer, matrix->data, (size_t) matrix->rows * matrix->cols,
+        dtype, codec, &entry->offset, &entry->size
+    ))
+        return false;
+
+    writer->count++;
+    return true;
+}
+
+bool c3e_archive_put_vector(c3e_archive_writer* writer, const char* name, c3e_vector* vector, c3e_dtype dtype, c3e_codec codec) {
+    c3e_assert(vector != NULL);
+
+    c3e_archive_entry* entry = c3e_archive_add(writer, name, C3E_ARCHIVE_VECTOR, &dtype, &codec);
+    if(entry == NULL)
+        return false;
+
+    entry->rows = vector->size;
+    entry->cols = 1;
+
+    if(!c3e_archive_write_block(
+        writer, vector->data, vector->size,
+        dtype, codec, &entry->offset, &entry->size
+    ))
+        return false;
+
+    writer->count++;
+    return true;
+}
+
+bool c3e_archive_put_tensor(c3e_archive_writer* writer, const char* name, c3e_tensor* tensor, c3e_dtype dtype, c3e_codec codec) {
+    c3e_assert(tensor != NULL);
+
+    c3e_archive_entry* entry = c3e_archive_add(writer, name, C3E_ARCHIVE_TENSOR, &dtype, &codec);
+    if(entry == NULL)
+        return false;
+
+    size_t table_size = ((size_t) tensor->dimensions + 1) * sizeof(c3e_archive_block);
+    c3e_archive_block* blocks = (c3e_archive_block*) calloc(tensor->dimensions + 1, sizeof(c3e_archive_block));
+
+    if(blocks == NULL)
+        return false;
+
+    entry->rows = tensor->dimensions;
+    entry->cols = 0;
+    entry->dimension_size = tensor->dimension_size;
+    entry->offset = c3e_archive_align(writer->position);
+    writer->position = entry->offset + table_size;
+
+    bool written = true;
+    for(uint32_t i = 0; written && i <= tensor->dimensions; i++) {
+        c3e_matrix* matrix = i < tensor->dimensions ? tensor->matrices[i] : NULL;
+
+        blocks[i].rows = matrix != NULL ? matrix->rows : tensor->data->size;
+        blocks[i].cols = matrix != NULL ? matrix->cols : 1;
+
+        written = c3e_archive_write_block(
+            writer,
+            matrix != NULL ? matrix->data : tensor->data->data,
+            (size_t) blocks[i].rows * blocks[i].cols,
+            dtype, codec, &blocks[i].offset, &blocks[i].size
+        );
+    }
+
+    written = written && c3e_archive_write(writer->fd, blocks, table_size, entry->offset);
+    free(blocks);
+
+    if(!written)
+        return false;
+
+    entry->size = writer->position - entry->offset;
+    writer->count++;
+
+    return true;
+}
+
+bool c3e_archive_finish(c3e_archive_writer* writer) {
+    c3e_assert(writer != NULL);
+
+    c3e_archive_header header;
+    memset(&header, 0, sizeof(header));
+
+    header.magic = C3E_ARCHIVE_MAGIC;
+    header.version = C3E_ARCHIVE_VERSION;
+    header.count = writer->count;
+    header.directory = c3e_archive_align(writer->position);
+
+    bool finished = c3e_archive_write(
+        writer->fd, writer->entries,
+        writer->count * sizeof(c3e_archive_entry),
+        header.directory
+    ) && c3e_archive_write(writer->fd, &header, sizeof(header), 0);
+
+    finished = close(writer->fd) == 0 && finished;
+    free(writer->entries);
+    free(writer);
+
+    return finished;
+}
+
+c3e_archive* c3e_archive_open(const char* path) {
+    c3e_assert(path != NULL);
+
+    c3e_archive* archive = (c3e_archive*) calloc(1, sizeof(c3e_archive));
+    if(archive == NULL)
+        return NULL;
+
+    struct stat status;
+    archive->fd = open(path, O_RDONLY);
+
+    if(archive->fd < 0 || fstat(archive->fd, &status) != 0 ||
+        status.st_size < C3E_ARCHIVE_HEADER_SIZE) {
+        if(archive->fd >= 0)
+            close(archive->fd);
+
+        free(archive);
+        return NULL;
+    }
+
+    archive->size = (size_t) status.st_size;
+    archive->map = (uint8_t*) mmap(NULL, archive->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, archive->fd, 0);
+
+    if(archive->map == MAP_FAILED) {
+        close(archive->fd);
+        free(archive);
+
+        return NULL;
+    }
+
+    c3e_archive_header header;
+    memcpy(&header, archive->map, sizeof(header));
+
+    bool valid = header.magic == C3E_ARCHIVE_MAGIC &&
+        header.version <= C3E_ARCHIVE_VERSION &&
+        header.directory % C3E_ARCHIVE_ALIGNMENT == 0 &&
+        c3e_archive_fits(archive, header.directory, (uint64_t) header.count * sizeof(c3e_archive_entry));
+
+    archive->entries = (c3e_archive_entry*) (archive->map + header.directory);
+    archive->count = valid ? header.count : 0;
+
+    for(uint32_t i = 0; valid && i < archive->count; i++) {
+        c3e_archive_entry* entry = &archive->entries[i];
+
+        valid = memchr(entry->name, '\0', C3E_ARCHIVE_NAME_SIZE) != NULL &&
+            entry->kind <= C3E_ARCHIVE_TENSOR &&
+            entry->dtype != C3E_DTYPE_NATIVE &&
+            c3e_dtype_size((c3e_dtype) entry->dtype) != 0 &&
+            entry->codec <= C3E_CODEC_XOR_LZ &&
+            entry->offset % C3E_ARCHIVE_ALIGNMENT == 0 &&
+            c3e_archive_fits(archive, entry->offset, entry->size);
+    }
+
+    archive->objects = (void**) calloc(archive->count + 1, sizeof(void*));
+    archive->buffers = (c3e_number**) calloc(archive->count + 1, sizeof(c3e_number*));
+
+    if(!valid || archive->objects == NULL || archive->buffers == NULL) {
+        archive->count = 0;
+        c3e_archive_close(archive);
+
+        return NULL;
+    }
+
+    return archive;
+}
+
+void c3e_archive_close(c3e_archive* archive) {
+    c3e_assert(archive != NULL);
+
+    for(uint32_t i = 0; i < archive->count; i++)
+        c3e_archive_release(archive, i);
+
+    munmap(archive->map, archive->size);
+    close(archive->fd);
+
+    free(archive->objects);
+    free(archive->buffers);
+    free(archive);
+}
+
+c3e_archive_entry* c3e_archive_find(c3e_archive* archive, const char* name) {
+    c3e_assert(archive != NULL);
+    c3e_assert(name != NULL);
+
+    for(uint32_t i = 0; i < archive->count; i++)
+        if(strcmp(archive->entries[i].name, name) == 0)
+            return &archive->entries[i];
+
+    return NULL;
+}
+
+c3e_matrix* c3e_archive_matrix(c3e_archive* archive, const char* name) {
+    int64_t index = c3e_archive_index(archive, name, C3E_ARCHIVE_MATRIX);
+
+    if(index < 0)
+        return NULL;
+    else if(archive->objects[index] != NULL)
+        return (c3e_matrix*) archive->objects[index];
+
+    c3e_archive_entry* entry = &archive->entries[index];
+    size_t count = (size_t) entry->rows * entry->cols;
+    c3e_matrix* matrix = (c3e_matrix*) malloc(sizeof(c3e_matrix));
+
+    if(matrix == NULL)
+        return NULL;
+
+    c3e_number* target = c3e_archive_reserve(archive, (uint32_t) index, count);
+    matrix->rows = entry->rows;
+    matrix->cols = entry->cols;
+    matrix->data = c3e_archive_elements(archive, entry, entry->offset, entry->size, count, target);
+
+    archive->objects[index] = matrix;
+    if(matrix->data == NULL) {
+        c3e_archive_release(archive, (uint32_t) index);
+        return NULL;
+    }
+
+    return matrix;
+}
+
+c3e_vector* c3e_archive_vector(c3e_archive* archive, const char* name) {
+    int64_t index = c3e_archive_index(archive, name, C3E_ARCHIVE_VECTOR);
+
+    if(index < 0)
+        return NULL;
+    else if(archive->objects[index] != NULL)
+        return (c3e_vector*) archive->objects[index];
+
+    c3e_archive_entry* entry = &archive->entries[index];
+    c3e_vector* vector = (c3e_vector*) malloc(sizeof(c3e_vector));
+
+    if(vector == NULL)
+        return NULL;
+
+    c3e_number* target = c3e_archive_reserve(archive, (uint32_t) index, entry->rows);
+    vector->size = entry->rows;
+    vector->data = c3e_archive_elements(archive, entry, entry->offset, entry->size, entry->rows, target);
+
+    archive->objects[index] = vector;
+    if(vector->data == NULL) {
+        c3e_archive_release(archive, (uint32_t) index);
+        return NULL;
+    }
+
+    return vector;
+}
+
+c3e_tensor* c3e_archive_tensor(c3e_archive* archive, const char* name) {
+    int64_t index = c3e_archive_index(archive, name, C3E_ARCHIVE_TENSOR);
+
+    if(index < 0)
+        return NULL;
+    else if(archive->objects[index] != NULL)
+        return (c3e_tensor*) archive->objects[index];
+
+    c3e_archive_entry* entry = &archive->entries[index];
+    uint32_t dimensions = entry->rows;
+    uint64_t table_size = ((uint64_t) dimensions + 1) * sizeof(c3e_archive_block);
+
+    if(table_size > entry->size)
+        return NULL;
+
+    c3e_archive_block* blocks = (c3e_archive_block*) (archive->map + entry->offset);
+    size_t total = 0;
+
+    for(uint32_t i = 0; i <= dimensions; i++)
+        total += (size_t) blocks[i].rows * blocks[i].cols;
+
+    if(blocks[dimensions].cols != 1 || blocks[dimensions].rows != entry->dimension_size)
+        return NULL;
+
+    c3e_tensor* tensor = (c3e_tensor*) calloc(1, sizeof(c3e_tensor));
+    if(tensor == NULL)
+        return NULL;
+
+    archive->objects[index] = tensor;
+    tensor->dimensions = dimensions;
+    tensor->dimension_size = entry->dimension_size;
+    tensor->matrices = (c3e_matrix**) calloc(dimensions, sizeof(c3e_matrix*));
+    tensor->data = (c3e_vector*) malloc(sizeof(c3e_vector));
+
+    c3e_number* target = c3e_archive_reserve(archive, (uint32_t) index, total);
+    bool loaded = tensor->matrices != NULL && tensor->data != NULL &&
+        (target != NULL || c3e_archive_mappable(entry));
+
+    for(uint32_t i = 0; loaded && i <= dimensions; i++) {
+        size_t count = (size_t) blocks[i].rows * blocks[i].cols;
+        c3e_number* data = c3e_archive_elements(archive, entry, blocks[i].offset, blocks[i].size, count, target);
+
+        if(target != NULL)
+            target += count;
+
+        if(data == NULL)
+            loaded = false;
+        else if(i == dimensions) {
+            tensor->data->size = blocks[i].rows;
+            tensor->data->data = data;
+        }
+        else if((tensor->matrices[i] = (c3e_matrix*) malloc(sizeof(c3e_matrix))) != NULL) {
+            tensor->matrices[i]->rows = blocks[i].rows;
+            tensor->matrices[i]->cols = blocks[i].cols;
+            tensor->matrices[i]->data = data;
+        }
+        else loaded = false;
+    }
+
+    if(!loaded) {
+        c3e_archive_release(archive, (uint32_t) index);
+        return NULL;
+    }
+
+    return tensor;
+}
+
+bool c3e_socket_send_archive_entry(c3e_socket* socket, c3e_archive* archive, const char* name) {
+    c3e_archive_entry* entry = c3e_archive_find(archive, name);
+
+    if(entry == NULL || entry->kind == C3E_ARCHIVE_TENSOR || entry->codec != C3E_CODEC_NONE ||
+        entry->size != (uint64_t) entry->rows * entry->cols * c3e_dtype_size((c3e_dtype) entry->dtype))
+        return false;
+
+    return c3e_socket_send_file_matrix(
+        socket, archive->fd, entry->offset,
+        entry->rows, entry->cols,
+        (c3e_dtype) entry->dtype
+    );
+}
\ No newline at end of file
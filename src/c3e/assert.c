@@ -16,16 +16,21 @@
  */
 
 #include <c3e/assert.h>
+#include <c3e/context.h>
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-static void (*assert_handler)(const char* filename, int line) = NULL;
-
 void c3e_assert(bool condition) {
     if(!condition) {
-        if(assert_handler)
-            assert_handler(__FILE__, __LINE__);
+        c3e_context* context = c3e_context_current();
+
+        context->counters.assertions++;
+        context->error = EINVAL;
+
+        if(context->settings.assert_handler)
+            context->settings.assert_handler(__FILE__, __LINE__);
         else {
             char message[256];
             snprintf(
@@ -40,13 +45,13 @@ void c3e_assert(bool condition) {
 }
 
 void c3e_assert_handler(void (*handler)(const char* filename, int line)) {
-    assert_handler = handler;
+    c3e_context_current()->settings.assert_handler = handler;
 }
 
 void c3e_assert_remove_handler() {
-    assert_handler = NULL;
+    c3e_context_current()->settings.assert_handler = NULL;
 }
 
 bool c3e_assert_has_handler() {
-    return assert_handler != NULL;
+    return c3e_context_current()->settings.assert_handler != NULL;
 }
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/checkpoint.h>
+#include <c3e/matrix.h>
+#include <c3e/tensor.h>
+#include <c3e/vector.h>
+
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static bool c3e_checkpoint_push(c3e_checkpoint* checkpoint, const char* name, c3e_archive_kind kind, void* object) {
+    if(object == NULL)
+        return false;
+
+    if(checkpoint->count == checkpoint->capacity) {
+        uint32_t capacity = checkpoint->capacity == 0 ? 16 : checkpoint->capacity * 2;
+        c3e_checkpoint_entry* entries = (c3e_checkpoint_entry*) realloc(
+            checkpoint->entries,
+            capacity * sizeof(c3e_checkpoint_entry)
+        );
+
+        if(entries == NULL)
+            return false;
+
+        checkpoint->entries = entries;
+        checkpoint->capacity = capacity;
+    }
+
+    c3e_checkpoint_entry* entry = &checkpoint->entries[checkpoint->count++];
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    entry->kind = kind;
+    entry->object = object;
+
+    return true;
+}
+
+static void c3e_checkpoint_release(c3e_checkpoint_entry* entry) {
+    switch(entry->kind) {
+        case C3E_ARCHIVE_MATRIX:
+            c3e_matrix_free((c3e_matrix*) entry->object);
+            break;
+
+        case C3E_ARCHIVE_VECTOR:
+            c3e_vector_free((c3e_vector*) entry->object);
+            break;
+
+        case C3E_ARCHIVE_TENSOR:
+            c3e_tensor_free((c3e_tensor*) entry->object);
+            break;
+    }
+}
+
+static bool c3e_checkpoint_sync(const char* path, bool directory) {
+    int fd = open(path, directory ? O_RDONLY | O_DIRECTORY : O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    bool synced = fsync(fd) == 0;
+    if(synced && !directory)
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+
+    close(fd);
+    return synced;
+}
+
+static bool c3e_checkpoint_write(c3e_checkpoint* checkpoint, const char* temporary) {
+    c3e_archive_writer* writer = c3e_archive_create(temporary);
+    if(writer == NULL)
+        return false;
+
+    bool written = true;
+    for(uint32_t i = 0; written && i < checkpoint->count; i++) {
+        c3e_checkpoint_entry* entry = &checkpoint->entries[i];
+
+        switch(entry->kind) {
+            case C3E_ARCHIVE_MATRIX:
+                written = c3e_archive_put_matrix(writer, entry->name, (c3e_matrix*) entry->object, checkpoint->dtype, C3E_CODEC_NONE);
+                break;
+
+            case C3E_ARCHIVE_VECTOR:
+                written = c3e_archive_put_vector(writer, entry->name, (c3e_vector*) entry->object, checkpoint->dtype, C3E_CODEC_NONE);
+                break;
+
+            case C3E_ARCHIVE_TENSOR:
+                written = c3e_archive_put_tensor(writer, entry->name, (c3e_tensor*) entry->object, checkpoint->dtype, C3E_CODEC_NONE);
+                break;
+        }
+
+        c3e_checkpoint_release(entry);
+        entry->object = NULL;
+    }
+
+    return c3e_archive_finish(writer) && written &&
+        c3e_checkpoint_sync(temporary, false);
+}
+
+static void* c3e_checkpoint_run(void* argument) {
+    c3e_checkpoint* checkpoint = (c3e_checkpoint*) argument;
+    c3e_context_current()->settings = checkpoint->settings;
+
+    size_t length = strlen(checkpoint->path);
+    char* temporary = (char*) malloc(length + 5);
+    char* directory = strdup(checkpoint->path);
+
+    checkpoint->success = false;
+    if(temporary != NULL && directory != NULL) {
+        snprintf(temporary, length + 5, "%s.tmp", checkpoint->path);
+
+        if(c3e_checkpoint_write(checkpoint, temporary) &&
+            rename(temporary, checkpoint->path) == 0)
+            checkpoint->success = c3e_checkpoint_sync(dirname(directory), true);
+        else unlink(temporary);
+    }
+
+    free(temporary);
+    free(directory);
+
+    if(checkpoint->callback != NULL)
+        checkpoint->callback(checkpoint->path, checkpoint->success, checkpoint->context);
+    return NULL;
+}
+
+c3e_checkpoint* c3e_checkpoint_begin(const char* path, c3e_dtype dtype) {
+    c3e_assert(path != NULL);
+    c3e_assert(c3e_dtype_size(dtype) != 0);
+
+    c3e_checkpoint* checkpoint = (c3e_checkpoint*) calloc(1, sizeof(c3e_checkpoint));
+    if(checkpoint == NULL)
+        return NULL;
+
+    checkpoint->path = strdup(path);
+    checkpoint->dtype = dtype;
+
+    if(checkpoint->path == NULL) {
+        free(checkpoint);
+        return NULL;
+    }
+
+    return checkpoint;
+}
+
+bool c3e_checkpoint_add_matrix(c3e_checkpoint* checkpoint, const char* name, c3e_matrix* matrix) {
+    c3e_assert(checkpoint != NULL && !checkpoint->committed);
+    c3e_assert(name != NULL && strlen(name) < C3E_ARCHIVE_NAME_SIZE);
+    c3e_assert(matrix != NULL);
+
+    c3e_matrix* copy = c3e_matrix_init(matrix->rows, matrix->cols);
+    if(copy != NULL)
+        memcpy(copy->data, matrix->data, (size_t) matrix->rows * matrix->cols * sizeof(c3e_number));
+
+    if(!c3e_checkpoint_push(checkpoint, name, C3E_ARCHIVE_MATRIX, copy)) {
+        if(copy != NULL)
+            c3e_matrix_free(copy);
+        return false;
+    }
+
+    return true;
+}
+
+bool c3e_checkpoint_add_vector(c3e_checkpoint* checkpoint, const char* name, c3e_vector* vector) {
+    c3e_assert(checkpoint != NULL && !checkpoint->committed);
+    c3e_assert(name != NULL && strlen(name) < C3E_ARCHIVE_NAME_SIZE);
+    c3e_assert(vector != NULL);
+
+    c3e_vector* copy = c3e_vector_init(vector->size);
+    if(copy != NULL)
+        memcpy(copy->data, vector->data, vector->size * sizeof(c3e_number));
+
+    if(!c3e_checkpoint_push(checkpoint, name, C3E_ARCHIVE_VECTOR, copy)) {
+        if(copy != NULL)
+            c3e_vector_free(copy);
+        return false;
+    }
+
+    return true;
+}
+
+bool c3e_checkpoint_add_tensor(c3e_checkpoint* checkpoint, const char* name, c3e_tensor* tensor) {
+    c3e_assert(checkpoint != NULL && !checkpoint->committed);
+    c3e_assert(name != NULL && strlen(name) < C3E_ARCHIVE_NAME_SIZE);
+    c3e_assert(tensor != NULL);
+
+    c3e_tensor* copy = c3e_tensor_copy(tensor);
+    if(!c3e_checkpoint_push(checkpoint, name, C3E_ARCHIVE_TENSOR, copy)) {
+        if(copy != NULL)
+            c3e_tensor_free(copy);
+        return false;
+    }
+
+    return true;
+}
+
+bool c3e_checkpoint_commit(c3e_checkpoint* checkpoint, c3e_checkpoint_callback callback, void* context) {
+    c3e_assert(checkpoint != NULL && !checkpoint->committed);
+
+    checkpoint->callback = callback;
+    checkpoint->context = context;
+    checkpoint->settings = c3e_context_current()->settings;
+    checkpoint->committed = pthread_create(
+        &checkpoint->thread, NULL,
+        c3e_checkpoint_run, checkpoint
+    ) == 0;
+
+    return checkpoint->committed;
+}
+
+bool c3e_checkpoint_wait(c3e_checkpoint* checkpoint) {
+    c3e_assert(checkpoint != NULL);
+
+    bool success = false;
+    if(checkpoint->committed) {
+        pthread_join(checkpoint->thread, NULL);
+        success = checkpoint->success;
+    }
+
+    for(uint32_t i = 0; i < checkpoint->count; i++)
+        if(checkpoint->entries[i].object != NULL)
+            c3e_checkpoint_release(&checkpoint->entries[i]);
+
+    free(checkpoint->entries);
+    free(checkpoint->path);
+    free(checkpoint);
+
+    return success;
+}
\ No newline at end of file
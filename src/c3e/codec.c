@@ -0,0 +1,539 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/codec.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define C3E_LZ_HASH_BITS    14
+#define C3E_LZ_MIN_MATCH    6
+#define C3E_LZ_SKIP_SHIFT   5
+
+#define C3E_CODEC_MODE_STORED   0
+#define C3E_CODEC_MODE_PLANES   2
+
+#define C3E_CODEC_PLANE_CONSTANT    0
+#define C3E_CODEC_PLANE_RAW         1
+#define C3E_CODEC_PLANE_LZ          2
+
+typedef struct {
+    uint8_t codec;
+    uint8_t element_size;
+    uint8_t mode;
+    uint8_t reserved;
+    uint32_t body_size;
+    uint64_t count;
+} c3e_codec_header;
+
+static inline uint32_t c3e_lz_hash(const uint8_t* data) {
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+
+    return (word * 2654435761u) >> (32 - C3E_LZ_HASH_BITS);
+}
+
+static inline bool c3e_lz_put_varint(uint8_t* out, size_t capacity, size_t* position, uint64_t value) {
+    do {
+        if(*position >= capacity)
+            return false;
+
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+
+        out[(*position)++] = byte | (value ? 0x80 : 0);
+    } while(value);
+
+    return true;
+}
+
+static inline bool c3e_lz_get_varint(const uint8_t* in, size_t size, size_t* position, uint64_t* value) {
+    *value = 0;
+
+    for(int shift = 0; shift < 64; shift += 7) {
+        if(*position >= size)
+            return false;
+
+        uint8_t byte = in[(*position)++];
+        *value |= (uint64_t) (byte & 0x7F) << shift;
+
+        if(!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+static inline bool c3e_lz_put_literals(uint8_t* out, size_t capacity, size_t* position, const uint8_t* literals, size_t length) {
+    if(!c3e_lz_put_varint(out, capacity, position, length) ||
+        *position + length > capacity)
+        return false;
+
+    memcpy(out + *position, literals, length);
+    *position += length;
+
+    return true;
+}
+
+static inline size_t c3e_lz_extend(const uint8_t* match, const uint8_t* in, size_t limit) {
+    size_t length = 0;
+
+    while(length + sizeof(uint64_t) <= limit) {
+        uint64_t left, right;
+
+        memcpy(&left, match + length, sizeof(left));
+        memcpy(&right, in + length, sizeof(right));
+
+        if(left != right)
+            break;
+        length += sizeof(uint64_t);
+    }
+
+    while(length < limit && match[length] == in[length])
+        length++;
+
+    return length;
+}
+
+static size_t c3e_lz_compress(const uint8_t* in, size_t size, uint8_t* out, size_t capacity, uint32_t* table) {
+    memset(table, 0, ((size_t) 1 << C3E_LZ_HASH_BITS) * sizeof(uint32_t));
+
+    size_t position = 0, anchor = 0, i = 0, misses = 0;
+    while(i + C3E_LZ_MIN_MATCH <= size) {
+        uint32_t hash = c3e_lz_hash(in + i);
+        size_t candidate = table[hash];
+        table[hash] = (uint32_t) (i + 1);
+
+        if(candidate == 0 ||
+            memcmp(in + candidate - 1, in + i, C3E_LZ_MIN_MATCH) != 0) {
+            i += 1 + (misses++ >> C3E_LZ_SKIP_SHIFT);
+            continue;
+        }
+
+        candidate--;
+        misses = 0;
+
+        size_t length = C3E_LZ_MIN_MATCH + c3e_lz_extend(
+            in + candidate + C3E_LZ_MIN_MATCH,
+            in + i + C3E_LZ_MIN_MATCH,
+            size - i - C3E_LZ_MIN_MATCH
+        );
+
+        if(!c3e_lz_put_literals(out, capacity, &position, in + anchor, i - anchor) ||
+            !c3e_lz_put_varint(out, capacity, &position, length - C3E_LZ_MIN_MATCH) ||
+            !c3e_lz_put_varint(out, capacity, &position, i - candidate))
+            return 0;
+
+        i += length;
+        anchor = i;
+    }
+
+    if(!c3e_lz_put_literals(out, capacity, &position, in + anchor, size - anchor))
+        return 0;
+
+    return position;
+}
+
+static bool c3e_lz_decompress(const uint8_t* in, size_t size, uint8_t* out, size_t out_size) {
+    size_t position = 0, written = 0;
+
+    while(true) {
+        uint64_t literals, length, offset;
+        if(!c3e_lz_get_varint(in, size, &position, &literals) ||
+            literals > size - position ||
+            literals > out_size - written)
+            return false;
+
+        memcpy(out + written, in + position, literals);
+        position += literals;
+        written += literals;
+
+        if(written == out_size)
+            return position == size;
+
+        if(!c3e_lz_get_varint(in, size, &position, &length) ||
+            !c3e_lz_get_varint(in, size, &position, &offset))
+            return false;
+
+        length += C3E_LZ_MIN_MATCH;
+        if(offset == 0 || offset > written || length > out_size - written)
+            return false;
+
+        if(offset == 1)
+            memset(out + written, out[written - 1], length);
+        else if(offset >= length)
+            memcpy(out + written, out + written - offset, length);
+        else for(uint64_t i = 0; i < length; i++)
+            out[written + i] = out[written + i - offset];
+
+        written += length;
+    }
+}
+
+static size_t c3e_codec_encode_planes(const c3e_number* data, size_t count, uint8_t* out, size_t limit, uint8_t* planes, uint32_t* table) {
+    const size_t width = sizeof(c3e_number);
+    const uint8_t* bytes = (const uint8_t*) data;
+    size_t deltas = count - 1, position = 2 * width;
+
+    if(position > limit)
+        return 0;
+
+    for(size_t i = 0; i < deltas; i++)
+        for(size_t b = 0; b < width; b++)
+            planes[b * deltas + i] = bytes[(i + 1) * width + b] ^ bytes[i * width + b];
+
+    memcpy(out, data, width);
+    uint8_t* kinds = out + width;
+
+    for(size_t b = 0; b < width; b++) {
+        const uint8_t* plane = planes + b * deltas;
+
+        if(memcmp(plane, plane + 1, deltas - 1) == 0) {
+            if(position + 1 > limit)
+                return 0;
+
+            kinds[b] = C3E_CODEC_PLANE_CONSTANT;
+            out[position++] = plane[0];
+            continue;
+        }
+
+        size_t packed = 0;
+        if(position + sizeof(uint32_t) < limit)
+            packed = c3e_lz_compress(
+                plane, deltas, out + position + sizeof(uint32_t),
+                limit - position - sizeof(uint32_t) < deltas ?
+                    limit - position - sizeof(uint32_t) : deltas,
+                table
+            );
+
+        if(packed != 0 && packed + sizeof(uint32_t) < deltas) {
+            uint32_t length = (uint32_t) packed;
+
+            kinds[b] = C3E_CODEC_PLANE_LZ;
+            memcpy(out + position, &length, sizeof(length));
+            position += sizeof(length) + packed;
+        }
+        else if(position + deltas > limit)
+            return 0;
+        else {
+            kinds[b] = C3E_CODEC_PLANE_RAW;
+            memcpy(out + position, plane, deltas);
+            position += deltas;
+        }
+    }
+
+    return position;
+}
+
+static bool c3e_codec_decode_planes(const uint8_t* body, size_t size, c3e_number* out, size_t count, uint8_t* planes) {
+    const size_t width = sizeof(c3e_number);
+    uint8_t* bytes = (uint8_t*) out;
+    size_t deltas = count - 1, position = 2 * width;
+    const uint8_t* sources[sizeof(c3e_number)];
+
+    if(size < position)
+        return false;
+
+    memcpy(out, body, width);
+    const uint8_t* kinds = body + width;
+
+    for(size_t b = 0; b < width; b++) {
+        uint8_t* plane = planes + b * deltas;
+        sources[b] = plane;
+
+        if(kinds[b] == C3E_CODEC_PLANE_CONSTANT) {
+            if(position >= size)
+                return false;
+
+            memset(plane, body[position++], deltas);
+        }
+        else if(kinds[b] == C3E_CODEC_PLANE_RAW) {
+            if(deltas > size - position)
+                return false;
+
+            sources[b] = body + position;
+            position += deltas;
+        }
+        else if(kinds[b] == C3E_CODEC_PLANE_LZ) {
+            uint32_t length;
+            if(size - position < sizeof(length))
+                return false;
+
+            memcpy(&length, body + position, sizeof(length));
+            position += sizeof(length);
+
+            if(length > size - position ||
+                !c3e_lz_decompress(body + position, length, plane, deltas))
+                return false;
+            position += length;
+        }
+        else return false;
+    }
+
+    uint8_t previous[sizeof(c3e_number)];
+    memcpy(previous, out, width);
+
+    for(size_t i = 0; i < deltas; i++) {
+        for(size_t b = 0; b < width; b++)
+            previous[b] ^= sources[b][i];
+
+        memcpy(bytes + (i + 1) * width, previous, width);
+    }
+
+    return position == size;
+}
+
+static size_t c3e_codec_encode_block(c3e_codec codec, const c3e_number* data, size_t count, uint8_t* out, size_t capacity, uint8_t* planes, uint32_t* table) {
+    size_t raw_size = count * sizeof(c3e_number);
+    if(capacity < C3E_CODEC_HEADER_SIZE)
+        return 0;
+
+    c3e_codec_header header = {0};
+    header.codec = (uint8_t) codec;
+    header.element_size = sizeof(c3e_number);
+    header.mode = C3E_CODEC_MODE_STORED;
+    header.count = count;
+
+    uint8_t* body = out + C3E_CODEC_HEADER_SIZE;
+    size_t body_capacity = capacity - C3E_CODEC_HEADER_SIZE;
+    size_t body_size = 0;
+
+    if(planes != NULL && count > 1)
+        body_size = c3e_codec_encode_planes(
+            data, count, body,
+            raw_size - 1 < body_capacity ? raw_size - 1 : body_capacity,
+            planes, table
+        );
+
+    if(body_size != 0)
+        header.mode = C3E_CODEC_MODE_PLANES;
+    else if(raw_size > body_capacity)
+        return 0;
+    else {
+        memcpy(body, data, raw_size);
+        body_size = raw_size;
+    }
+
+    header.body_size = (uint32_t) body_size;
+    memcpy(out, &header, sizeof(header));
+
+    return C3E_CODEC_HEADER_SIZE + body_size;
+}
+
+size_t c3e_codec_bound(c3e_codec codec, size_t count) {
+    size_t blocks = count == 0 ? 1 : (count + C3E_CODEC_BLOCK - 1) / C3E_CODEC_BLOCK;
+    return blocks * C3E_CODEC_HEADER_SIZE + count * sizeof(c3e_number);
+}
+
+size_t c3e_codec_encode(c3e_codec codec, const c3e_number* data, size_t count, void* out, size_t capacity) {
+    c3e_assert(data != NULL || count == 0);
+    c3e_assert(out != NULL);
+
+    uint8_t* planes = NULL;
+    uint32_t* table = NULL;
+
+    if(codec == C3E_CODEC_XOR_LZ && count > 1) {
+        planes = (uint8_t*) malloc((count < C3E_CODEC_BLOCK ? count : C3E_CODEC_BLOCK) * sizeof(c3e_number));
+        table = (uint32_t*) malloc(((size_t) 1 << C3E_LZ_HASH_BITS) * sizeof(uint32_t));
+
+        if(planes == NULL || table == NULL) {
+            free(planes);
+            planes = NULL;
+        }
+    }
+
+    size_t position = 0, first = 0;
+    do {
+        size_t length = count - first < C3E_CODEC_BLOCK ? count - first : C3E_CODEC_BLOCK;
+        size_t written = c3e_codec_encode_block(
+            codec, data + first, length,
+            (uint8_t*) out + position, capacity - position,
+            planes, table
+        );
+
+        if(written == 0) {
+            position = 0;
+            break;
+        }
+
+        position += written;
+        first += length;
+    } while(first < count);
+
+    free(planes);
+    free(table);
+
+    return position;
+}
+
+bool c3e_codec_decode(const void* in, size_t size, c3e_number* out, size_t count) {
+    c3e_assert(in != NULL);
+    c3e_assert(out != NULL || count == 0);
+
+    const uint8_t* bytes = (const uint8_t*) in;
+    uint8_t* planes = NULL;
+    size_t position = 0, first = 0;
+    bool decoded = true;
+
+    do {
+        c3e_codec_header header;
+        if(size - position < C3E_CODEC_HEADER_SIZE) {
+            decoded = false;
+            break;
+        }
+
+        memcpy(&header, bytes + position, sizeof(header));
+        position += C3E_CODEC_HEADER_SIZE;
+
+        const uint8_t* body = bytes + position;
+        size_t length = (size_t) header.count;
+
+        if(header.element_size != sizeof(c3e_number) ||
+            header.body_size > size - position ||
+            length > count - first || length > C3E_CODEC_BLOCK ||
+            (length == 0 && count != 0)) {
+            decoded = false;
+            break;
+        }
+
+        if(header.mode == C3E_CODEC_MODE_STORED) {
+            decoded = header.body_size == length * sizeof(c3e_number);
+            if(decoded)
+                memcpy(out + first, body, header.body_size);
+        }
+        else if(header.mode == C3E_CODEC_MODE_PLANES && length > 1) {
+            if(planes == NULL)
+                planes = (uint8_t*) malloc((count < C3E_CODEC_BLOCK ? count : C3E_CODEC_BLOCK) * sizeof(c3e_number));
+
+            decoded = planes != NULL &&
+                c3e_codec_decode_planes(body, header.body_size, out + first, length, planes);
+        }
+        else decoded = false;
+
+        position += header.body_size;
+        first += length;
+    } while(decoded && first < count);
+
+    free(planes);
+    return decoded && position == size;
+}
+
+size_t c3e_dtype_size(c3e_dtype dtype) {
+    switch(dtype) {
+        case C3E_DTYPE_NATIVE:      return sizeof(c3e_number);
+        case C3E_DTYPE_FLOAT64:     return sizeof(double);
+        case C3E_DTYPE_FLOAT32:     return sizeof(float);
+        case C3E_DTYPE_BFLOAT16:    return sizeof(uint16_t);
+    }
+
+    return 0;
+}
+
+static inline uint16_t c3e_bfloat16_from(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t rounded = (bits + 0x7FFF + ((bits >> 16) & 1)) >> 16;
+    uint32_t quiet = (bits >> 16) | 0x40;
+
+    return (uint16_t) ((bits & 0x7FFFFFFF) > 0x7F800000 ? quiet : rounded);
+}
+
+static inline float c3e_bfloat16_to(uint16_t value) {
+    uint32_t bits = (uint32_t) value << 16;
+    float out;
+
+    memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+void c3e_dtype_narrow(c3e_dtype dtype, const c3e_number* in, void* out, size_t count) {
+    c3e_assert(in != NULL || count == 0);
+    c3e_assert(out != NULL || count == 0);
+
+    switch(dtype) {
+        case C3E_DTYPE_NATIVE:
+            memcpy(out, in, count * sizeof(c3e_number));
+            break;
+
+        case C3E_DTYPE_FLOAT64: {
+            double* values = (double*) out;
+
+            for(size_t i = 0; i < count; i++)
+                values[i] = (double) in[i];
+            break;
+        }
+
+        case C3E_DTYPE_FLOAT32: {
+            float* values = (float*) out;
+
+            for(size_t i = 0; i < count; i++)
+                values[i] = (float) in[i];
+            break;
+        }
+
+        case C3E_DTYPE_BFLOAT16: {
+            uint16_t* values = (uint16_t*) out;
+
+            for(size_t i = 0; i < count; i++)
+                values[i] = c3e_bfloat16_from((float) in[i]);
+            break;
+        }
+
+        default:
+            c3e_assert(false);
+    }
+}
+
+void c3e_dtype_widen(c3e_dtype dtype, const void* in, c3e_number* out, size_t count) {
+    c3e_assert(in != NULL || count == 0);
+    c3e_assert(out != NULL || count == 0);
+
+    switch(dtype) {
+        case C3E_DTYPE_NATIVE:
+            memcpy(out, in, count * sizeof(c3e_number));
+            break;
+
+        case C3E_DTYPE_FLOAT64: {
+            const double* values = (const double*) in;
+
+            for(size_t i = 0; i < count; i++)
+                out[i] = (c3e_number) values[i];
+            break;
+        }
+
+        case C3E_DTYPE_FLOAT32: {
+            const float* values = (const float*) in;
+
+            for(size_t i = 0; i < count; i++)
+                out[i] = (c3e_number) values[i];
+            break;
+        }
+
+        case C3E_DTYPE_BFLOAT16: {
+            const uint16_t* values = (const uint16_t*) in;
+
+            for(size_t i = 0; i < count; i++)
+                out[i] = (c3e_number) c3e_bfloat16_to(values[i]);
+            break;
+        }
+
+        default:
+            c3e_assert(false);
+    }
+}
\ No newline at end of file
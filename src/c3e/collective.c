@@ -0,0 +1,404 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/collective.h>
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define C3E_GROUP_NONE          UINT32_MAX
+#define C3E_GROUP_RETRIES       400
+#define C3E_GROUP_RETRY_DELAY   25000
+
+static inline bool c3e_group_would_block(void) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+static bool c3e_group_exchange(
+    c3e_group* group,
+    uint32_t to, const c3e_number* send_data, size_t send_count,
+    uint32_t from, c3e_number* recv_data, size_t recv_count,
+    bool reduce
+) {
+    const char* out = (const char*) send_data;
+    size_t out_left = to == C3E_GROUP_NONE ? 0 : send_count * sizeof(c3e_number);
+
+    size_t in_total = from == C3E_GROUP_NONE ? 0 : recv_count * sizeof(c3e_number);
+    size_t in_done = 0, chunk_start = 0;
+
+    int out_fd = to == C3E_GROUP_NONE ? -1 : group->peers[to].sockfd;
+    int in_fd = from == C3E_GROUP_NONE ? -1 : group->peers[from].sockfd;
+
+    while(out_left > 0 || in_done < in_total) {
+        struct pollfd fds[2];
+        int count = 0, out_index = -1, in_index = -1;
+
+        if(out_left > 0) {
+            fds[count].fd = out_fd;
+            fds[count].events = POLLOUT;
+            out_index = count++;
+        }
+
+        if(in_done < in_total) {
+            if(out_index >= 0 && in_fd == out_fd) {
+                fds[out_index].events |= POLLIN;
+                in_index = out_index;
+            }
+            else {
+                fds[count].fd = in_fd;
+                fds[count].events = POLLIN;
+                in_index = count++;
+            }
+        }
+
+        if(poll(fds, count, -1) < 0) {
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+
+        if(out_index >= 0 && fds[out_index].revents != 0 && out_left > 0) {
+            ssize_t sent = send(out_fd, out, out_left, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+            if(sent < 0 && !c3e_group_would_block())
+                return false;
+            else if(sent > 0) {
+                out += sent;
+                out_left -= (size_t) sent;
+            }
+        }
+
+        if(in_index >= 0 && (fds[in_index].revents & ~POLLOUT) != 0) {
+            size_t chunk_end = chunk_start + C3E_COLLECTIVE_CHUNK * sizeof(c3e_number);
+            if(chunk_end > in_total)
+                chunk_end = in_total;
+
+            char* target = reduce ?
+                (char*) group->scratch + (in_done - chunk_start) :
+                (char*) recv_data + in_done;
+            ssize_t received = recv(in_fd, target, chunk_end - in_done, MSG_DONTWAIT);
+
+            if(received == 0 || (received < 0 && !c3e_group_would_block()))
+                return false;
+            else if(received > 0) {
+                in_done += (size_t) received;
+
+                if(in_done == chunk_end) {
+                    if(reduce) {
+                        c3e_number* sum = recv_data + chunk_start / sizeof(c3e_number);
+                        size_t length = (chunk_end - chunk_start) / sizeof(c3e_number);
+
+                        for(size_t i = 0; i < length; i++)
+                            sum[i] += group->scratch[i];
+                    }
+
+                    chunk_start = chunk_end;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+c3e_group* c3e_group_init(uint32_t rank, uint32_t size, const char** hostnames, int base_port) {
+    c3e_assert(size != 0);
+    c3e_assert(rank < size);
+    c3e_assert(hostnames != NULL);
+
+    c3e_group* group = (c3e_group*) malloc(sizeof(c3e_group));
+    if(group == NULL)
+        return NULL;
+
+    group->rank = rank;
+    group->size = size;
+    group->borrowed = false;
+    group->peers = (c3e_socket*) calloc(size, sizeof(c3e_socket));
+    group->scratch = (c3e_number*) malloc(C3E_COLLECTIVE_CHUNK * sizeof(c3e_number));
+
+    if(group->peers == NULL || group->scratch == NULL) {
+        free(group->peers);
+        free(group->scratch);
+        free(group);
+
+        return NULL;
+    }
+
+    for(uint32_t i = 0; i < size; i++)
+        group->peers[i].sockfd = -1;
+
+    c3e_socket server;
+    if(!c3e_socket_listen(&server, hostnames[rank], base_port + (int) rank, (int) size)) {
+        c3e_group_free(group);
+        return NULL;
+    }
+
+    bool connected = true;
+    for(uint32_t i = 0; connected && i < rank; i++) {
+        connected = false;
+
+        for(int attempt = 0; !connected && attempt < C3E_GROUP_RETRIES; attempt++)
+            if(!(connected = c3e_socket_connect(&group->peers[i], hostnames[i], base_port + (int) i))) {
+                group->peers[i].sockfd = -1;
+                usleep(C3E_GROUP_RETRY_DELAY);
+            }
+
+        connected = connected &&
+            c3e_socket_send_data(&group->peers[i], &rank, sizeof(rank));
+    }
+
+    for(uint32_t i = rank + 1; connected && i < size; i++) {
+        c3e_socket client;
+        uint32_t peer;
+
+        connected = c3e_socket_accept(&server, &client);
+        if(connected && (!c3e_socket_receive_data(&client, &peer, sizeof(peer)) ||
+            peer <= rank || peer >= size || group->peers[peer].sockfd >= 0)) {
+            c3e_socket_close(&client);
+            connected = false;
+        }
+        else if(connected)
+            group->peers[peer] = client;
+    }
+
+    c3e_socket_close(&server);
+    if(!connected) {
+        c3e_group_free(group);
+        return NULL;
+    }
+
+    int nodelay = 1;
+    for(uint32_t i = 0; i < size; i++)
+        if(group->peers[i].sockfd >= 0)
+            setsockopt(group->peers[i].sockfd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    return group;
+}
+
+void c3e_group_free(c3e_group* group) {
+    c3e_assert(group != NULL);
+
+    for(uint32_t i = 0; !group->borrowed && i < group->size; i++)
+        if(group->peers[i].sockfd >= 0)
+            c3e_socket_close(&group->peers[i]);
+
+    free(group->peers);
+    free(group->scratch);
+    free(group);
+}
+
+c3e_group* c3e_group_subset(c3e_group* group, const uint32_t* ranks, uint32_t count) {
+    c3e_assert(group != NULL);
+    c3e_assert(ranks != NULL && count != 0);
+
+    c3e_group* subset = (c3e_group*) malloc(sizeof(c3e_group));
+    if(subset == NULL)
+        return NULL;
+
+    subset->rank = UINT32_MAX;
+    subset->size = count;
+    subset->borrowed = true;
+    subset->peers = (c3e_socket*) malloc(count * sizeof(c3e_socket));
+    subset->scratch = (c3e_number*) malloc(C3E_COLLECTIVE_CHUNK * sizeof(c3e_number));
+
+    if(subset->peers == NULL || subset->scratch == NULL) {
+        c3e_group_free(subset);
+        return NULL;
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+        c3e_assert(ranks[i] < group->size);
+
+        subset->peers[i] = group->peers[ranks[i]];
+        if(ranks[i] == group->rank)
+            subset->rank = i;
+    }
+
+    c3e_assert(subset->rank != UINT32_MAX);
+    return subset;
+}
+
+void c3e_group_segment(c3e_group* group, size_t count, uint32_t index, size_t* offset, size_t* length) {
+    c3e_assert(group != NULL);
+    c3e_assert(index < group->size);
+
+    size_t base = count / group->size, extra = count % group->size;
+
+    *offset = index * base + (index < extra ? index : extra);
+    *length = base + (index < extra ? 1 : 0);
+}
+
+bool c3e_group_reduce_scatter(c3e_group* group, c3e_number* data, size_t count) {
+    c3e_assert(group != NULL);
+    c3e_assert(data != NULL || count == 0);
+
+    uint32_t size = group->size, rank = group->rank;
+    uint32_t next = (rank + 1) % size, prev = (rank + size - 1) % size;
+
+    for(uint32_t step = 0; step + 1 < size; step++) {
+        uint32_t send_index = (rank + 2 * size - step - 1) % size;
+        uint32_t recv_index = (rank + 2 * size - step - 2) % size;
+        size_t send_offset, send_length, recv_offset, recv_length;
+
+        c3e_group_segment(group, count, send_index, &send_offset, &send_length);
+        c3e_group_segment(group, count, recv_index, &recv_offset, &recv_length);
+
+        if(!c3e_group_exchange(
+            group,
+            next, data + send_offset, send_length,
+            prev, data + recv_offset, recv_length,
+            true
+        ))
+            return false;
+    }
+
+    return true;
+}
+
+bool c3e_group_all_gather(c3e_group* group, c3e_number* data, size_t count) {
+    c3e_assert(group != NULL);
+    c3e_assert(data != NULL || count == 0);
+
+    uint32_t size = group->size, rank = group->rank;
+    uint32_t next = (rank + 1) % size, prev = (rank + size - 1) % size;
+
+    for(uint32_t step = 0; step + 1 < size; step++) {
+        uint32_t send_index = (rank + size - step) % size;
+        uint32_t recv_index = (rank + 2 * size - step - 1) % size;
+        size_t send_offset, send_length, recv_offset, recv_length;
+
+        c3e_group_segment(group, count, send_index, &send_offset, &send_length);
+        c3e_group_segment(group, count, recv_index, &recv_offset, &recv_length);
+
+        if(!c3e_group_exchange(
+            group,
+            next, data + send_offset, send_length,
+            prev, data + recv_offset, recv_length,
+            false
+        ))
+            return false;
+    }
+
+    return true;
+}
+
+static bool c3e_group_tree_reduce(c3e_group* group, c3e_number* data, size_t count) {
+    uint32_t size = group->size, rank = group->rank;
+
+    for(size_t offset = 0; offset < count; offset += C3E_COLLECTIVE_CHUNK) {
+        size_t length = count - offset < C3E_COLLECTIVE_CHUNK ?
+            count - offset : C3E_COLLECTIVE_CHUNK;
+
+        for(uint32_t mask = 1; mask < size; mask <<= 1) {
+            if(rank & mask) {
+                if(!c3e_group_exchange(
+                    group,
+                    rank - mask, data + offset, length,
+                    C3E_GROUP_NONE, NULL, 0,
+                    false
+                ))
+                    return false;
+                break;
+            }
+            else if(rank + mask < size && !c3e_group_exchange(
+                group,
+                C3E_GROUP_NONE, NULL, 0,
+                rank + mask, data + offset, length,
+                true
+            ))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool c3e_group_broadcast(c3e_group* group, c3e_number* data, size_t count, uint32_t root, c3e_collective_algo algo) {
+    c3e_assert(group != NULL);
+    c3e_assert(data != NULL || count == 0);
+    c3e_assert(root < group->size);
+
+    uint32_t size = group->size;
+    uint32_t relative = (group->rank + size - root) % size;
+
+    for(size_t offset = 0; offset < count; offset += C3E_COLLECTIVE_CHUNK) {
+        size_t length = count - offset < C3E_COLLECTIVE_CHUNK ?
+            count - offset : C3E_COLLECTIVE_CHUNK;
+
+        if(algo == C3E_COLLECTIVE_RING) {
+            uint32_t from = relative == 0 ? C3E_GROUP_NONE : (group->rank + size - 1) % size;
+            uint32_t to = relative + 1 == size ? C3E_GROUP_NONE : (group->rank + 1) % size;
+
+            if(!c3e_group_exchange(group, C3E_GROUP_NONE, NULL, 0, from, data + offset, length, false) ||
+                !c3e_group_exchange(group, to, data + offset, length, C3E_GROUP_NONE, NULL, 0, false))
+                return false;
+            continue;
+        }
+
+        uint32_t mask = 1;
+        for(; mask < size; mask <<= 1)
+            if(relative & mask) {
+                if(!c3e_group_exchange(
+                    group,
+                    C3E_GROUP_NONE, NULL, 0,
+                    (relative - mask + root) % size, data + offset, length,
+                    false
+                ))
+                    return false;
+                break;
+            }
+
+        for(mask >>= 1; mask > 0; mask >>= 1)
+            if(relative + mask < size && !c3e_group_exchange(
+                group,
+                (relative + mask + root) % size, data + offset, length,
+                C3E_GROUP_NONE, NULL, 0,
+                false
+            ))
+                return false;
+    }
+
+    return true;
+}
+
+bool c3e_group_all_reduce(c3e_group* group, c3e_number* data, size_t count, c3e_collective_algo algo) {
+    c3e_assert(group != NULL);
+    c3e_assert(data != NULL || count == 0);
+
+    if(algo == C3E_COLLECTIVE_TREE)
+        return c3e_group_tree_reduce(group, data, count) &&
+            c3e_group_broadcast(group, data, count, 0, C3E_COLLECTIVE_TREE);
+
+    return c3e_group_reduce_scatter(group, data, count) &&
+        c3e_group_all_gather(group, data, count);
+}
+
+bool c3e_group_all_reduce_matrix(c3e_group* group, c3e_matrix* matrix, c3e_collective_algo algo) {
+    c3e_assert(matrix != NULL);
+    return c3e_group_all_reduce(group, matrix->data, (size_t) matrix->rows * matrix->cols, algo);
+}
+
+bool c3e_group_all_reduce_vector(c3e_group* group, c3e_vector* vector, c3e_collective_algo algo) {
+    c3e_assert(vector != NULL);
+    return c3e_group_all_reduce(group, vector->data, vector->size, algo);
+}
\ No newline at end of file
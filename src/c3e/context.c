@@ -0,0 +1,63 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/context.h>
+
+#include <string.h>
+
+static __thread c3e_context c3e_context_default;
+static __thread bool c3e_context_ready = false;
+static __thread c3e_context* c3e_context_active = NULL;
+
+static void c3e_context_reset(c3e_context* context) {
+    memset(context, 0, sizeof(c3e_context));
+    c3e_rng_init(&context->pseudo, 0, 0);
+}
+
+void c3e_context_init(c3e_context* context, uint64_t seed) {
+    c3e_context_reset(context);
+
+    c3e_rng_init(&context->rng, seed, 0);
+    context->seeded = true;
+}
+
+c3e_context* c3e_context_current(void) {
+    if(c3e_context_active != NULL)
+        return c3e_context_active;
+
+    if(!c3e_context_ready) {
+        c3e_context_reset(&c3e_context_default);
+        c3e_context_ready = true;
+    }
+
+    return &c3e_context_default;
+}
+
+c3e_context* c3e_context_use(c3e_context* context) {
+    c3e_context* previous = c3e_context_current();
+
+    c3e_context_active = context;
+    return previous;
+}
+
+int c3e_context_take_error(void) {
+    c3e_context* context = c3e_context_current();
+    int error = context->error;
+
+    context->error = 0;
+    return error;
+}
\ No newline at end of file
@@ -0,0 +1,497 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/csv.h>
+#include <c3e/matrix.h>
+#include <c3e/memory.h>
+#include <c3e/pool.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define C3E_CSV_CHUNK   65536
+#define C3E_CSV_BLOCK   65536
+#define C3E_CSV_WIDTH   32
+#define C3E_CSV_TOKEN   64
+
+#ifndef C3E_32BIT_NUMBER
+#define C3E_CSV_MANTISSA    (1ull << 53)
+#define C3E_CSV_EXPONENT    22
+#define C3E_CSV_PRECISION   15
+#define C3E_CSV_DIGITS      17
+#define c3e_csv_strtod      strtod
+#else
+#define C3E_CSV_MANTISSA    (1ull << 24)
+#define C3E_CSV_EXPONENT    10
+#define C3E_CSV_PRECISION   6
+#define C3E_CSV_DIGITS      9
+#define c3e_csv_strtod      strtof
+#endif
+
+typedef struct {
+    const char* begin;
+    const char* end;
+    char delimiter;
+    uint32_t cols;
+    uint64_t rows;
+    c3e_number* data;
+    bool failed;
+} c3e_csv_chunk;
+
+typedef struct {
+    c3e_matrix* matrix;
+    char delimiter;
+    uint32_t begin;
+    uint32_t end;
+    char* buffer;
+    size_t size;
+} c3e_csv_block;
+
+static const c3e_number c3e_csv_powers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static uint32_t c3e_csv_threads(uint32_t threads) {
+    return threads != 0 ? threads : c3e_pool_size();
+}
+
+static const char* c3e_csv_find(const char* cursor, const char* end, char character) {
+#ifdef __SSE2__
+    const __m128i pattern = _mm_set1_epi8(character);
+
+    for(; end - cursor >= 16; cursor += 16) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i*) cursor),
+            pattern
+        ));
+
+        if(mask != 0)
+            return cursor + __builtin_ctz((unsigned int) mask);
+    }
+#endif
+
+    while(cursor < end && *cursor != character)
+        cursor++;
+    return cursor;
+}
+
+static uint32_t c3e_csv_count(const char* cursor, const char* end, char character) {
+    uint32_t count = 0;
+
+#ifdef __SSE2__
+    const __m128i pattern = _mm_set1_epi8(character);
+
+    for(; end - cursor >= 16; cursor += 16)
+        count += (uint32_t) __builtin_popcount((unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i*) cursor),
+            pattern
+        )));
+#endif
+
+    for(; cursor < end; cursor++)
+        count += *cursor == character;
+    return count;
+}
+
+static inline bool c3e_csv_blank(const char* line, const char* end) {
+    return line == end || (end - line == 1 && *line == '\r');
+}
+
+static const char* c3e_csv_token(const char* cursor, const char* end, char delimiter, c3e_number* value) {
+    const char* stop = cursor;
+
+    while(stop < end && *stop != delimiter && *stop != '"' &&
+        *stop != ' ' && *stop != '\r')
+        stop++;
+
+    size_t length = (size_t) (stop - cursor);
+    if(length == 0) {
+        *value = NAN;
+        return stop;
+    }
+    else if(length >= C3E_CSV_TOKEN)
+        return NULL;
+
+    char token[C3E_CSV_TOKEN], *parsed;
+    memcpy(token, cursor, length);
+    token[length] = '\0';
+
+    *value = c3e_csv_strtod(token, &parsed);
+    return parsed == token + length ? stop : NULL;
+}
+
+static const char* c3e_csv_field(const char* cursor, const char* end, char delimiter, c3e_number* value) {
+    while(cursor < end && *cursor == ' ' && delimiter != ' ')
+        cursor++;
+
+    bool quoted = cursor < end && *cursor == '"';
+    if(quoted)
+        cursor++;
+
+    const char* start = cursor;
+    bool negative = false;
+
+    if(cursor < end && (*cursor == '-' || *cursor == '+'))
+        negative = *cursor++ == '-';
+
+    uint64_t mantissa = 0;
+    int64_t exponent = 0;
+    int digits = 0;
+    bool any = false, truncated = false;
+
+    for(; cursor < end && *cursor >= '0' && *cursor <= '9'; cursor++, any = true)
+        if(digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t) (*cursor - '0');
+            digits += mantissa != 0;
+        }
+        else {
+            exponent++;
+            truncated |= *cursor != '0';
+        }
+
+    if(cursor < end && *cursor == '.') {
+        for(cursor++; cursor < end && *cursor >= '0' && *cursor <= '9'; cursor++, any = true)
+            if(digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t) (*cursor - '0');
+                digits += mantissa != 0;
+                exponent--;
+            }
+            else truncated |= *cursor != '0';
+    }
+
+    if(any && cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+        const char* mark = cursor++;
+        bool minus = false;
+
+        if(cursor < end && (*cursor == '-' || *cursor == '+'))
+            minus = *cursor++ == '-';
+
+        if(cursor == end || *cursor < '0' || *cursor > '9')
+            cursor = mark;
+        else {
+            int64_t power = 0;
+
+            for(; cursor < end && *cursor >= '0' && *cursor <= '9'; cursor++)
+                if(power < 100000)
+                    power = power * 10 + (*cursor - '0');
+
+            exponent += minus ? -power : power;
+        }
+    }
+
+    if(any && !truncated && mantissa <= C3E_CSV_MANTISSA &&
+        exponent >= -C3E_CSV_EXPONENT && exponent <= C3E_CSV_EXPONENT) {
+        c3e_number number = (c3e_number) mantissa;
+
+        number = exponent < 0 ?
+            number / c3e_csv_powers[-exponent] :
+            number * c3e_csv_powers[exponent];
+        *value = negative ? -number : number;
+    }
+    else if((cursor = c3e_csv_token(start, end, delimiter, value)) == NULL)
+        return NULL;
+
+    if(quoted) {
+        if(cursor == end || *cursor != '"')
+            return NULL;
+        cursor++;
+    }
+
+    while(cursor < end && *cursor == ' ' && delimiter != ' ')
+        cursor++;
+    return cursor;
+}
+
+static bool c3e_csv_row(const char* cursor, const char* end, char delimiter, c3e_number* row, uint32_t cols) {
+    for(uint32_t col = 0; col < cols; col++) {
+        if((cursor = c3e_csv_field(cursor, end, delimiter, &row[col])) == NULL)
+            return false;
+
+        if(col + 1 < cols) {
+            if(cursor == end || *cursor != delimiter)
+                return false;
+            cursor++;
+        }
+    }
+
+    if(cursor < end && *cursor == '\r')
+        cursor++;
+    return cursor == end;
+}
+
+static void c3e_csv_count_rows(void* argument) {
+    c3e_csv_chunk* chunk = (c3e_csv_chunk*) argument;
+
+    for(const char* line = chunk->begin; line < chunk->end;) {
+        const char* end = c3e_csv_find(line, chunk->end, '\n');
+
+        chunk->rows += !c3e_csv_blank(line, end);
+        line = end + 1;
+    }
+}
+
+static void c3e_csv_parse_rows(void* argument) {
+    c3e_csv_chunk* chunk = (c3e_csv_chunk*) argument;
+    c3e_number* row = chunk->data;
+
+    for(const char* line = chunk->begin; !chunk->failed && line < chunk->end;) {
+        const char* end = c3e_csv_find(line, chunk->end, '\n');
+
+        if(!c3e_csv_blank(line, end)) {
+            chunk->failed = !c3e_csv_row(line, end, chunk->delimiter, row, chunk->cols);
+            row += chunk->cols;
+        }
+
+        line = end + 1;
+    }
+}
+
+static int c3e_csv_format(char* out, c3e_number value) {
+    if(value > -1e15 && value < 1e15 && value == (c3e_number) (int64_t) value &&
+        !(value == 0 && signbit(value))) {
+        int64_t integer = (int64_t) value;
+        uint64_t magnitude = integer < 0 ? (uint64_t) -integer : (uint64_t) integer;
+
+        char digits[20];
+        int count = 0, length = 0;
+
+        do digits[count++] = (char) ('0' + magnitude % 10);
+        while((magnitude /= 10) != 0);
+
+        if(integer < 0)
+            out[length++] = '-';
+
+        while(count > 0)
+            out[length++] = digits[--count];
+        return length;
+    }
+
+    for(int precision = C3E_CSV_PRECISION;; precision++) {
+        int length = snprintf(out, C3E_CSV_WIDTH, "%.*g", precision, (double) value);
+
+        if(precision >= C3E_CSV_DIGITS || c3e_csv_strtod(out, NULL) == value)
+            return length;
+    }
+}
+
+static void c3e_csv_format_rows(void* argument) {
+    c3e_csv_block* block = (c3e_csv_block*) argument;
+    c3e_matrix* matrix = block->matrix;
+    char* out = block->buffer;
+
+    for(uint32_t row = block->begin; row < block->end; row++) {
+        const c3e_number* values = matrix->data + (size_t) row * matrix->cols;
+
+        for(uint32_t col = 0; col < matrix->cols; col++) {
+            out += c3e_csv_format(out, values[col]);
+
+            if(col + 1 < matrix->cols)
+                *out++ = block->delimiter;
+        }
+
+        *out++ = '\n';
+    }
+
+    block->size = (size_t) (out - block->buffer);
+}
+
+static bool c3e_csv_put(int fd, const void* data, size_t size, uint64_t offset) {
+    const char* bytes = (const char*) data;
+
+    while(size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, (off_t) offset);
+
+        if(written < 0 && errno == EINTR)
+            continue;
+        else if(written <= 0)
+            return false;
+
+        bytes += written;
+        size -= (size_t) written;
+        offset += (uint64_t) written;
+    }
+
+    return true;
+}
+
+c3e_matrix* c3e_csv_read(const char* path, char delimiter, bool header, uint32_t threads) {
+    c3e_assert(path != NULL);
+    c3e_assert(delimiter != '\n' && delimiter != '\r' && delimiter != '"');
+
+    struct stat status;
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0)
+        return NULL;
+    else if(fstat(fd, &status) != 0 || status.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t) status.st_size;
+    char* text = (char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+    if(text == MAP_FAILED)
+        return NULL;
+
+    const char* end = text + size;
+    const char* body = text;
+
+    if(header && (body = c3e_csv_find(body, end, '\n')) < end)
+        body++;
+
+    const char* first = body;
+    const char* first_end = first;
+
+    while(first < end && c3e_csv_blank(first, first_end = c3e_csv_find(first, end, '\n')))
+        first = first_end + 1;
+
+    threads = c3e_csv_threads(threads);
+    if(first < end && threads > (size_t) (end - first) / C3E_CSV_CHUNK + 1)
+        threads = (uint32_t) ((size_t) (end - first) / C3E_CSV_CHUNK + 1);
+
+    c3e_matrix* matrix = NULL;
+    c3e_csv_chunk* chunks = first < end ?
+        (c3e_csv_chunk*) calloc(threads, sizeof(c3e_csv_chunk)) : NULL;
+
+    if(chunks != NULL) {
+        uint32_t cols = c3e_csv_count(first, first_end, delimiter) + 1;
+        const char* begin = first;
+
+        for(uint32_t i = 0; i < threads; i++) {
+            const char* split = i + 1 == threads ? end :
+                first + (size_t) (end - first) / threads * (i + 1);
+
+            if(split <= begin)
+                split = begin;
+            else if(split < end)
+                split = c3e_csv_find(split - 1, end, '\n') + 1;
+
+            if(split > end)
+                split = end;
+
+            chunks[i].begin = begin;
+            chunks[i].end = split;
+            chunks[i].delimiter = delimiter;
+            chunks[i].cols = cols;
+
+            begin = split;
+        }
+
+        c3e_parallel_invoke(c3e_csv_count_rows, chunks, sizeof(c3e_csv_chunk), threads);
+
+        uint64_t rows = 0;
+        for(uint32_t i = 0; i < threads; i++)
+            rows += chunks[i].rows;
+
+        if(rows <= UINT32_MAX && rows * cols <= SIZE_MAX / sizeof(c3e_number) &&
+            (matrix = (c3e_matrix*) malloc(sizeof(c3e_matrix))) != NULL) {
+            matrix->rows = (uint32_t) rows;
+            matrix->cols = cols;
+            matrix->data = (c3e_number*) c3e_memory_alloc((size_t) rows * cols * sizeof(c3e_number));
+
+            if(matrix->data == NULL) {
+                free(matrix);
+                matrix = NULL;
+            }
+        }
+
+        if(matrix != NULL) {
+            c3e_number* data = matrix->data;
+
+            for(uint32_t i = 0; i < threads; i++) {
+                chunks[i].data = data;
+                data += chunks[i].rows * cols;
+            }
+
+            c3e_parallel_invoke(c3e_csv_parse_rows, chunks, sizeof(c3e_csv_chunk), threads);
+
+            for(uint32_t i = 0; matrix != NULL && i < threads; i++)
+                if(chunks[i].failed) {
+                    c3e_matrix_free(matrix);
+                    matrix = NULL;
+                }
+        }
+    }
+
+    free(chunks);
+    munmap(text, size);
+
+    return matrix;
+}
+
+bool c3e_csv_write(const char* path, c3e_matrix* matrix, char delimiter, uint32_t threads) {
+    c3e_assert(path != NULL);
+    c3e_assert(matrix != NULL);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+        return false;
+
+    threads = c3e_csv_threads(threads);
+
+    uint32_t block_rows = C3E_CSV_BLOCK / (matrix->cols + 1) + 1;
+    c3e_csv_block* blocks = (c3e_csv_block*) calloc(threads, sizeof(c3e_csv_block));
+    bool written = blocks != NULL;
+
+    for(uint32_t i = 0; written && i < threads; i++) {
+        blocks[i].matrix = matrix;
+        blocks[i].delimiter = delimiter;
+        blocks[i].buffer = (char*) malloc((size_t) block_rows * ((size_t) matrix->cols * C3E_CSV_WIDTH + 1));
+
+        written = blocks[i].buffer != NULL;
+    }
+
+    uint64_t offset = 0;
+    for(uint32_t row = 0; written && row < matrix->rows;) {
+        uint32_t count = 0;
+
+        for(; count < threads && row < matrix->rows; count++) {
+            blocks[count].begin = row;
+            blocks[count].end = matrix->rows - row < block_rows ? matrix->rows : row + block_rows;
+
+            row = blocks[count].end;
+        }
+
+        c3e_parallel_invoke(c3e_csv_format_rows, blocks, sizeof(c3e_csv_block), count);
+
+        for(uint32_t i = 0; written && i < count; i++) {
+            written = c3e_csv_put(fd, blocks[i].buffer, blocks[i].size, offset);
+            offset += blocks[i].size;
+        }
+    }
+
+    for(uint32_t i = 0; blocks != NULL && i < threads; i++)
+        free(blocks[i].buffer);
+
+    free(blocks);
+    return close(fd) == 0 && written;
+}
\ No newline at end of file
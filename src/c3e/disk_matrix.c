@@ -0,0 +1,480 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/disk_matrix.h>
+#include <c3e/matrix.h>
+#include <c3e/vector.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t rows;
+    uint32_t cols;
+    uint8_t unused[48];
+} c3e_disk_header;
+
+typedef enum {
+    C3E_DISK_ADD,
+    C3E_DISK_SUB,
+    C3E_DISK_DOT,
+    C3E_DISK_SCALAR_ADD,
+    C3E_DISK_SCALAR_MUL
+} c3e_disk_op;
+
+typedef enum {
+    C3E_DISK_SUM,
+    C3E_DISK_MAX,
+    C3E_DISK_MIN
+} c3e_disk_reduction;
+
+static inline uint64_t c3e_disk_offset(c3e_disk_matrix* matrix, uint32_t row) {
+    return C3E_DISK_MATRIX_OFFSET + (uint64_t) row * matrix->cols * sizeof(c3e_number);
+}
+
+static uint32_t c3e_disk_chunk(c3e_disk_matrix* matrix, size_t budget, uint32_t windows) {
+    size_t row_size = (size_t) matrix->cols * sizeof(c3e_number);
+    size_t rows = budget / windows / row_size;
+
+    if(rows == 0)
+        rows = 1;
+    return rows < matrix->rows ? (uint32_t) rows : matrix->rows;
+}
+
+static void c3e_disk_prefetch(c3e_disk_matrix* matrix, uint32_t row, uint32_t count) {
+    if(row >= matrix->rows)
+        return;
+    else if(count > matrix->rows - row)
+        count = matrix->rows - row;
+
+    posix_fadvise(
+        matrix->fd,
+        (off_t) c3e_disk_offset(matrix, row),
+        (off_t) ((uint64_t) count * matrix->cols * sizeof(c3e_number)),
+        POSIX_FADV_WILLNEED
+    );
+}
+
+static bool c3e_disk_transfer(int fd, void* data, size_t size, uint64_t offset, bool writing) {
+    char* bytes = (char*) data;
+
+    while(size > 0) {
+        ssize_t done = writing ?
+            pwrite(fd, bytes, size, (off_t) offset) :
+            pread(fd, bytes, size, (off_t) offset);
+
+        if(done < 0 && errno == EINTR)
+            continue;
+        else if(done <= 0)
+            return false;
+
+        bytes += done;
+        size -= (size_t) done;
+        offset += (uint64_t) done;
+    }
+
+    return true;
+}
+
+static c3e_disk_matrix* c3e_disk_wrap(int fd, uint32_t rows, uint32_t cols, size_t budget) {
+    c3e_disk_matrix* matrix = (c3e_disk_matrix*) malloc(sizeof(c3e_disk_matrix));
+
+    if(matrix == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    matrix->fd = fd;
+    matrix->rows = rows;
+    matrix->cols = cols;
+    matrix->budget = budget == 0 ? C3E_DISK_MATRIX_BUDGET : budget;
+
+    return matrix;
+}
+
+static bool c3e_disk_stream(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject, c3e_number x, c3e_disk_op op) {
+    c3e_assert(out != NULL && matrix != NULL);
+    c3e_assert(out->rows == matrix->rows && out->cols == matrix->cols);
+    c3e_assert(subject == NULL || (subject->rows == matrix->rows && subject->cols == matrix->cols));
+
+    uint32_t chunk = c3e_disk_chunk(out, out->budget, subject == NULL ? 2 : 3);
+    bool done = true;
+
+    for(uint32_t row = 0; done && row < matrix->rows; row += chunk) {
+        uint32_t count = matrix->rows - row < chunk ? matrix->rows - row : chunk;
+        c3e_disk_window source, other, target;
+
+        c3e_disk_prefetch(matrix, row + count, chunk);
+        if(subject != NULL)
+            c3e_disk_prefetch(subject, row + count, chunk);
+
+        if(!c3e_disk_matrix_map(matrix, row, count, false, &source))
+            return false;
+        else if(subject != NULL && !c3e_disk_matrix_map(subject, row, count, false, &other)) {
+            c3e_disk_matrix_unmap(&source);
+            return false;
+        }
+
+        done = c3e_disk_matrix_map(out, row, count, true, &target);
+        if(done) {
+            size_t size = (size_t) count * matrix->cols;
+            c3e_number* a = source.view.data;
+            c3e_number* b = subject != NULL ? other.view.data : NULL;
+            c3e_number* c = target.view.data;
+
+            switch(op) {
+                case C3E_DISK_ADD:
+                    for(size_t i = 0; i < size; i++)
+                        c[i] = a[i] + b[i];
+                    break;
+
+                case C3E_DISK_SUB:
+                    for(size_t i = 0; i < size; i++)
+                        c[i] = a[i] - b[i];
+                    break;
+
+                case C3E_DISK_DOT:
+                    for(size_t i = 0; i < size; i++)
+                        c[i] = a[i] * b[i];
+                    break;
+
+                case C3E_DISK_SCALAR_ADD:
+                    for(size_t i = 0; i < size; i++)
+                        c[i] = a[i] + x;
+                    break;
+
+                case C3E_DISK_SCALAR_MUL:
+                    for(size_t i = 0; i < size; i++)
+                        c[i] = a[i] * x;
+                    break;
+            }
+
+            c3e_disk_matrix_unmap(&target);
+        }
+
+        if(subject != NULL)
+            c3e_disk_matrix_unmap(&other);
+        c3e_disk_matrix_unmap(&source);
+    }
+
+    return done;
+}
+
+static c3e_number c3e_disk_reduce(c3e_disk_matrix* matrix, c3e_disk_reduction reduction) {
+    c3e_assert(matrix != NULL);
+
+    uint32_t chunk = c3e_disk_chunk(matrix, matrix->budget, 1);
+    c3e_number result = reduction == C3E_DISK_SUM ? 0.0 :
+        reduction == C3E_DISK_MAX ? -INFINITY : INFINITY;
+
+    for(uint32_t row = 0; row < matrix->rows; row += chunk) {
+        uint32_t count = matrix->rows - row < chunk ? matrix->rows - row : chunk;
+        c3e_disk_window window;
+
+        c3e_disk_prefetch(matrix, row + count, chunk);
+        if(!c3e_disk_matrix_map(matrix, row, count, false, &window))
+            return NAN;
+
+        size_t size = (size_t) count * matrix->cols;
+        c3e_number* data = window.view.data;
+        c3e_number partial = 0.0;
+
+        if(reduction == C3E_DISK_SUM) {
+            for(size_t i = 0; i < size; i++)
+                partial += data[i];
+            result += partial;
+        }
+        else if(reduction == C3E_DISK_MAX) {
+            for(size_t i = 0; i < size; i++)
+                if(data[i] > result)
+                    result = data[i];
+        }
+        else for(size_t i = 0; i < size; i++)
+            if(data[i] < result)
+                result = data[i];
+
+        c3e_disk_matrix_unmap(&window);
+    }
+
+    return result;
+}
+
+c3e_disk_matrix* c3e_disk_matrix_create(const char* path, uint32_t rows, uint32_t cols, size_t budget) {
+    c3e_assert(path != NULL);
+    c3e_assert(rows != 0 && cols != 0);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+        return NULL;
+
+    c3e_disk_header header;
+    memset(&header, 0, sizeof(header));
+
+    header.magic = C3E_DISK_MATRIX_MAGIC;
+    header.version = 1;
+    header.rows = rows;
+    header.cols = cols;
+
+    uint64_t size = C3E_DISK_MATRIX_OFFSET + (uint64_t) rows * cols * sizeof(c3e_number);
+    if(ftruncate(fd, (off_t) size) != 0 ||
+        !c3e_disk_transfer(fd, &header, sizeof(header), 0, true)) {
+        close(fd);
+        return NULL;
+    }
+
+    return c3e_disk_wrap(fd, rows, cols, budget);
+}
+
+c3e_disk_matrix* c3e_disk_matrix_open(const char* path, size_t budget) {
+    c3e_assert(path != NULL);
+
+    int fd = open(path, O_RDWR);
+    if(fd < 0)
+        return NULL;
+
+    c3e_disk_header header;
+    struct stat status;
+
+    if(!c3e_disk_transfer(fd, &header, sizeof(header), 0, false) ||
+        fstat(fd, &status) != 0 ||
+        header.magic != C3E_DISK_MATRIX_MAGIC ||
+        header.rows == 0 || header.cols == 0 ||
+        (uint64_t) status.st_size < C3E_DISK_MATRIX_OFFSET +
+            (uint64_t) header.rows * header.cols * sizeof(c3e_number)) {
+        close(fd);
+        return NULL;
+    }
+
+    return c3e_disk_wrap(fd, header.rows, header.cols, budget);
+}
+
+void c3e_disk_matrix_close(c3e_disk_matrix* matrix) {
+    c3e_assert(matrix != NULL);
+
+    close(matrix->fd);
+    free(matrix);
+}
+
+bool c3e_disk_matrix_map(c3e_disk_matrix* matrix, uint32_t row, uint32_t count, bool writable, c3e_disk_window* window) {
+    c3e_assert(matrix != NULL && window != NULL);
+    c3e_assert(count != 0 && row < matrix->rows && count <= matrix->rows - row);
+
+    uint64_t offset = c3e_disk_offset(matrix, row);
+    uint64_t base = offset - offset % (uint64_t) sysconf(_SC_PAGESIZE);
+
+    window->length = (size_t) (offset - base) + (size_t) count * matrix->cols * sizeof(c3e_number);
+    window->writable = writable;
+    window->map = mmap(
+        NULL, window->length,
+        writable ? PROT_READ | PROT_WRITE : PROT_READ,
+        MAP_SHARED, matrix->fd, (off_t) base
+    );
+
+    if(window->map == MAP_FAILED)
+        return false;
+
+    madvise(window->map, window->length, MADV_SEQUENTIAL);
+
+    window->view.rows = count;
+    window->view.cols = matrix->cols;
+    window->view.data = (c3e_number*) ((uint8_t*) window->map + (offset - base));
+
+    return true;
+}
+
+void c3e_disk_matrix_unmap(c3e_disk_window* window) {
+    c3e_assert(window != NULL);
+
+    if(window->writable)
+        msync(window->map, window->length, MS_ASYNC);
+    munmap(window->map, window->length);
+}
+
+c3e_matrix* c3e_disk_matrix_read_rows(c3e_disk_matrix* matrix, uint32_t row, uint32_t count) {
+    c3e_assert(matrix != NULL);
+    c3e_assert(count != 0 && row < matrix->rows && count <= matrix->rows - row);
+
+    c3e_matrix* rows = c3e_matrix_init((int) count, (int) matrix->cols);
+    if(rows == NULL)
+        return NULL;
+
+    if(!c3e_disk_transfer(
+        matrix->fd, rows->data,
+        (size_t) count * matrix->cols * sizeof(c3e_number),
+        c3e_disk_offset(matrix, row), false
+    )) {
+        c3e_matrix_free(rows);
+        return NULL;
+    }
+
+    return rows;
+}
+
+bool c3e_disk_matrix_write_rows(c3e_disk_matrix* matrix, uint32_t row, c3e_matrix* rows) {
+    c3e_assert(matrix != NULL && rows != NULL);
+    c3e_assert(rows->cols == matrix->cols);
+    c3e_assert(row < matrix->rows && rows->rows <= matrix->rows - row);
+
+    return c3e_disk_transfer(
+        matrix->fd, rows->data,
+        (size_t) rows->rows * rows->cols * sizeof(c3e_number),
+        c3e_disk_offset(matrix, row), true
+    );
+}
+
+bool c3e_disk_matrix_add(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject) {
+    c3e_assert(subject != NULL);
+    return c3e_disk_stream(out, matrix, subject, 0.0, C3E_DISK_ADD);
+}
+
+bool c3e_disk_matrix_sub(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject) {
+    c3e_assert(subject != NULL);
+    return c3e_disk_stream(out, matrix, subject, 0.0, C3E_DISK_SUB);
+}
+
+bool c3e_disk_matrix_dot(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject) {
+    c3e_assert(subject != NULL);
+    return c3e_disk_stream(out, matrix, subject, 0.0, C3E_DISK_DOT);
+}
+
+bool c3e_disk_matrix_scalar_add(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_number x) {
+    return c3e_disk_stream(out, matrix, NULL, x, C3E_DISK_SCALAR_ADD);
+}
+
+bool c3e_disk_matrix_scalar_mul(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_number x) {
+    return c3e_disk_stream(out, matrix, NULL, x, C3E_DISK_SCALAR_MUL);
+}
+
+c3e_number c3e_disk_matrix_sum(c3e_disk_matrix* matrix) {
+    return c3e_disk_reduce(matrix, C3E_DISK_SUM);
+}
+
+c3e_number c3e_disk_matrix_max(c3e_disk_matrix* matrix) {
+    return c3e_disk_reduce(matrix, C3E_DISK_MAX);
+}
+
+c3e_number c3e_disk_matrix_min(c3e_disk_matrix* matrix) {
+    return c3e_disk_reduce(matrix, C3E_DISK_MIN);
+}
+
+c3e_vector* c3e_disk_matrix_gemv(c3e_disk_matrix* matrix, c3e_vector* vector) {
+    c3e_assert(matrix != NULL && vector != NULL);
+    c3e_assert(vector->size == matrix->cols);
+
+    c3e_vector* out = c3e_vector_init(matrix->rows);
+    if(out == NULL)
+        return NULL;
+
+    uint32_t chunk = c3e_disk_chunk(matrix, matrix->budget, 1);
+    for(uint32_t row = 0; row < matrix->rows; row += chunk) {
+        uint32_t count = matrix->rows - row < chunk ? matrix->rows - row : chunk;
+        c3e_disk_window window;
+
+        c3e_disk_prefetch(matrix, row + count, chunk);
+        if(!c3e_disk_matrix_map(matrix, row, count, false, &window)) {
+            c3e_vector_free(out);
+            return NULL;
+        }
+
+        for(uint32_t i = 0; i < count; i++) {
+            const c3e_number* values = window.view.data + (size_t) i * matrix->cols;
+            c3e_number sum = 0.0;
+
+            for(uint32_t j = 0; j < matrix->cols; j++)
+                sum += values[j] * vector->data[j];
+            out->data[row + i] = sum;
+        }
+
+        c3e_disk_matrix_unmap(&window);
+    }
+
+    return out;
+}
+
+bool c3e_disk_matrix_mul(c3e_disk_matrix* out, c3e_disk_matrix* matrix, c3e_disk_matrix* subject) {
+    c3e_assert(out != NULL && matrix != NULL && subject != NULL);
+    c3e_assert(out != matrix && out != subject);
+    c3e_assert(matrix->cols == subject->rows);
+    c3e_assert(out->rows == matrix->rows && out->cols == subject->cols);
+
+    size_t depth_size = (size_t) subject->cols * sizeof(c3e_number);
+    uint32_t depth_chunk = c3e_disk_chunk(subject, out->budget, 3);
+
+    size_t panel_budget = out->budget - (out->budget < (size_t) depth_chunk * depth_size ?
+        out->budget : (size_t) depth_chunk * depth_size);
+    size_t panel_row = ((size_t) matrix->cols + out->cols) * sizeof(c3e_number);
+    uint32_t panel = panel_budget / panel_row == 0 ? 1 :
+        panel_budget / panel_row < matrix->rows ? (uint32_t) (panel_budget / panel_row) : matrix->rows;
+
+    for(uint32_t row = 0; row < matrix->rows; row += panel) {
+        uint32_t count = matrix->rows - row < panel ? matrix->rows - row : panel;
+        c3e_disk_window left, target;
+
+        c3e_disk_prefetch(subject, 0, depth_chunk);
+        if(!c3e_disk_matrix_map(matrix, row, count, false, &left))
+            return false;
+        else if(!c3e_disk_matrix_map(out, row, count, true, &target)) {
+            c3e_disk_matrix_unmap(&left);
+            return false;
+        }
+
+        c3e_number* c = target.view.data;
+        memset(c, 0, (size_t) count * out->cols * sizeof(c3e_number));
+
+        bool done = true;
+        for(uint32_t depth = 0; done && depth < subject->rows; depth += depth_chunk) {
+            uint32_t width = subject->rows - depth < depth_chunk ? subject->rows - depth : depth_chunk;
+            c3e_disk_window right;
+
+            c3e_disk_prefetch(subject, depth + width, depth_chunk);
+            if(!(done = c3e_disk_matrix_map(subject, depth, width, false, &right)))
+                break;
+
+            for(uint32_t i = 0; i < count; i++) {
+                const c3e_number* a = left.view.data + (size_t) i * matrix->cols + depth;
+                c3e_number* c_row = c + (size_t) i * out->cols;
+
+                for(uint32_t k = 0; k < width; k++) {
+                    const c3e_number* b = right.view.data + (size_t) k * subject->cols;
+                    c3e_number scale = a[k];
+
+                    for(uint32_t j = 0; j < subject->cols; j++)
+                        c_row[j] += scale * b[j];
+                }
+            }
+
+            c3e_disk_matrix_unmap(&right);
+        }
+
+        c3e_disk_matrix_unmap(&target);
+        c3e_disk_matrix_unmap(&left);
+
+        if(!done)
+            return false;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,325 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/context.h>
+#include <c3e/dist_matrix.h>
+#include <c3e/matrix.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    c3e_dist_matrix* matrix;
+    c3e_dist_matrix* subject;
+    uint32_t depth;
+    uint32_t offset;
+    uint32_t width;
+    c3e_number* left;
+    c3e_number* right;
+    c3e_context_settings settings;
+    bool done;
+} c3e_dist_panel;
+
+static inline void c3e_dist_extent(uint32_t count, uint32_t parts, uint32_t index, uint32_t* offset, uint32_t* length) {
+    uint32_t base = count / parts, extra = count % parts;
+
+    *offset = index * base + (index < extra ? index : extra);
+    *length = base + (index < extra ? 1 : 0);
+}
+
+static inline uint32_t c3e_dist_owner(uint32_t count, uint32_t parts, uint32_t position, uint32_t* end) {
+    uint32_t offset, length;
+
+    for(uint32_t index = 0; index < parts; index++) {
+        c3e_dist_extent(count, parts, index, &offset, &length);
+
+        if(position < offset + length) {
+            *end = offset + length;
+            return index;
+        }
+    }
+
+    *end = count;
+    return parts - 1;
+}
+
+static void* c3e_dist_panel_fetch(void* argument) {
+    c3e_dist_panel* panel = (c3e_dist_panel*) argument;
+    c3e_dist_matrix* matrix = panel->matrix;
+    c3e_dist_matrix* subject = panel->subject;
+    c3e_context_current()->settings = panel->settings;
+
+    uint32_t end, rows = matrix->local->rows, cols = subject->local->cols;
+    uint32_t owner_col = c3e_dist_owner(panel->depth, matrix->grid_cols, panel->offset, &end);
+    uint32_t owner_row = c3e_dist_owner(panel->depth, subject->grid_rows, panel->offset, &end);
+
+    if(matrix->grid_col == owner_col)
+        for(uint32_t i = 0; i < rows; i++)
+            memcpy(
+                panel->left + (size_t) i * panel->width,
+                &MATRIX_ELEM(matrix->local, i, panel->offset - matrix->col_offset),
+                panel->width * sizeof(c3e_number)
+            );
+
+    if(subject->grid_row == owner_row)
+        memcpy(
+            panel->right,
+            &MATRIX_ELEM(subject->local, panel->offset - subject->row_offset, 0),
+            (size_t) panel->width * cols * sizeof(c3e_number)
+        );
+
+    panel->done = c3e_group_broadcast(
+        matrix->row_group, panel->left, (size_t) rows * panel->width,
+        owner_col, C3E_COLLECTIVE_TREE
+    ) && c3e_group_broadcast(
+        subject->col_group, panel->right, (size_t) panel->width * cols,
+        owner_row, C3E_COLLECTIVE_TREE
+    );
+
+    return NULL;
+}
+
+static void c3e_dist_gemm(c3e_matrix* out, const c3e_number* left, const c3e_number* right, uint32_t width) {
+    for(uint32_t i = 0; i < out->rows; i++) {
+        c3e_number* row = &MATRIX_ELEM(out, i, 0);
+
+        for(uint32_t k = 0; k < width; k++) {
+            c3e_number factor = left[(size_t) i * width + k];
+            const c3e_number* source = right + (size_t) k * out->cols;
+
+            for(uint32_t j = 0; j < out->cols; j++)
+                row[j] += factor * source[j];
+        }
+    }
+}
+
+c3e_dist_matrix* c3e_dist_matrix_init(c3e_group* group, uint32_t grid_rows, uint32_t grid_cols, uint32_t rows, uint32_t cols) {
+    c3e_assert(group != NULL);
+    c3e_assert(grid_rows != 0 && grid_cols != 0);
+    c3e_assert(grid_rows * grid_cols == group->size);
+    c3e_assert(rows >= grid_rows && cols >= grid_cols);
+
+    c3e_dist_matrix* matrix = (c3e_dist_matrix*) malloc(sizeof(c3e_dist_matrix));
+    if(matrix == NULL)
+        return NULL;
+
+    uint32_t local_rows, local_cols;
+    matrix->group = group;
+    matrix->grid_rows = grid_rows;
+    matrix->grid_cols = grid_cols;
+    matrix->grid_row = group->rank / grid_cols;
+    matrix->grid_col = group->rank % grid_cols;
+    matrix->rows = rows;
+    matrix->cols = cols;
+
+    c3e_dist_extent(rows, grid_rows, matrix->grid_row, &matrix->row_offset, &local_rows);
+    c3e_dist_extent(cols, grid_cols, matrix->grid_col, &matrix->col_offset, &local_cols);
+
+    uint32_t* members = (uint32_t*) malloc((grid_rows > grid_cols ? grid_rows : grid_cols) * sizeof(uint32_t));
+    if(members == NULL) {
+        free(matrix);
+        return NULL;
+    }
+
+    for(uint32_t j = 0; j < grid_cols; j++)
+        members[j] = matrix->grid_row * grid_cols + j;
+    matrix->row_group = c3e_group_subset(group, members, grid_cols);
+
+    for(uint32_t i = 0; i < grid_rows; i++)
+        members[i] = i * grid_cols + matrix->grid_col;
+    matrix->col_group = c3e_group_subset(group, members, grid_rows);
+
+    free(members);
+    matrix->local = c3e_matrix_init(local_rows, local_cols);
+
+    if(matrix->row_group == NULL || matrix->col_group == NULL || matrix->local == NULL) {
+        c3e_dist_matrix_free(matrix);
+        return NULL;
+    }
+
+    return matrix;
+}
+
+void c3e_dist_matrix_free(c3e_dist_matrix* matrix) {
+    c3e_assert(matrix != NULL);
+
+    if(matrix->row_group != NULL)
+        c3e_group_free(matrix->row_group);
+    if(matrix->col_group != NULL)
+        c3e_group_free(matrix->col_group);
+    if(matrix->local != NULL)
+        c3e_matrix_free(matrix->local);
+
+    free(matrix);
+}
+
+bool c3e_dist_matrix_scatter(c3e_dist_matrix* matrix, c3e_matrix* source, uint32_t root) {
+    c3e_assert(matrix != NULL);
+    c3e_assert(root < matrix->group->size);
+
+    c3e_matrix* local = matrix->local;
+    size_t block_size = (size_t) local->rows * local->cols * sizeof(c3e_number);
+
+    if(matrix->group->rank != root)
+        return c3e_socket_receive_data(&matrix->group->peers[root], local->data, block_size);
+
+    c3e_assert(source != NULL);
+    c3e_assert(source->rows == matrix->rows && source->cols == matrix->cols);
+
+    for(uint32_t rank = 0; rank < matrix->group->size; rank++) {
+        uint32_t row, rows, col, cols;
+
+        c3e_dist_extent(matrix->rows, matrix->grid_rows, rank / matrix->grid_cols, &row, &rows);
+        c3e_dist_extent(matrix->cols, matrix->grid_cols, rank % matrix->grid_cols, &col, &cols);
+
+        for(uint32_t i = 0; i < rows; i++)
+            if(rank == root)
+                memcpy(&MATRIX_ELEM(local, i, 0), &MATRIX_ELEM(source, row + i, col), cols * sizeof(c3e_number));
+            else if(!c3e_socket_send_data(
+                &matrix->group->peers[rank],
+                &MATRIX_ELEM(source, row + i, col),
+                cols * sizeof(c3e_number)
+            ))
+                return false;
+    }
+
+    return true;
+}
+
+bool c3e_dist_matrix_gather(c3e_dist_matrix* matrix, c3e_matrix* target, uint32_t root) {
+    c3e_assert(matrix != NULL);
+    c3e_assert(root < matrix->group->size);
+
+    c3e_matrix* local = matrix->local;
+    size_t block_size = (size_t) local->rows * local->cols * sizeof(c3e_number);
+
+    if(matrix->group->rank != root)
+        return c3e_socket_send_data(&matrix->group->peers[root], local->data, block_size);
+
+    c3e_assert(target != NULL);
+    c3e_assert(target->rows == matrix->rows && target->cols == matrix->cols);
+
+    for(uint32_t rank = 0; rank < matrix->group->size; rank++) {
+        uint32_t row, rows, col, cols;
+
+        c3e_dist_extent(matrix->rows, matrix->grid_rows, rank / matrix->grid_cols, &row, &rows);
+        c3e_dist_extent(matrix->cols, matrix->grid_cols, rank % matrix->grid_cols, &col, &cols);
+
+        for(uint32_t i = 0; i < rows; i++)
+            if(rank == root)
+                memcpy(&MATRIX_ELEM(target, row + i, col), &MATRIX_ELEM(local, i, 0), cols * sizeof(c3e_number));
+            else if(!c3e_socket_receive_data(
+                &matrix->group->peers[rank],
+                &MATRIX_ELEM(target, row + i, col),
+                cols * sizeof(c3e_number)
+            ))
+                return false;
+    }
+
+    return true;
+}
+
+c3e_dist_matrix* c3e_dist_matrix_mul(c3e_dist_matrix* matrix, c3e_dist_matrix* subject, uint32_t panel) {
+    c3e_assert(matrix != NULL && subject != NULL);
+    c3e_assert(matrix->group == subject->group);
+    c3e_assert(matrix->grid_rows == subject->grid_rows && matrix->grid_cols == subject->grid_cols);
+    c3e_assert(matrix->cols == subject->rows);
+
+    if(panel == 0)
+        panel = C3E_DIST_MATRIX_PANEL;
+
+    c3e_dist_matrix* out = c3e_dist_matrix_init(
+        matrix->group,
+        matrix->grid_rows, matrix->grid_cols,
+        matrix->rows, subject->cols
+    );
+
+    if(out == NULL)
+        return NULL;
+
+    uint32_t depth = matrix->cols;
+    size_t rows = out->local->rows, cols = out->local->cols;
+
+    c3e_number* buffers = (c3e_number*) malloc(2 * (rows + cols) * panel * sizeof(c3e_number));
+    if(buffers == NULL) {
+        c3e_dist_matrix_free(out);
+        return NULL;
+    }
+
+    c3e_dist_panel panels[2];
+    for(int slot = 0; slot < 2; slot++) {
+        panels[slot].matrix = matrix;
+        panels[slot].subject = subject;
+        panels[slot].depth = depth;
+        panels[slot].settings = c3e_context_current()->settings;
+        panels[slot].left = buffers + slot * (rows + cols) * panel;
+        panels[slot].right = panels[slot].left + rows * panel;
+    }
+
+    uint32_t a_end, b_end;
+    c3e_dist_owner(depth, matrix->grid_cols, 0, &a_end);
+    c3e_dist_owner(depth, subject->grid_rows, 0, &b_end);
+
+    panels[0].offset = 0;
+    panels[0].width = a_end < b_end ? a_end : b_end;
+    if(panels[0].width > panel)
+        panels[0].width = panel;
+
+    c3e_dist_panel_fetch(&panels[0]);
+    bool done = panels[0].done;
+
+    for(int slot = 0; done; slot ^= 1) {
+        c3e_dist_panel* current = &panels[slot];
+        c3e_dist_panel* next = &panels[slot ^ 1];
+
+        next->offset = current->offset + current->width;
+        next->width = 0;
+
+        if(next->offset < depth) {
+            c3e_dist_owner(depth, matrix->grid_cols, next->offset, &a_end);
+            c3e_dist_owner(depth, subject->grid_rows, next->offset, &b_end);
+
+            next->width = (a_end < b_end ? a_end : b_end) - next->offset;
+            if(next->width > panel)
+                next->width = panel;
+        }
+
+        pthread_t thread;
+        bool overlapped = next->width != 0 &&
+            pthread_create(&thread, NULL, c3e_dist_panel_fetch, next) == 0;
+
+        c3e_dist_gemm(out->local, current->left, current->right, current->width);
+
+        if(overlapped)
+            pthread_join(thread, NULL);
+        else if(next->width != 0)
+            c3e_dist_panel_fetch(next);
+        else break;
+
+        done = next->done;
+    }
+
+    free(buffers);
+    if(!done) {
+        c3e_dist_matrix_free(out);
+        return NULL;
+    }
+
+    return out;
+}
\ No newline at end of file
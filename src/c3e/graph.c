@@ -0,0 +1,213 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/graph.h>
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool c3e_graph_append(c3e_graph_node*** array, uint32_t* count, uint32_t* capacity, c3e_graph_node* node) {
+    if(*count == *capacity) {
+        uint32_t grown = *capacity == 0 ? 4 : *capacity * 2;
+        c3e_graph_node** resized = (c3e_graph_node**) realloc(*array, grown * sizeof(c3e_graph_node*));
+
+        if(resized == NULL)
+            return false;
+
+        *array = resized;
+        *capacity = grown;
+    }
+
+    (*array)[(*count)++] = node;
+    return true;
+}
+
+static inline uint32_t c3e_graph_hash(const void* data, uint32_t capacity) {
+    uint64_t x = (uint64_t) (uintptr_t) data;
+
+    x = (x ^ (x >> 33)) * 0xff51afd7ed558ccdull;
+    return (uint32_t) (x ^ (x >> 33)) & (capacity - 1);
+}
+
+static c3e_graph_block* c3e_graph_probe(c3e_graph_block* blocks, uint32_t capacity, const void* data) {
+    uint32_t slot = c3e_graph_hash(data, capacity);
+
+    while(blocks[slot].data != NULL && blocks[slot].data != data)
+        slot = (slot + 1) & (capacity - 1);
+    return &blocks[slot];
+}
+
+static c3e_graph_block* c3e_graph_find(c3e_graph* graph, const void* data) {
+    if((graph->block_count + 1) * 4 > graph->block_capacity * 3) {
+        uint32_t capacity = graph->block_capacity == 0 ? 64 : graph->block_capacity * 2;
+        c3e_graph_block* blocks = (c3e_graph_block*) calloc(capacity, sizeof(c3e_graph_block));
+
+        if(blocks == NULL)
+            return NULL;
+
+        for(uint32_t i = 0; i < graph->block_capacity; i++)
+            if(graph->blocks[i].data != NULL)
+                *c3e_graph_probe(blocks, capacity, graph->blocks[i].data) = graph->blocks[i];
+
+        free(graph->blocks);
+        graph->blocks = blocks;
+        graph->block_capacity = capacity;
+    }
+
+    c3e_graph_block* block = c3e_graph_probe(graph->blocks, graph->block_capacity, data);
+    if(block->data == NULL) {
+        block->data = data;
+        graph->block_count++;
+    }
+
+    return block;
+}
+
+static bool c3e_graph_depend(c3e_graph_node* predecessor, c3e_graph_node* node) {
+    if(predecessor == NULL || predecessor == node ||
+        (predecessor->successor_count != 0 &&
+        predecessor->successors[predecessor->successor_count - 1] == node))
+        return true;
+
+    if(!c3e_graph_append(&predecessor->successors, &predecessor->successor_count, &predecessor->successor_capacity, node))
+        return false;
+
+    atomic_fetch_add_explicit(&node->dependencies, 1, memory_order_relaxed);
+    return true;
+}
+
+static void c3e_graph_clear(c3e_graph* graph) {
+    for(uint32_t i = 0; i < graph->count; i++) {
+        free(graph->nodes[i]->successors);
+        free(graph->nodes[i]);
+    }
+
+    for(uint32_t i = 0; i < graph->block_capacity; i++)
+        free(graph->blocks[i].readers);
+
+    free(graph->blocks);
+    graph->blocks = NULL;
+    graph->block_count = 0;
+    graph->block_capacity = 0;
+    graph->count = 0;
+    graph->failed = false;
+}
+
+static void c3e_graph_execute(void* argument) {
+    c3e_graph_node* node = (c3e_graph_node*) argument;
+    node->run(node->argument);
+
+    for(uint32_t i = node->successor_count; i > 0; i--) {
+        c3e_graph_node* successor = node->successors[i - 1];
+
+        if(atomic_fetch_sub_explicit(&successor->dependencies, 1, memory_order_acq_rel) == 1)
+            c3e_pool_spawn(&node->graph->group, c3e_graph_execute, successor);
+    }
+}
+
+c3e_graph* c3e_graph_init(void) {
+    c3e_graph* graph = (c3e_graph*) calloc(1, sizeof(c3e_graph));
+    if(graph == NULL)
+        return NULL;
+
+    c3e_pool_group_init(&graph->group);
+    return graph;
+}
+
+void c3e_graph_free(c3e_graph* graph) {
+    c3e_assert(graph != NULL);
+
+    c3e_graph_clear(graph);
+    free(graph->nodes);
+    free(graph);
+}
+
+bool c3e_graph_submit(c3e_graph* graph, void (*run)(void*), const void* argument, size_t size, const c3e_graph_access* accesses, uint32_t count) {
+    c3e_assert(graph != NULL && run != NULL);
+    c3e_assert(accesses != NULL || count == 0);
+
+    if(graph->failed)
+        return false;
+
+    size_t offset = (sizeof(c3e_graph_node) + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+    c3e_graph_node* node = (c3e_graph_node*) calloc(1, offset + size);
+
+    if(node == NULL || !c3e_graph_append(&graph->nodes, &graph->count, &graph->capacity, node)) {
+        free(node);
+        graph->failed = true;
+
+        return false;
+    }
+
+    node->run = run;
+    node->argument = (uint8_t*) node + offset;
+    node->graph = graph;
+    atomic_init(&node->dependencies, 0);
+
+    if(size != 0)
+        memcpy(node->argument, argument, size);
+
+    for(uint32_t i = 0; i < count; i++) {
+        c3e_graph_block* block = c3e_graph_find(graph, accesses[i].data);
+
+        if(block == NULL || !c3e_graph_depend(block->writer, node)) {
+            graph->failed = true;
+            return false;
+        }
+
+        if(accesses[i].mode == C3E_GRAPH_READ) {
+            if(!c3e_graph_append(&block->readers, &block->reader_count, &block->reader_capacity, node)) {
+                graph->failed = true;
+                return false;
+            }
+
+            continue;
+        }
+
+        for(uint32_t r = 0; r < block->reader_count; r++)
+            if(!c3e_graph_depend(block->readers[r], node)) {
+                graph->failed = true;
+                return false;
+            }
+
+        block->writer = node;
+        block->reader_count = 0;
+    }
+
+    return true;
+}
+
+bool c3e_graph_run(c3e_graph* graph) {
+    c3e_assert(graph != NULL);
+
+    if(graph->failed) {
+        c3e_graph_clear(graph);
+        return false;
+    }
+
+    for(uint32_t i = graph->count; i > 0; i--)
+        if(atomic_load_explicit(&graph->nodes[i - 1]->dependencies, memory_order_relaxed) == 0)
+            c3e_pool_spawn(&graph->group, c3e_graph_execute, graph->nodes[i - 1]);
+
+    c3e_pool_group_wait(&graph->group);
+    c3e_graph_clear(graph);
+
+    return true;
+}
\ No newline at end of file
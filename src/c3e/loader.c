@@ -0,0 +1,229 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/loader.h>
+#include <c3e/matrix.h>
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define C3E_LOADER_SPINS    256
+#define C3E_LOADER_STOPPED  UINT32_MAX
+
+static inline uint64_t c3e_loader_mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+
+    return x ^ (x >> 31);
+}
+
+static uint32_t c3e_loader_permute(c3e_loader* loader, uint64_t epoch, uint32_t index) {
+    uint32_t bits = 2;
+    while(bits < 32 && ((uint64_t) 1 << bits) < loader->rows)
+        bits += 2;
+
+    uint32_t half = bits / 2;
+    uint64_t mask = ((uint64_t) 1 << half) - 1;
+    uint64_t key = c3e_loader_mix(loader->seed + epoch * 0x9e3779b97f4a7c15ull);
+    uint64_t x = index;
+
+    do {
+        uint64_t left = x >> half, right = x & mask;
+
+        for(uint32_t round = 0; round < 4; round++) {
+            uint64_t next = left ^ (c3e_loader_mix(right ^ key ^ ((uint64_t) round << 56)) & mask);
+
+            left = right;
+            right = next;
+        }
+
+        x = (left << half) | right;
+    } while(x >= loader->rows);
+
+    return (uint32_t) x;
+}
+
+static void c3e_loader_wake(_Atomic uint32_t* sequence) {
+    syscall(SYS_futex, (uint32_t*) sequence, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+static bool c3e_loader_wait(c3e_loader* loader, _Atomic uint32_t* sequence, uint32_t expected) {
+    for(uint32_t spins = 0;; spins++) {
+        uint32_t current = atomic_load_explicit(sequence, memory_order_acquire);
+
+        if(current == expected)
+            return true;
+        else if(atomic_load_explicit(&loader->stopping, memory_order_relaxed))
+            return false;
+        else if(spins >= C3E_LOADER_SPINS)
+            syscall(SYS_futex, (uint32_t*) sequence, FUTEX_WAIT_PRIVATE, current, NULL, NULL, 0);
+    }
+}
+
+static void c3e_loader_gather(c3e_loader* loader, c3e_loader_slot* slot, uint64_t batch) {
+    uint64_t epoch = batch / loader->batches;
+    uint32_t start = (uint32_t) (batch % loader->batches) * loader->batch_size;
+    uint32_t rows = loader->rows - start < loader->batch_size ?
+        loader->rows - start : loader->batch_size;
+
+    for(uint32_t s = 0; s < loader->count; s++)
+        slot->matrices[s]->rows = rows;
+
+    for(uint32_t i = 0; i < rows; i++) {
+        uint32_t row = loader->shuffle ?
+            c3e_loader_permute(loader, epoch, start + i) : start + i;
+
+        for(uint32_t s = 0; s < loader->count; s++) {
+            c3e_matrix* source = loader->sources[s];
+
+            memcpy(
+                &MATRIX_ELEM(slot->matrices[s], i, 0),
+                &MATRIX_ELEM(source, row, 0),
+                source->cols * sizeof(c3e_number)
+            );
+        }
+    }
+}
+
+static void* c3e_loader_run(void* argument) {
+    c3e_loader* loader = (c3e_loader*) argument;
+    c3e_context_current()->settings = loader->settings;
+
+    while(true) {
+        uint64_t batch = atomic_fetch_add_explicit(&loader->claimed, 1, memory_order_relaxed);
+        c3e_loader_slot* slot = &loader->slots[batch % loader->depth];
+
+        if(!c3e_loader_wait(loader, &slot->sequence, (uint32_t) batch))
+            return NULL;
+
+        c3e_loader_gather(loader, slot, batch);
+        atomic_store_explicit(&slot->sequence, (uint32_t) (batch + 1), memory_order_release);
+        c3e_loader_wake(&slot->sequence);
+    }
+}
+
+c3e_loader* c3e_loader_init(c3e_matrix** sources, uint32_t count, uint32_t batch_size, uint32_t depth, uint32_t workers, bool shuffle, uint64_t seed) {
+    c3e_assert(sources != NULL && count != 0);
+    c3e_assert(batch_size != 0 && depth >= 2);
+
+    for(uint32_t s = 0; s < count; s++)
+        c3e_assert(sources[s]->rows == sources[0]->rows && sources[s]->rows != 0 && sources[s]->cols != 0);
+
+    if(workers == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (uint32_t) online : 1;
+    }
+
+    if(workers > depth)
+        workers = depth;
+
+    c3e_loader* loader = (c3e_loader*) calloc(1, sizeof(c3e_loader));
+    if(loader == NULL)
+        return NULL;
+
+    loader->sources = sources;
+    loader->count = count;
+    loader->rows = sources[0]->rows;
+    loader->batch_size = batch_size < loader->rows ? batch_size : loader->rows;
+    loader->batches = (loader->rows + loader->batch_size - 1) / loader->batch_size;
+    loader->depth = depth;
+    loader->shuffle = shuffle;
+    loader->seed = seed;
+    loader->settings = c3e_context_current()->settings;
+    loader->slots = (c3e_loader_slot*) calloc(depth, sizeof(c3e_loader_slot));
+    loader->workers = (pthread_t*) malloc(workers * sizeof(pthread_t));
+
+    atomic_init(&loader->claimed, 0);
+    atomic_init(&loader->stopping, false);
+
+    bool allocated = loader->slots != NULL && loader->workers != NULL;
+    for(uint32_t i = 0; allocated && i < depth; i++) {
+        c3e_loader_slot* slot = &loader->slots[i];
+
+        atomic_init(&slot->sequence, i);
+        slot->matrices = (c3e_matrix**) calloc(count, sizeof(c3e_matrix*));
+        allocated = slot->matrices != NULL;
+
+        for(uint32_t s = 0; allocated && s < count; s++)
+            allocated = (slot->matrices[s] = c3e_matrix_init(loader->batch_size, sources[s]->cols)) != NULL;
+    }
+
+    for(uint32_t i = 0; allocated && i < workers; i++)
+        if(pthread_create(&loader->workers[i], NULL, c3e_loader_run, loader) == 0)
+            loader->worker_count++;
+
+    if(!allocated || loader->worker_count == 0) {
+        c3e_loader_free(loader);
+        return NULL;
+    }
+
+    return loader;
+}
+
+void c3e_loader_free(c3e_loader* loader) {
+    c3e_assert(loader != NULL);
+
+    atomic_store(&loader->stopping, true);
+    for(uint32_t i = 0; loader->slots != NULL && i < loader->depth; i++) {
+        atomic_store(&loader->slots[i].sequence, C3E_LOADER_STOPPED);
+        c3e_loader_wake(&loader->slots[i].sequence);
+    }
+
+    for(uint32_t i = 0; i < loader->worker_count; i++)
+        pthread_join(loader->workers[i], NULL);
+
+    for(uint32_t i = 0; loader->slots != NULL && i < loader->depth; i++) {
+        c3e_loader_slot* slot = &loader->slots[i];
+
+        for(uint32_t s = 0; slot->matrices != NULL && s < loader->count; s++)
+            if(slot->matrices[s] != NULL)
+                c3e_matrix_free(slot->matrices[s]);
+
+        free(slot->matrices);
+    }
+
+    free(loader->slots);
+    free(loader->workers);
+    free(loader);
+}
+
+c3e_matrix** c3e_loader_next(c3e_loader* loader) {
+    c3e_assert(loader != NULL);
+    c3e_assert(loader->taken - loader->released < loader->depth);
+
+    uint64_t batch = loader->taken++;
+    c3e_loader_slot* slot = &loader->slots[batch % loader->depth];
+
+    c3e_loader_wait(loader, &slot->sequence, (uint32_t) (batch + 1));
+    return slot->matrices;
+}
+
+void c3e_loader_release(c3e_loader* loader) {
+    c3e_assert(loader != NULL);
+    c3e_assert(loader->released < loader->taken);
+
+    uint64_t batch = loader->released++;
+    c3e_loader_slot* slot = &loader->slots[batch % loader->depth];
+
+    atomic_store_explicit(&slot->sequence, (uint32_t) (batch + loader->depth), memory_order_release);
+    c3e_loader_wake(&slot->sequence);
+}
\ No newline at end of file
@@ -16,8 +16,10 @@
  */
 
 #include <c3e/assert.h>
+#include <c3e/graph.h>
 #include <c3e/matrix.h>
 #include <c3e/matrix_tuple.h>
+#include <c3e/memory.h>
 #include <c3e/random.h>
 #include <c3e/svd.h>
 #include <c3e/trigo.h>
@@ -63,7 +65,7 @@ c3e_matrix* c3e_matrix_init(int rows, int cols) {
 
     matrix->rows = rows;
     matrix->cols = cols;
-    matrix->data = (c3e_number*) calloc(rows * cols, sizeof(c3e_number));
+    matrix->data = (c3e_number*) c3e_memory_alloc((size_t) rows * cols * sizeof(c3e_number));
 
     if(matrix->data == NULL) {
         free(matrix);
@@ -74,7 +76,7 @@ c3e_matrix* c3e_matrix_init(int rows, int cols) {
 }
 
 void c3e_matrix_free(c3e_matrix* matrix) {
-    free(matrix->data);
+    c3e_memory_free(matrix->data);
     free(matrix);
 }
 
@@ -145,25 +147,17 @@ c3e_matrix* c3e_matrix_identity(int side) {
 }
 
 c3e_matrix* c3e_matrix_random(int rows, int cols, int seed) {
-    int size = rows * cols;
-    c3e_matrix* matrix = c3e_matrix_init(rows, cols);
-    c3e_number* rand_array = (c3e_number*) malloc(sizeof(c3e_number) * size);
-
-    for(int i = 0; i < size; i++)
-        rand_array[i] = c3e_random() / (c3e_number) RAND_MAX;
-    c3e_matrix_set_elements(matrix, rand_array);
-
-    return matrix;
+    return c3e_matrix_random_bound(rows, cols, seed, 0.0, 1.0);
 }
 
 c3e_matrix* c3e_matrix_random_bound(int rows, int cols, int seed, c3e_number min, c3e_number max) {
-    int size = rows * cols;
     c3e_matrix* matrix = c3e_matrix_init(rows, cols);
-    c3e_number* rand_array = (c3e_number*) malloc(sizeof(c3e_number) * size);
+    if(matrix == NULL)
+        return NULL;
 
-    for(int i = 0; i < size; i++)
-        rand_array[i] = c3e_random_bound(min, max) / (c3e_number) RAND_MAX;
-    c3e_matrix_set_elements(matrix, rand_array);
+    c3e_rng rng;
+    c3e_rng_init(&rng, (uint64_t) (uint32_t) seed, 0);
+    c3e_rng_fill_parallel(&rng, matrix->data, (size_t) rows * cols, min, max, 0);
 
     return matrix;
 }
@@ -375,6 +369,40 @@ c3e_number c3e_matrix_determinant(c3e_matrix* matrix) {
     return out;
 }
 
+bool c3e_matrix_singular(c3e_matrix* matrix) {
+    c3e_assert(matrix->rows == matrix->cols);
+
+    c3e_matrix* lu = c3e_matrix_copy(matrix);
+    if(lu == NULL)
+        return true;
+
+    int n = lu->rows;
+    bool singular = false;
+
+    for(int k = 0; !singular && k < n; k++) {
+        int pivot = k;
+
+        for(int i = k + 1; i < n; i++)
+            if(fabs(MATRIX_ELEM(lu, i, k)) > fabs(MATRIX_ELEM(lu, pivot, k)))
+                pivot = i;
+
+        singular = !(fabs(MATRIX_ELEM(lu, pivot, k)) > 1e-10);
+        if(singular)
+            break;
+
+        c3e_matrix_swap_rows(lu, k, pivot);
+        for(int i = k + 1; i < n; i++) {
+            c3e_number factor = MATRIX_ELEM(lu, i, k) / MATRIX_ELEM(lu, k, k);
+
+            for(int j = k + 1; j < n; j++)
+                MATRIX_ELEM(lu, i, j) -= factor * MATRIX_ELEM(lu, k, j);
+        }
+    }
+
+    c3e_matrix_free(lu);
+    return singular;
+}
+
 c3e_number c3e_matrix_log_determ(c3e_matrix* matrix) {
     return log(c3e_matrix_determinant(matrix));
 }
@@ -499,23 +527,23 @@ c3e_matrix* c3e_matrix_row_echelon(c3e_matrix* matrix) {
 
 c3e_matrix* c3e_matrix_inverse(c3e_matrix* matrix) {
     c3e_assert(matrix->rows == matrix->cols);
-    c3e_assert(c3e_matrix_determinant(matrix) != 0.0);
+    c3e_assert(!c3e_matrix_singular(matrix));
 
     int n = matrix->rows;
 
     c3e_matrix* eye = c3e_matrix_identity(n);
     c3e_matrix* aug = c3e_matrix_append(matrix, eye, 0);
+    c3e_matrix_free(eye);
+
     c3e_matrix* echelon = c3e_matrix_row_echelon(aug);
-    c3e_matrix* inv = c3e_matrix_init(n, n);
+    c3e_matrix_free(aug);
 
+    c3e_matrix* inv = c3e_matrix_init(n, n);
     for(int i = 0; i < n; i++)
         for(int j = 0; j < n; j++)
             MATRIX_ELEM(inv, i, j) = echelon->data[i * (2*n) + n + j];
 
     c3e_matrix_free(echelon);
-    c3e_matrix_free(aug);
-    c3e_matrix_free(eye);
-
     return inv;
 }
 
@@ -555,6 +583,187 @@ c3e_matrix* c3e_matrix_cholesky_decomp(c3e_matrix* matrix) {
     return lower;
 }
 
+typedef struct {
+    c3e_number** tiles;
+    uint32_t count;
+    uint32_t size;
+    uint32_t order;
+    _Atomic bool failed;
+} c3e_matrix_tiling;
+
+typedef struct {
+    c3e_matrix_tiling* tiling;
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+} c3e_matrix_tile_task;
+
+static inline uint32_t c3e_matrix_tile_extent(c3e_matrix_tiling* tiling, uint32_t index) {
+    uint32_t start = index * tiling->size;
+    return tiling->order - start < tiling->size ? tiling->order - start : tiling->size;
+}
+
+static inline c3e_number* c3e_matrix_tile(c3e_matrix_tiling* tiling, uint32_t i, uint32_t j) {
+    return tiling->tiles[(size_t) i * tiling->count + j];
+}
+
+static void c3e_matrix_tile_potrf(void* argument) {
+    c3e_matrix_tile_task* task = (c3e_matrix_tile_task*) argument;
+    c3e_matrix_tiling* tiling = task->tiling;
+
+    if(atomic_load_explicit(&tiling->failed, memory_order_relaxed))
+        return;
+
+    uint32_t m = c3e_matrix_tile_extent(tiling, task->k);
+    c3e_number* a = c3e_matrix_tile(tiling, task->k, task->k);
+
+    for(uint32_t j = 0; j < m; j++) {
+        c3e_number diagonal = a[j * m + j];
+        for(uint32_t p = 0; p < j; p++)
+            diagonal -= a[j * m + p] * a[j * m + p];
+
+        if(!(diagonal > 0.0)) {
+            atomic_store_explicit(&tiling->failed, true, memory_order_relaxed);
+            return;
+        }
+
+        a[j * m + j] = sqrt(diagonal);
+        for(uint32_t i = j + 1; i < m; i++) {
+            c3e_number value = a[i * m + j];
+
+            for(uint32_t p = 0; p < j; p++)
+                value -= a[i * m + p] * a[j * m + p];
+            a[i * m + j] = value / a[j * m + j];
+        }
+    }
+}
+
+static void c3e_matrix_tile_trsm(void* argument) {
+    c3e_matrix_tile_task* task = (c3e_matrix_tile_task*) argument;
+    c3e_matrix_tiling* tiling = task->tiling;
+
+    if(atomic_load_explicit(&tiling->failed, memory_order_relaxed))
+        return;
+
+    uint32_t rows = c3e_matrix_tile_extent(tiling, task->i), m = c3e_matrix_tile_extent(tiling, task->k);
+    c3e_number* b = c3e_matrix_tile(tiling, task->i, task->k);
+    c3e_number* l = c3e_matrix_tile(tiling, task->k, task->k);
+
+    for(uint32_t r = 0; r < rows; r++) {
+        c3e_number* x = b + (size_t) r * m;
+
+        for(uint32_t j = 0; j < m; j++) {
+            c3e_number value = x[j];
+
+            for(uint32_t p = 0; p < j; p++)
+                value -= x[p] * l[j * m + p];
+            x[j] = value / l[j * m + j];
+        }
+    }
+}
+
+static void c3e_matrix_tile_update(void* argument) {
+    c3e_matrix_tile_task* task = (c3e_matrix_tile_task*) argument;
+    c3e_matrix_tiling* tiling = task->tiling;
+
+    if(atomic_load_explicit(&tiling->failed, memory_order_relaxed))
+        return;
+
+    uint32_t rows = c3e_matrix_tile_extent(tiling, task->i);
+    uint32_t cols = c3e_matrix_tile_extent(tiling, task->j);
+    uint32_t depth = c3e_matrix_tile_extent(tiling, task->k);
+
+    c3e_number* c = c3e_matrix_tile(tiling, task->i, task->j);
+    c3e_number* a = c3e_matrix_tile(tiling, task->i, task->k);
+    c3e_number* b = c3e_matrix_tile(tiling, task->j, task->k);
+
+    for(uint32_t r = 0; r < rows; r++) {
+        uint32_t end = task->i == task->j ? r + 1 : cols;
+
+        for(uint32_t q = 0; q < end; q++) {
+            c3e_number sum = 0.0;
+
+            for(uint32_t p = 0; p < depth; p++)
+                sum += a[(size_t) r * depth + p] * b[(size_t) q * depth + p];
+            c[(size_t) r * cols + q] -= sum;
+        }
+    }
+}
+
+static bool c3e_matrix_tile_submit(c3e_graph* graph, void (*run)(void*), c3e_matrix_tiling* tiling, uint32_t i, uint32_t j, uint32_t k) {
+    c3e_matrix_tile_task task = {tiling, i, j, k};
+    c3e_graph_access accesses[3] = {
+        {c3e_matrix_tile(tiling, i, j), C3E_GRAPH_WRITE},
+        {c3e_matrix_tile(tiling, i, k), C3E_GRAPH_READ},
+        {c3e_matrix_tile(tiling, j, k), C3E_GRAPH_READ}
+    };
+
+    return c3e_graph_submit(graph, run, &task, sizeof(task), accesses, 3);
+}
+
+c3e_matrix* c3e_matrix_cholesky_tiled(c3e_matrix* matrix, uint32_t tile) {
+    c3e_assert(matrix != NULL && matrix->rows == matrix->cols);
+    c3e_assert(tile != 0);
+
+    c3e_matrix_tiling tiling = {
+        .count = ((uint32_t) matrix->rows + tile - 1) / tile,
+        .size = tile,
+        .order = (uint32_t) matrix->rows
+    };
+
+    atomic_init(&tiling.failed, false);
+    tiling.tiles = (c3e_number**) calloc((size_t) tiling.count * tiling.count, sizeof(c3e_number*));
+
+    c3e_graph* graph = c3e_graph_init();
+    bool ready = tiling.tiles != NULL && graph != NULL;
+
+    for(uint32_t i = 0; ready && i < tiling.count; i++)
+        for(uint32_t j = 0; ready && j <= i; j++) {
+            uint32_t rows = c3e_matrix_tile_extent(&tiling, i), cols = c3e_matrix_tile_extent(&tiling, j);
+            c3e_number* data = (c3e_number*) malloc((size_t) rows * cols * sizeof(c3e_number));
+
+            tiling.tiles[(size_t) i * tiling.count + j] = data;
+            ready = data != NULL;
+
+            for(uint32_t r = 0; ready && r < rows; r++)
+                memcpy(data + (size_t) r * cols, &MATRIX_ELEM(matrix, i * tile + r, j * tile), cols * sizeof(c3e_number));
+        }
+
+    for(uint32_t k = 0; ready && k < tiling.count; k++) {
+        ready = c3e_matrix_tile_submit(graph, c3e_matrix_tile_potrf, &tiling, k, k, k);
+
+        for(uint32_t i = k + 1; ready && i < tiling.count; i++)
+            ready = c3e_matrix_tile_submit(graph, c3e_matrix_tile_trsm, &tiling, i, k, k);
+
+        for(uint32_t i = k + 1; ready && i < tiling.count; i++)
+            for(uint32_t j = k + 1; ready && j <= i; j++)
+                ready = c3e_matrix_tile_submit(graph, c3e_matrix_tile_update, &tiling, i, j, k);
+    }
+
+    c3e_matrix* lower = NULL;
+    if(ready && c3e_graph_run(graph) && !atomic_load(&tiling.failed))
+        lower = c3e_matrix_zeros(matrix->rows, matrix->cols);
+
+    for(uint32_t i = 0; lower != NULL && i < tiling.count; i++)
+        for(uint32_t j = 0; j <= i; j++) {
+            uint32_t rows = c3e_matrix_tile_extent(&tiling, i), cols = c3e_matrix_tile_extent(&tiling, j);
+            c3e_number* data = c3e_matrix_tile(&tiling, i, j);
+
+            for(uint32_t r = 0; r < rows; r++)
+                memcpy(&MATRIX_ELEM(lower, i * tile + r, j * tile), data + (size_t) r * cols,
+                    (i == j ? r + 1 : cols) * sizeof(c3e_number));
+        }
+
+    for(size_t t = 0; tiling.tiles != NULL && t < (size_t) tiling.count * tiling.count; t++)
+        free(tiling.tiles[t]);
+
+    free(tiling.tiles);
+    if(graph != NULL)
+        c3e_graph_free(graph);
+
+    return lower;
+}
+
 int c3e_matrix_rank(c3e_matrix* matrix) {
     c3e_matrix* rem;
     int non_zero_row_count = 0;
@@ -1538,3 +1747,61 @@ c3e_matrix* c3e_matrix_arg_max_vals(c3e_matrix* matrix, int dim) {
 
     return NULL;
 }
+
+c3e_matrix* c3e_matrix_gather_rows(c3e_matrix* matrix, const uint32_t* rows, uint32_t count) {
+    c3e_assert(matrix != NULL && (rows != NULL || count == 0));
+
+    c3e_matrix* out = c3e_matrix_init(count, matrix->cols);
+    if(out == NULL)
+        return NULL;
+
+    size_t row_size = matrix->cols * sizeof(c3e_number);
+    for(uint32_t i = 0; i < count; i++) {
+        c3e_assert(rows[i] < matrix->rows);
+        memcpy(&MATRIX_ELEM(out, i, 0), &MATRIX_ELEM(matrix, rows[i], 0), row_size);
+    }
+
+    return out;
+}
+
+bool c3e_matrix_permute_rows(c3e_matrix* matrix, const uint32_t* permutation) {
+    c3e_assert(matrix != NULL && permutation != NULL);
+
+    size_t row_size = matrix->cols * sizeof(c3e_number);
+    c3e_number* buffer = (c3e_number*) malloc(row_size == 0 ? 1 : row_size);
+    bool* placed = (bool*) calloc(matrix->rows, sizeof(bool));
+
+    if(buffer == NULL || placed == NULL) {
+        free(buffer);
+        free(placed);
+
+        return false;
+    }
+
+    for(uint32_t start = 0; start < matrix->rows; start++) {
+        if(placed[start] || permutation[start] == start)
+            continue;
+
+        memcpy(buffer, &MATRIX_ELEM(matrix, start, 0), row_size);
+        uint32_t current = start;
+
+        while(true) {
+            uint32_t next = permutation[current];
+            c3e_assert(next < matrix->rows && !placed[current]);
+
+            placed[current] = true;
+            if(next == start) {
+                memcpy(&MATRIX_ELEM(matrix, current, 0), buffer, row_size);
+                break;
+            }
+
+            memcpy(&MATRIX_ELEM(matrix, current, 0), &MATRIX_ELEM(matrix, next, 0), row_size);
+            current = next;
+        }
+    }
+
+    free(buffer);
+    free(placed);
+
+    return true;
+}
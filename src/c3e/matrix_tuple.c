@@ -22,7 +22,6 @@
 
 c3e_matrix_tuple c3e_matrix_qr_decomp(c3e_matrix* matrix) {
     c3e_assert(matrix->rows == matrix->cols);
-    c3e_assert(c3e_matrix_determinant(matrix) != 0.0);
 
     c3e_matrix* original = c3e_matrix_copy(matrix);
     c3e_matrix* orthogonal = c3e_matrix_zeros(matrix->rows, matrix->cols);
@@ -39,6 +38,8 @@ c3e_matrix_tuple c3e_matrix_qr_decomp(c3e_matrix* matrix) {
         }
 
         c3e_number norm = c3e_vector_length(orthogonal, i);
+        c3e_assert(norm != 0.0);
+
         MATRIX_ELEM(uppertri, i, i) = norm;
         c3e_matrix_col_div(orthogonal, i, norm);
     }
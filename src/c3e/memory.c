@@ -0,0 +1,476 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#define _GNU_SOURCE
+
+#include <c3e/context.h>
+#include <c3e/memory.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define C3E_MEMORY_HEADER 64
+
+typedef union c3e_memory_block c3e_memory_block;
+
+union c3e_memory_block {
+    struct {
+        size_t size;
+        size_t length;
+        off_t offset;
+        c3e_memory_block* prev;
+        c3e_memory_block* next;
+        void (*release)(void*, void*);
+        void* state;
+        bool mapped;
+        bool spilled;
+        bool spilling;
+        bool idle;
+    };
+    uint8_t padding[C3E_MEMORY_HEADER];
+};
+
+static pthread_mutex_t c3e_memory_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t c3e_memory_moved = PTHREAD_COND_INITIALIZER;
+static c3e_memory_block* c3e_memory_oldest = NULL;
+static c3e_memory_block* c3e_memory_newest = NULL;
+
+static size_t c3e_memory_limit = 0;
+static size_t c3e_memory_used = 0;
+static size_t c3e_memory_swapped = 0;
+
+static char c3e_memory_directory[PATH_MAX] = {0};
+static int c3e_memory_fd = -1;
+static off_t c3e_memory_end = 0;
+
+static uintptr_t* c3e_memory_owned = NULL;
+static size_t c3e_memory_slots = 0;
+static size_t c3e_memory_buffers = 0;
+
+static inline c3e_memory_block* c3e_memory_header(void* data) {
+    return (c3e_memory_block*) ((uint8_t*) data - C3E_MEMORY_HEADER);
+}
+
+static inline size_t c3e_memory_slot(uintptr_t key) {
+    return (size_t) (((uint64_t) key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (c3e_memory_slots - 1);
+}
+
+static void c3e_memory_place(uintptr_t key) {
+    size_t slot = c3e_memory_slot(key);
+
+    while(c3e_memory_owned[slot] != 0)
+        slot = (slot + 1) & (c3e_memory_slots - 1);
+    c3e_memory_owned[slot] = key;
+}
+
+static bool c3e_memory_track(void* data) {
+    if((c3e_memory_buffers + 1) * 2 > c3e_memory_slots) {
+        uintptr_t* previous = c3e_memory_owned;
+        size_t count = c3e_memory_slots;
+        size_t slots = count != 0 ? count * 2 : 1024;
+        uintptr_t* owned = (uintptr_t*) calloc(slots, sizeof(uintptr_t));
+
+        if(owned == NULL)
+            return false;
+
+        c3e_memory_owned = owned;
+        c3e_memory_slots = slots;
+
+        for(size_t i = 0; i < count; i++)
+            if(previous[i] != 0)
+                c3e_memory_place(previous[i]);
+        free(previous);
+    }
+
+    c3e_memory_place((uintptr_t) data);
+    c3e_memory_buffers++;
+
+    return true;
+}
+
+static bool c3e_memory_untrack(void* data) {
+    if(c3e_memory_slots == 0)
+        return false;
+
+    size_t mask = c3e_memory_slots - 1;
+    size_t slot = c3e_memory_slot((uintptr_t) data);
+
+    while(c3e_memory_owned[slot] != (uintptr_t) data)
+        if(c3e_memory_owned[slot] == 0)
+            return false;
+        else slot = (slot + 1) & mask;
+
+    size_t hole = slot;
+    for(size_t next = (hole + 1) & mask; c3e_memory_owned[next] != 0; next = (next + 1) & mask) {
+        size_t home = c3e_memory_slot(c3e_memory_owned[next]);
+
+        if(((next - home) & mask) >= ((next - hole) & mask)) {
+            c3e_memory_owned[hole] = c3e_memory_owned[next];
+            hole = next;
+        }
+    }
+
+    c3e_memory_owned[hole] = 0;
+    c3e_memory_buffers--;
+
+    return true;
+}
+
+static void c3e_memory_link(c3e_memory_block* block) {
+    block->prev = c3e_memory_newest;
+    block->next = NULL;
+
+    if(c3e_memory_newest != NULL)
+        c3e_memory_newest->next = block;
+    else c3e_memory_oldest = block;
+
+    c3e_memory_newest = block;
+}
+
+static void c3e_memory_unlink(c3e_memory_block* block) {
+    if(block->prev != NULL)
+        block->prev->next = block->next;
+    else c3e_memory_oldest = block->next;
+
+    if(block->next != NULL)
+        block->next->prev = block->prev;
+    else c3e_memory_newest = block->prev;
+
+    block->prev = block->next = NULL;
+}
+
+static bool c3e_memory_open_scratch(void) {
+    if(c3e_memory_fd >= 0)
+        return true;
+
+    const char* directory = c3e_memory_directory;
+    if(directory[0] == '\0' && (directory = getenv("TMPDIR")) == NULL)
+        directory = "/tmp";
+
+    char path[PATH_MAX];
+    if(snprintf(path, sizeof(path), "%s/c3e-spill-XXXXXX", directory) >= (int) sizeof(path))
+        return false;
+
+    c3e_memory_fd = mkstemp(path);
+    if(c3e_memory_fd < 0)
+        return false;
+
+    unlink(path);
+    return true;
+}
+
+static bool c3e_memory_write(int fd, const void* data, size_t size, off_t offset) {
+    const uint8_t* cursor = (const uint8_t*) data;
+
+    while(size != 0) {
+        ssize_t written = pwrite(fd, cursor, size, offset);
+
+        if(written < 0 && errno == EINTR)
+            continue;
+        else if(written <= 0)
+            return false;
+
+        cursor += written;
+        size -= (size_t) written;
+        offset += written;
+    }
+
+    return true;
+}
+
+static void c3e_memory_discard(c3e_memory_block* block) {
+    c3e_memory_swapped -= block->length;
+
+    if(c3e_memory_swapped == 0 && ftruncate(c3e_memory_fd, 0) == 0)
+        c3e_memory_end = 0;
+#ifdef FALLOC_FL_PUNCH_HOLE
+    else fallocate(
+        c3e_memory_fd,
+        FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+        block->offset,
+        (off_t) block->length
+    );
+#endif
+}
+
+static bool c3e_memory_spill(c3e_memory_block* block) {
+    if(!c3e_memory_open_scratch())
+        return false;
+
+    int fd = c3e_memory_fd;
+    size_t length = block->length;
+    off_t offset = c3e_memory_end;
+
+    c3e_memory_unlink(block);
+    block->spilled = true;
+    block->spilling = true;
+    block->offset = offset;
+
+    c3e_memory_end += (off_t) length;
+    c3e_memory_used -= length;
+    c3e_memory_swapped += length;
+    pthread_mutex_unlock(&c3e_memory_lock);
+
+    bool moved = c3e_memory_write(fd, block, length, offset) &&
+        mmap(block, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset) != MAP_FAILED;
+
+#ifdef MADV_COLD
+    if(moved)
+        madvise(block, length, MADV_COLD);
+#endif
+
+    pthread_mutex_lock(&c3e_memory_lock);
+    block->spilling = false;
+
+    if(!moved) {
+        c3e_memory_discard(block);
+        block->spilled = false;
+
+        c3e_memory_used += length;
+        c3e_memory_link(block);
+    }
+
+    pthread_cond_broadcast(&c3e_memory_moved);
+    return moved;
+}
+
+static void c3e_memory_enforce(size_t incoming) {
+    while(c3e_memory_limit != 0 && c3e_memory_oldest != NULL &&
+        c3e_memory_used + incoming > c3e_memory_limit)
+        if(!c3e_memory_spill(c3e_memory_oldest))
+            break;
+}
+
+static void c3e_memory_settle(c3e_memory_block* block) {
+    while(block->spilling)
+        pthread_cond_wait(&c3e_memory_moved, &c3e_memory_lock);
+}
+
+static void* c3e_memory_custom(c3e_allocator* allocator, size_t size) {
+    c3e_memory_block* block = (c3e_memory_block*) allocator->alloc(C3E_MEMORY_HEADER + size, allocator->state);
+    if(block == NULL)
+        return NULL;
+
+    memset(block, 0, C3E_MEMORY_HEADER + size);
+    block->size = size;
+    block->length = C3E_MEMORY_HEADER + size;
+    block->release = allocator->free;
+    block->state = allocator->state;
+
+    void* data = (uint8_t*) block + C3E_MEMORY_HEADER;
+    pthread_mutex_lock(&c3e_memory_lock);
+
+    bool tracked = c3e_memory_track(data);
+    pthread_mutex_unlock(&c3e_memory_lock);
+
+    if(!tracked) {
+        allocator->free(block, allocator->state);
+        return NULL;
+    }
+
+    return data;
+}
+
+static void* c3e_memory_block_alloc(size_t size) {
+    c3e_memory_block* block;
+    bool mapped = size >= C3E_MEMORY_SPILL_SIZE;
+    size_t length = C3E_MEMORY_HEADER + size;
+
+    if(mapped) {
+        size_t page = (size_t) sysconf(_SC_PAGESIZE);
+
+        length = (length + page - 1) / page * page;
+        pthread_mutex_lock(&c3e_memory_lock);
+        c3e_memory_enforce(length);
+        pthread_mutex_unlock(&c3e_memory_lock);
+
+        block = (c3e_memory_block*) mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(block == MAP_FAILED)
+            return NULL;
+    }
+    else {
+        void* memory = NULL;
+
+        if(posix_memalign(&memory, C3E_MEMORY_HEADER, length) != 0)
+            return NULL;
+
+        block = (c3e_memory_block*) memory;
+        memset(block, 0, length);
+    }
+
+    block->size = size;
+    block->length = length;
+    block->offset = 0;
+    block->release = NULL;
+    block->mapped = mapped;
+    block->spilled = false;
+    block->spilling = false;
+    block->idle = false;
+
+    void* data = (uint8_t*) block + C3E_MEMORY_HEADER;
+    pthread_mutex_lock(&c3e_memory_lock);
+
+    bool tracked = c3e_memory_track(data);
+    if(tracked)
+        c3e_memory_used += length;
+    pthread_mutex_unlock(&c3e_memory_lock);
+
+    if(!tracked) {
+        if(mapped)
+            munmap(block, length);
+        else free(block);
+
+        return NULL;
+    }
+
+    return data;
+}
+
+void* c3e_memory_alloc(size_t size) {
+    c3e_context* context = c3e_context_current();
+    c3e_allocator* allocator = &context->settings.allocator;
+    void* data = NULL;
+
+    if(size <= SIZE_MAX - 2 * C3E_MEMORY_HEADER - (size_t) sysconf(_SC_PAGESIZE))
+        data = allocator->alloc != NULL ?
+            c3e_memory_custom(allocator, size) :
+            c3e_memory_block_alloc(size);
+
+    if(data == NULL) {
+        context->error = ENOMEM;
+        return NULL;
+    }
+
+    context->counters.allocations++;
+    context->counters.bytes += size;
+
+    return data;
+}
+
+void c3e_memory_free(void* data) {
+    if(data == NULL)
+        return;
+
+    pthread_mutex_lock(&c3e_memory_lock);
+    if(!c3e_memory_untrack(data)) {
+        pthread_mutex_unlock(&c3e_memory_lock);
+
+        free(data);
+        return;
+    }
+
+    c3e_memory_block* block = c3e_memory_header(data);
+    c3e_context_current()->counters.frees++;
+
+    if(block->release != NULL) {
+        pthread_mutex_unlock(&c3e_memory_lock);
+
+        block->release(block, block->state);
+        return;
+    }
+
+    bool mapped = block->mapped;
+    size_t length = block->length;
+
+    c3e_memory_settle(block);
+
+    if(block->spilled)
+        c3e_memory_discard(block);
+    else {
+        c3e_memory_used -= length;
+
+        if(block->idle)
+            c3e_memory_unlink(block);
+    }
+    pthread_mutex_unlock(&c3e_memory_lock);
+
+    if(mapped)
+        munmap(block, length);
+    else free(block);
+}
+
+void c3e_memory_idle(void* data) {
+    c3e_memory_block* block = c3e_memory_header(data);
+    if(!block->mapped || block->release != NULL)
+        return;
+
+    pthread_mutex_lock(&c3e_memory_lock);
+    c3e_memory_settle(block);
+
+    if(!block->spilled) {
+        if(block->idle)
+            c3e_memory_unlink(block);
+
+        c3e_memory_link(block);
+    }
+
+    block->idle = true;
+    c3e_memory_enforce(0);
+    pthread_mutex_unlock(&c3e_memory_lock);
+}
+
+void c3e_memory_touch(void* data) {
+    c3e_memory_block* block = c3e_memory_header(data);
+    if(!block->mapped || block->release != NULL)
+        return;
+
+    pthread_mutex_lock(&c3e_memory_lock);
+    c3e_memory_settle(block);
+
+    if(block->idle && !block->spilled)
+        c3e_memory_unlink(block);
+
+    block->idle = false;
+    pthread_mutex_unlock(&c3e_memory_lock);
+}
+
+void c3e_memory_set_budget(size_t budget) {
+    pthread_mutex_lock(&c3e_memory_lock);
+    c3e_memory_limit = budget;
+    c3e_memory_enforce(0);
+    pthread_mutex_unlock(&c3e_memory_lock);
+}
+
+void c3e_memory_set_scratch(const char* directory) {
+    pthread_mutex_lock(&c3e_memory_lock);
+    snprintf(c3e_memory_directory, sizeof(c3e_memory_directory), "%s", directory);
+    pthread_mutex_unlock(&c3e_memory_lock);
+}
+
+size_t c3e_memory_resident(void) {
+    pthread_mutex_lock(&c3e_memory_lock);
+    size_t resident = c3e_memory_used;
+    pthread_mutex_unlock(&c3e_memory_lock);
+
+    return resident;
+}
+
+size_t c3e_memory_spilled(void) {
+    pthread_mutex_lock(&c3e_memory_lock);
+    size_t spilled = c3e_memory_swapped;
+    pthread_mutex_unlock(&c3e_memory_lock);
+
+    return spilled;
+}
\ No newline at end of file
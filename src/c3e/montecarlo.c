@@ -0,0 +1,225 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/montecarlo.h>
+#include <c3e/pool.h>
+#include <c3e/vector.h>
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#define C3E_MONTECARLO_PARALLEL 16384
+
+typedef struct {
+    c3e_montecarlo_kernel kernel;
+    void* context;
+    uint64_t paths;
+    uint32_t outputs;
+    uint32_t batch_size;
+    uint64_t batches;
+    uint64_t seed;
+    c3e_number* mean;
+    c3e_number* squares;
+    _Atomic uint64_t next;
+} c3e_montecarlo_job;
+
+typedef struct {
+    c3e_montecarlo_job* job;
+    c3e_vector* scratch;
+    c3e_number* values;
+    uint64_t first;
+    uint64_t last;
+    uint64_t width;
+} c3e_montecarlo_worker;
+
+static uint32_t c3e_montecarlo_threads(uint32_t threads) {
+    return threads != 0 ? threads : c3e_pool_size();
+}
+
+static uint64_t c3e_montecarlo_count(c3e_montecarlo_job* job, uint64_t batch) {
+    uint64_t first = batch * job->batch_size;
+    return job->paths - first < job->batch_size ? job->paths - first : job->batch_size;
+}
+
+static void c3e_montecarlo_summarize(c3e_montecarlo_job* job, uint64_t batch, const c3e_number* values, uint32_t paths) {
+    c3e_number* mean = job->mean + batch * job->outputs;
+    c3e_number* squares = job->squares + batch * job->outputs;
+
+    for(uint32_t j = 0; j < job->outputs; j++) {
+        c3e_number sum = 0.0;
+        for(uint32_t i = 0; i < paths; i++)
+            sum += values[(size_t) i * job->outputs + j];
+
+        c3e_number average = sum / paths, deviations = 0.0;
+        for(uint32_t i = 0; i < paths; i++) {
+            c3e_number delta = values[(size_t) i * job->outputs + j] - average;
+            deviations += delta * delta;
+        }
+
+        mean[j] = average;
+        squares[j] = deviations;
+    }
+}
+
+static void c3e_montecarlo_simulate(void* argument) {
+    c3e_montecarlo_worker* worker = (c3e_montecarlo_worker*) argument;
+    c3e_montecarlo_job* job = worker->job;
+    c3e_rng rng;
+
+    while(true) {
+        uint64_t batch = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if(batch >= job->batches)
+            return;
+
+        uint32_t paths = (uint32_t) c3e_montecarlo_count(job, batch);
+        c3e_rng_init(&rng, job->seed, batch);
+
+        job->kernel(&rng, batch * job->batch_size, paths, worker->scratch, worker->values, job->context);
+        c3e_montecarlo_summarize(job, batch, worker->values, paths);
+    }
+}
+
+static void c3e_montecarlo_merge(void* argument) {
+    c3e_montecarlo_worker* worker = (c3e_montecarlo_worker*) argument;
+    c3e_montecarlo_job* job = worker->job;
+    uint64_t width = worker->width;
+
+    for(uint64_t left = worker->first; left < worker->last; left += 2 * width) {
+        uint64_t right = left + width;
+        if(right >= job->batches)
+            break;
+
+        c3e_number n_left = (c3e_number) (right * job->batch_size - left * job->batch_size);
+        uint64_t end = right + width < job->batches ? right + width : job->batches;
+        c3e_number n_right = (c3e_number) ((end - 1 - right) * job->batch_size + c3e_montecarlo_count(job, end - 1));
+        c3e_number total = n_left + n_right;
+
+        for(uint32_t j = 0; j < job->outputs; j++) {
+            c3e_number* mean = job->mean + left * job->outputs + j;
+            c3e_number* squares = job->squares + left * job->outputs + j;
+            c3e_number delta = job->mean[right * job->outputs + j] - *mean;
+
+            *mean += delta * n_right / total;
+            *squares += job->squares[right * job->outputs + j] + delta * delta * n_left * n_right / total;
+        }
+    }
+}
+
+static void c3e_montecarlo_reduce(c3e_montecarlo_job* job, c3e_montecarlo_worker* workers, uint32_t threads) {
+    for(uint64_t width = 1; width < job->batches; width *= 2) {
+        uint64_t pairs = (job->batches + 2 * width - 1) / (2 * width);
+        uint32_t count = pairs * job->outputs < C3E_MONTECARLO_PARALLEL ? 1 :
+            (pairs < threads ? (uint32_t) pairs : threads);
+
+        for(uint32_t i = 0; i < count; i++) {
+            workers[i].first = pairs * i / count * 2 * width;
+            workers[i].last = pairs * (i + 1) / count * 2 * width;
+            workers[i].width = width;
+        }
+
+        c3e_parallel_invoke(c3e_montecarlo_merge, workers, sizeof(c3e_montecarlo_worker), count);
+    }
+}
+
+c3e_montecarlo* c3e_montecarlo_run(c3e_montecarlo_kernel kernel, void* context, uint64_t paths, uint32_t outputs, uint32_t batch_size, size_t scratch_size, uint64_t seed, uint32_t threads) {
+    c3e_assert(kernel != NULL && paths >= 2);
+    c3e_assert(outputs != 0 && batch_size != 0);
+
+    c3e_montecarlo_job job = {
+        .kernel = kernel,
+        .context = context,
+        .paths = paths,
+        .outputs = outputs,
+        .batch_size = batch_size,
+        .batches = (paths + batch_size - 1) / batch_size,
+        .seed = seed
+    };
+
+    threads = c3e_montecarlo_threads(threads);
+    if(threads > job.batches)
+        threads = (uint32_t) job.batches;
+
+    atomic_init(&job.next, 0);
+    job.mean = (c3e_number*) malloc(job.batches * outputs * sizeof(c3e_number));
+    job.squares = (c3e_number*) malloc(job.batches * outputs * sizeof(c3e_number));
+
+    c3e_montecarlo_worker* workers = (c3e_montecarlo_worker*) calloc(threads, sizeof(c3e_montecarlo_worker));
+    c3e_montecarlo* result = (c3e_montecarlo*) calloc(1, sizeof(c3e_montecarlo));
+    bool allocated = job.mean != NULL && job.squares != NULL && workers != NULL && result != NULL;
+
+    for(uint32_t i = 0; allocated && i < threads; i++) {
+        workers[i].job = &job;
+        workers[i].values = (c3e_number*) malloc((size_t) batch_size * outputs * sizeof(c3e_number));
+        allocated = workers[i].values != NULL;
+
+        if(allocated && scratch_size != 0)
+            allocated = (workers[i].scratch = c3e_vector_init(scratch_size)) != NULL;
+    }
+
+    if(allocated) {
+        c3e_parallel_invoke(c3e_montecarlo_simulate, workers, sizeof(c3e_montecarlo_worker), threads);
+        c3e_montecarlo_reduce(&job, workers, threads);
+
+        result->paths = paths;
+        result->outputs = outputs;
+        result->mean = c3e_vector_init(outputs);
+        result->variance = c3e_vector_init(outputs);
+        result->error = c3e_vector_init(outputs);
+        allocated = result->mean != NULL && result->variance != NULL && result->error != NULL;
+    }
+
+    for(uint32_t j = 0; allocated && j < outputs; j++) {
+        result->mean->data[j] = job.mean[j];
+        result->variance->data[j] = job.squares[j] / (c3e_number) (paths - 1);
+        result->error->data[j] = sqrt(result->variance->data[j] / (c3e_number) paths);
+    }
+
+    for(uint32_t i = 0; workers != NULL && i < threads; i++) {
+        free(workers[i].values);
+
+        if(workers[i].scratch != NULL)
+            c3e_vector_free(workers[i].scratch);
+    }
+
+    free(workers);
+    free(job.mean);
+    free(job.squares);
+
+    if(!allocated && result != NULL) {
+        c3e_montecarlo_free(result);
+        return NULL;
+    }
+
+    return result;
+}
+
+void c3e_montecarlo_free(c3e_montecarlo* result) {
+    c3e_assert(result != NULL);
+
+    if(result->mean != NULL)
+        c3e_vector_free(result->mean);
+
+    if(result->variance != NULL)
+        c3e_vector_free(result->variance);
+
+    if(result->error != NULL)
+        c3e_vector_free(result->error);
+
+    free(result);
+}
\ No newline at end of file
@@ -16,11 +16,20 @@
  */
 
 #include <c3e/assert.h>
+#include <c3e/matrix.h>
+#include <c3e/memory.h>
 #include <c3e/net.h>
+#include <c3e/tensor.h>
+#include <c3e/vector.h>
 
+#include <errno.h>
+#include <limits.h>
 #include <string.h>
+#include <sys/sendfile.h>
 #include <unistd.h>
 
+#define C3E_WIRE_BATCH 65536
+
 void c3e_socket_init(c3e_socket* wsocket, const char* hostname, int port) {
     c3e_assert(wsocket != NULL);
     c3e_assert(hostname != NULL);
@@ -28,6 +37,7 @@ void c3e_socket_init(c3e_socket* wsocket, const char* hostname, int port) {
     wsocket->hostname = strdup(hostname);
     wsocket->port = port;
     wsocket->sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    wsocket->codec = C3E_CODEC_NONE;
 
     c3e_assert(wsocket->sockfd >= 0);
 
@@ -38,6 +48,81 @@ void c3e_socket_init(c3e_socket* wsocket, const char* hostname, int port) {
     c3e_assert(connect(wsocket->sockfd, (struct sockaddr*) &wsocket->server_addr, sizeof(wsocket->server_addr)) >= 0);
 }
 
+bool c3e_socket_connect(c3e_socket* wsocket, const char* hostname, int port) {
+    c3e_assert(wsocket != NULL);
+    c3e_assert(hostname != NULL);
+
+    memset(wsocket, 0, sizeof(c3e_socket));
+    wsocket->port = port;
+    wsocket->codec = C3E_CODEC_NONE;
+    wsocket->server_addr.sin_family = AF_INET;
+    wsocket->server_addr.sin_port = htons(port);
+
+    if(inet_pton(AF_INET, hostname, &wsocket->server_addr.sin_addr) <= 0)
+        return false;
+
+    wsocket->sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if(wsocket->sockfd < 0)
+        return false;
+
+    if(connect(wsocket->sockfd, (struct sockaddr*) &wsocket->server_addr, sizeof(wsocket->server_addr)) < 0) {
+        close(wsocket->sockfd);
+        return false;
+    }
+
+    wsocket->hostname = strdup(hostname);
+    return true;
+}
+
+bool c3e_socket_listen(c3e_socket* wsocket, const char* hostname, int port, int backlog) {
+    c3e_assert(wsocket != NULL);
+    c3e_assert(hostname != NULL);
+
+    memset(wsocket, 0, sizeof(c3e_socket));
+    wsocket->port = port;
+    wsocket->codec = C3E_CODEC_NONE;
+    wsocket->server_addr.sin_family = AF_INET;
+    wsocket->server_addr.sin_port = htons(port);
+
+    if(inet_pton(AF_INET, hostname, &wsocket->server_addr.sin_addr) <= 0)
+        return false;
+
+    wsocket->sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if(wsocket->sockfd < 0)
+        return false;
+
+    int reuse = 1;
+    setsockopt(wsocket->sockfd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if(bind(wsocket->sockfd, (struct sockaddr*) &wsocket->server_addr, sizeof(wsocket->server_addr)) < 0 ||
+        listen(wsocket->sockfd, backlog) < 0) {
+        close(wsocket->sockfd);
+        return false;
+    }
+
+    wsocket->hostname = strdup(hostname);
+    return true;
+}
+
+bool c3e_socket_accept(c3e_socket* server, c3e_socket* client) {
+    c3e_assert(server != NULL);
+    c3e_assert(client != NULL);
+
+    socklen_t length = sizeof(client->server_addr);
+    memset(client, 0, sizeof(c3e_socket));
+
+    do client->sockfd = accept(server->sockfd, (struct sockaddr*) &client->server_addr, &length);
+    while(client->sockfd < 0 && errno == EINTR);
+
+    if(client->sockfd < 0)
+        return false;
+
+    client->port = ntohs(client->server_addr.sin_port);
+    client->codec = C3E_CODEC_NONE;
+
+    return true;
+}
+
 void c3e_socket_close(c3e_socket* socket) {
     if(socket != NULL) {
         close(socket->sockfd);
@@ -45,18 +130,160 @@ void c3e_socket_close(c3e_socket* socket) {
     }
 }
 
+bool c3e_socket_negotiate_codec(c3e_socket* socket, c3e_codec codec) {
+    c3e_assert(socket != NULL);
+
+    uint32_t proposed = (uint32_t) codec, peer;
+    if(!c3e_socket_send_data(socket, &proposed, sizeof(proposed)) ||
+        !c3e_socket_receive_data(socket, &peer, sizeof(peer)))
+        return false;
+
+    socket->codec = (c3e_codec) (peer < proposed ? peer : proposed);
+    return true;
+}
+
 bool c3e_socket_send_data(c3e_socket* socket, const void* data, size_t size) {
     c3e_assert(socket != NULL);
     c3e_assert(data != NULL);
     
-    return send(socket->sockfd, data, size, 0) == size;
+    const char* bytes = (const char*) data;
+    while(size > 0) {
+        ssize_t sent = send(socket->sockfd, bytes, size, MSG_NOSIGNAL);
+
+        if(sent < 0 && errno == EINTR)
+            continue;
+        else if(sent <= 0)
+            return false;
+
+        bytes += sent;
+        size -= (size_t) sent;
+    }
+
+    return true;
 }
 
 bool c3e_socket_receive_data(c3e_socket* socket, void* buffer, size_t size) {
     c3e_assert(socket != NULL);
     c3e_assert(buffer != NULL);
 
-    return recv(socket->sockfd, buffer, size, 0) == size;
+    char* bytes = (char*) buffer;
+    while(size > 0) {
+        ssize_t received = recv(socket->sockfd, bytes, size, MSG_WAITALL);
+
+        if(received < 0 && errno == EINTR)
+            continue;
+        else if(received <= 0)
+            return false;
+
+        bytes += received;
+        size -= (size_t) received;
+    }
+
+    return true;
+}
+
+static bool c3e_socket_send_numbers(c3e_socket* socket, const c3e_number* data, size_t count, c3e_codec codec) {
+    if(codec == C3E_CODEC_NONE)
+        return c3e_socket_send_data(socket, data, count * sizeof(c3e_number));
+
+    size_t block = count < C3E_CODEC_BLOCK ? count : C3E_CODEC_BLOCK;
+    size_t capacity = c3e_codec_bound(codec, block);
+    void* buffer = malloc(capacity);
+
+    if(buffer == NULL)
+        return false;
+
+    bool sent = true;
+    size_t first = 0;
+
+    do {
+        size_t length = count - first < block ? count - first : block;
+        uint64_t size = c3e_codec_encode(codec, data + first, length, buffer, capacity);
+
+        sent = size != 0 &&
+            c3e_socket_send_data(socket, &size, sizeof(size)) &&
+            c3e_socket_send_data(socket, buffer, size);
+        first += length;
+    } while(sent && first < count);
+
+    free(buffer);
+    return sent;
+}
+
+static bool c3e_socket_receive_numbers(c3e_socket* socket, c3e_number* data, size_t count, c3e_codec codec) {
+    if(codec == C3E_CODEC_NONE)
+        return c3e_socket_receive_data(socket, data, count * sizeof(c3e_number));
+
+    size_t block = count < C3E_CODEC_BLOCK ? count : C3E_CODEC_BLOCK;
+    size_t capacity = c3e_codec_bound(codec, block);
+    void* buffer = malloc(capacity);
+
+    if(buffer == NULL)
+        return false;
+
+    bool received = true;
+    size_t first = 0;
+
+    do {
+        size_t length = count - first < block ? count - first : block;
+        uint64_t size;
+
+        received = c3e_socket_receive_data(socket, &size, sizeof(size)) &&
+            size <= c3e_codec_bound(codec, length) &&
+            c3e_socket_receive_data(socket, buffer, size) &&
+            c3e_codec_decode(buffer, size, data + first, length);
+        first += length;
+    } while(received && first < count);
+
+    free(buffer);
+    return received;
+}
+
+static bool c3e_socket_send_elements(c3e_socket* socket, const c3e_number* data, size_t count, c3e_dtype dtype) {
+    if(dtype == C3E_DTYPE_NATIVE)
+        return c3e_socket_send_numbers(socket, data, count, socket->codec);
+
+    size_t width = c3e_dtype_size(dtype);
+    size_t batch = count < C3E_WIRE_BATCH ? count : C3E_WIRE_BATCH;
+    void* buffer = malloc(batch * width);
+
+    if(buffer == NULL && batch != 0)
+        return false;
+
+    bool sent = true;
+    for(size_t i = 0; sent && i < count; i += batch) {
+        size_t length = count - i < batch ? count - i : batch;
+
+        c3e_dtype_narrow(dtype, data + i, buffer, length);
+        sent = c3e_socket_send_data(socket, buffer, length * width);
+    }
+
+    free(buffer);
+    return sent;
+}
+
+static bool c3e_socket_receive_elements(c3e_socket* socket, c3e_number* data, size_t count, c3e_dtype dtype, c3e_codec codec) {
+    if(dtype == C3E_DTYPE_NATIVE)
+        return c3e_socket_receive_numbers(socket, data, count, codec);
+
+    size_t width = c3e_dtype_size(dtype);
+    size_t batch = count < C3E_WIRE_BATCH ? count : C3E_WIRE_BATCH;
+    void* buffer = malloc(batch * width);
+
+    if(buffer == NULL && batch != 0)
+        return false;
+
+    bool received = true;
+    for(size_t i = 0; received && i < count; i += batch) {
+        size_t length = count - i < batch ? count - i : batch;
+
+        received = c3e_socket_receive_data(socket, buffer, length * width);
+        if(received)
+            c3e_dtype_widen(dtype, buffer, data + i, length);
+    }
+
+    free(buffer);
+    return received;
 }
 
 void c3e_socket_send_tensor(c3e_socket* socket, c3e_tensor* tensor) {
@@ -75,14 +302,14 @@ void c3e_socket_send_matrix(c3e_socket* socket, c3e_matrix* matrix) {
 
     c3e_socket_send_data(socket, &matrix->rows, sizeof(matrix->rows));
     c3e_socket_send_data(socket, &matrix->cols, sizeof(matrix->cols));
-    c3e_socket_send_data(socket, matrix->data, matrix->rows * matrix->cols * sizeof(c3e_number));
+    c3e_socket_send_numbers(socket, matrix->data, (size_t) matrix->rows * matrix->cols, socket->codec);
 }
 
 void c3e_socket_send_vector(c3e_socket* socket, c3e_vector* vector) {
     c3e_assert(vector != NULL);
 
     c3e_socket_send_data(socket, &vector->size, sizeof(vector->size));
-    c3e_socket_send_data(socket, vector->data, vector->size * sizeof(c3e_number));
+    c3e_socket_send_numbers(socket, vector->data, vector->size, socket->codec);
 }
 
 void c3e_socket_send_number(c3e_socket* socket, c3e_number number) {
@@ -109,8 +336,8 @@ c3e_matrix* c3e_socket_matrix_read(c3e_socket* socket) {
     c3e_socket_receive_data(socket, &matrix->rows, sizeof(matrix->rows));
     c3e_socket_receive_data(socket, &matrix->cols, sizeof(matrix->cols));
 
-    matrix->data = (c3e_number*) malloc(matrix->rows * matrix->cols * sizeof(c3e_number));
-    c3e_socket_receive_data(socket, matrix->data, matrix->rows * matrix->cols * sizeof(c3e_number));
+    matrix->data = (c3e_number*) c3e_memory_alloc((size_t) matrix->rows * matrix->cols * sizeof(c3e_number));
+    c3e_socket_receive_numbers(socket, matrix->data, (size_t) matrix->rows * matrix->cols, socket->codec);
 
     return matrix;
 }
@@ -119,8 +346,8 @@ c3e_vector* c3e_socket_vector_read(c3e_socket* socket) {
     c3e_vector* vector = (c3e_vector*)malloc(sizeof(c3e_vector));
     c3e_socket_receive_data(socket, &vector->size, sizeof(vector->size));
 
-    vector->data = (c3e_number*)malloc(vector->size * sizeof(c3e_number));
-    c3e_socket_receive_data(socket, vector->data, vector->size * sizeof(c3e_number));
+    vector->data = (c3e_number*) c3e_memory_alloc(vector->size * sizeof(c3e_number));
+    c3e_socket_receive_numbers(socket, vector->data, vector->size, socket->codec);
 
     return vector;
 }
@@ -130,4 +357,467 @@ c3e_number c3e_socket_number_read(c3e_socket* socket) {
     c3e_socket_receive_data(socket, &value, sizeof(c3e_number));
 
     return value;
+}
+
+static bool c3e_socket_send_header(c3e_socket* socket, uint32_t rows, uint32_t cols, c3e_dtype dtype) {
+    c3e_assert(c3e_dtype_size(dtype) != 0);
+
+    c3e_message_header header = {0};
+    header.magic = C3E_MESSAGE_MAGIC;
+    header.dtype = (uint8_t) dtype;
+    header.codec = (uint8_t) (dtype == C3E_DTYPE_NATIVE ? socket->codec : C3E_CODEC_NONE);
+    header.rows = rows;
+    header.cols = cols;
+
+    return c3e_socket_send_data(socket, &header, sizeof(header));
+}
+
+static bool c3e_socket_receive_header(c3e_socket* socket, c3e_message_header* header) {
+    return c3e_socket_receive_data(socket, header, sizeof(c3e_message_header)) &&
+        header->magic == C3E_MESSAGE_MAGIC &&
+        c3e_dtype_size((c3e_dtype) header->dtype) != 0 &&
+        header->codec <= C3E_CODEC_XOR_LZ;
+}
+
+bool c3e_socket_send_matrix_typed(c3e_socket* socket, c3e_matrix* matrix, c3e_dtype dtype) {
+    c3e_assert(socket != NULL);
+    c3e_assert(matrix != NULL);
+
+    return c3e_socket_send_header(socket, matrix->rows, matrix->cols, dtype) &&
+        c3e_socket_send_elements(socket, matrix->data, (size_t) matrix->rows * matrix->cols, dtype);
+}
+
+bool c3e_socket_send_vector_typed(c3e_socket* socket, c3e_vector* vector, c3e_dtype dtype) {
+    c3e_assert(socket != NULL);
+    c3e_assert(vector != NULL);
+
+    return c3e_socket_send_header(socket, vector->size, 1, dtype) &&
+        c3e_socket_send_elements(socket, vector->data, vector->size, dtype);
+}
+
+bool c3e_socket_send_tensor_typed(c3e_socket* socket, c3e_tensor* tensor, c3e_dtype dtype) {
+    c3e_assert(tensor != NULL);
+
+    if(!c3e_socket_send_data(socket, &tensor->dimensions, sizeof(tensor->dimensions)) ||
+        !c3e_socket_send_data(socket, &tensor->dimension_size, sizeof(tensor->dimension_size)))
+        return false;
+
+    for(uint32_t i = 0; i < tensor->dimensions; ++i)
+        if(!c3e_socket_send_matrix_typed(socket, tensor->matrices[i], dtype))
+            return false;
+
+    return c3e_socket_send_vector_typed(socket, tensor->data, dtype);
+}
+
+static bool c3e_socket_copy_file(c3e_socket* socket, int fd, off_t offset, size_t size) {
+    size_t batch = size < C3E_WIRE_BATCH ? size : C3E_WIRE_BATCH;
+    char* buffer = (char*) malloc(batch);
+
+    if(buffer == NULL)
+        return false;
+
+    bool sent = true;
+    while(sent && size > 0) {
+        ssize_t length = pread(fd, buffer, size < batch ? size : batch, offset);
+
+        if(length < 0 && errno == EINTR)
+            continue;
+
+        sent = length > 0 && c3e_socket_send_data(socket, buffer, (size_t) length);
+        if(sent) {
+            offset += length;
+            size -= (size_t) length;
+        }
+    }
+
+    free(buffer);
+    return sent;
+}
+
+bool c3e_socket_send_file_matrix(c3e_socket* socket, int fd, uint64_t offset, uint32_t rows, uint32_t cols, c3e_dtype dtype) {
+    c3e_assert(socket != NULL);
+    c3e_assert(fd >= 0);
+    c3e_assert(c3e_dtype_size(dtype) != 0);
+
+    c3e_message_header header = {0};
+    header.magic = C3E_MESSAGE_MAGIC;
+    header.dtype = (uint8_t) dtype;
+    header.codec = C3E_CODEC_NONE;
+    header.rows = rows;
+    header.cols = cols;
+
+    const char* bytes = (const char*) &header;
+    size_t left = sizeof(header);
+    size_t size = (size_t) rows * cols * c3e_dtype_size(dtype);
+
+    while(left > 0) {
+        ssize_t sent = send(socket->sockfd, bytes, left, (size != 0 ? MSG_MORE : 0) | MSG_NOSIGNAL);
+
+        if(sent < 0 && errno == EINTR)
+            continue;
+        else if(sent <= 0)
+            return false;
+
+        bytes += sent;
+        left -= (size_t) sent;
+    }
+
+    off_t position = (off_t) offset;
+
+    while(size > 0) {
+        ssize_t sent = sendfile(socket->sockfd, fd, &position, size);
+
+        if(sent < 0 && errno == EINTR)
+            continue;
+        else if(sent < 0 && (errno == EINVAL || errno == ENOSYS))
+            return c3e_socket_copy_file(socket, fd, position, size);
+        else if(sent <= 0)
+            return false;
+
+        size -= (size_t) sent;
+    }
+
+    return true;
+}
+
+c3e_matrix* c3e_socket_typed_matrix_read(c3e_socket* socket) {
+    c3e_assert(socket != NULL);
+
+    c3e_message_header header;
+    if(!c3e_socket_receive_header(socket, &header))
+        return NULL;
+
+    c3e_matrix* matrix = c3e_matrix_init(header.rows, header.cols);
+    if(matrix == NULL)
+        return NULL;
+
+    if(!c3e_socket_receive_elements(
+        socket, matrix->data,
+        (size_t) header.rows * header.cols,
+        (c3e_dtype) header.dtype,
+        (c3e_codec) header.codec
+    )) {
+        c3e_matrix_free(matrix);
+        return NULL;
+    }
+
+    return matrix;
+}
+
+c3e_vector* c3e_socket_typed_vector_read(c3e_socket* socket) {
+    c3e_assert(socket != NULL);
+
+    c3e_message_header header;
+    if(!c3e_socket_receive_header(socket, &header) || header.cols != 1)
+        return NULL;
+
+    c3e_vector* vector = c3e_vector_init(header.rows);
+    if(vector == NULL)
+        return NULL;
+
+    if(!c3e_socket_receive_elements(
+        socket, vector->data, header.rows,
+        (c3e_dtype) header.dtype,
+        (c3e_codec) header.codec
+    )) {
+        c3e_vector_free(vector);
+        return NULL;
+    }
+
+    return vector;
+}
+
+c3e_tensor* c3e_socket_typed_tensor_read(c3e_socket* socket) {
+    uint32_t dimensions;
+    size_t dimension_size;
+
+    if(!c3e_socket_receive_data(socket, &dimensions, sizeof(dimensions)) ||
+        !c3e_socket_receive_data(socket, &dimension_size, sizeof(dimension_size)) ||
+        dimensions == 0)
+        return NULL;
+
+    c3e_matrix** matrices = (c3e_matrix**) malloc(dimensions * sizeof(c3e_matrix*));
+    if(matrices == NULL)
+        return NULL;
+
+    uint32_t received = 0;
+    for(; received < dimensions; received++)
+        if((matrices[received] = c3e_socket_typed_matrix_read(socket)) == NULL)
+            break;
+
+    c3e_vector* data = received == dimensions ?
+        c3e_socket_typed_vector_read(socket) : NULL;
+    c3e_tensor* tensor = data != NULL && data->size == dimension_size ?
+        c3e_tensor_init(dimension_size, dimensions, matrices, data) : NULL;
+
+    if(tensor == NULL) {
+        for(uint32_t i = 0; i < received; i++)
+            c3e_matrix_free(matrices[i]);
+
+        if(data != NULL)
+            c3e_vector_free(data);
+    }
+
+    free(matrices);
+    return tensor;
+}
+
+static bool c3e_matrix_stream_grant(c3e_matrix_stream* stream, uint32_t credits) {
+    if(stream->granted + credits > stream->chunks)
+        credits = (uint32_t) (stream->chunks - stream->granted);
+
+    if(credits == 0)
+        return true;
+
+    stream->granted += credits;
+    return c3e_socket_send_data(stream->socket, &credits, sizeof(credits));
+}
+
+static bool c3e_matrix_stream_reserve(c3e_matrix_stream* stream) {
+    size_t elements = (size_t) stream->chunk_rows * stream->cols;
+
+    if(stream->dtype != C3E_DTYPE_NATIVE)
+        stream->buffer_size = elements * c3e_dtype_size(stream->dtype);
+    else if(stream->codec != C3E_CODEC_NONE)
+        stream->buffer_size = c3e_codec_bound(stream->codec, elements);
+    else return true;
+
+    stream->buffer = malloc(stream->buffer_size);
+    return stream->buffer != NULL;
+}
+
+bool c3e_matrix_stream_open(c3e_matrix_stream* stream, c3e_socket* socket, uint64_t rows, uint64_t cols, uint32_t chunk_rows, c3e_dtype dtype) {
+    c3e_assert(stream != NULL);
+    c3e_assert(socket != NULL);
+    c3e_assert(chunk_rows != 0);
+    c3e_assert(c3e_dtype_size(dtype) != 0);
+    c3e_assert(chunk_rows * cols * sizeof(c3e_number) <= UINT32_MAX);
+
+    c3e_stream_header header = {0};
+    header.magic = C3E_STREAM_MAGIC;
+    header.version = C3E_STREAM_VERSION;
+    header.rows = rows;
+    header.cols = cols;
+    header.chunk_rows = chunk_rows;
+    header.dtype = (uint8_t) dtype;
+    header.codec = (uint8_t) (dtype == C3E_DTYPE_NATIVE ? socket->codec : C3E_CODEC_NONE);
+
+    memset(stream, 0, sizeof(c3e_matrix_stream));
+    stream->socket = socket;
+    stream->dtype = dtype;
+    stream->codec = (c3e_codec) header.codec;
+    stream->rows = rows;
+    stream->cols = cols;
+    stream->chunk_rows = chunk_rows;
+    stream->chunks = (rows + chunk_rows - 1) / chunk_rows;
+
+    if(!c3e_matrix_stream_reserve(stream))
+        return false;
+
+    if(!c3e_socket_send_data(socket, &header, sizeof(header)))
+        return false;
+
+    if(stream->chunks == 0)
+        return true;
+    return c3e_socket_receive_data(socket, &stream->credits, sizeof(stream->credits));
+}
+
+bool c3e_matrix_stream_write(c3e_matrix_stream* stream, const c3e_number* data, uint64_t count) {
+    c3e_assert(stream != NULL);
+    c3e_assert(data != NULL || count == 0);
+    c3e_assert(stream->position + count <= stream->rows);
+    c3e_assert(count % stream->chunk_rows == 0 || stream->position + count == stream->rows);
+
+    while(count > 0) {
+        while(stream->credits == 0) {
+            uint32_t credits;
+
+            if(!c3e_socket_receive_data(stream->socket, &credits, sizeof(credits)))
+                return false;
+            stream->credits += credits;
+        }
+
+        c3e_stream_chunk chunk;
+        chunk.row_offset = stream->position;
+        chunk.row_count = count < stream->chunk_rows ?
+            (uint32_t) count : stream->chunk_rows;
+
+        size_t elements = (size_t) chunk.row_count * stream->cols;
+        const void* payload = data;
+
+        if(stream->dtype != C3E_DTYPE_NATIVE) {
+            chunk.payload_size = (uint32_t) (elements * c3e_dtype_size(stream->dtype));
+            payload = stream->buffer;
+
+            c3e_dtype_narrow(stream->dtype, data, stream->buffer, elements);
+        }
+        else if(stream->codec == C3E_CODEC_NONE)
+            chunk.payload_size = (uint32_t) (elements * sizeof(c3e_number));
+        else {
+            chunk.payload_size = (uint32_t) c3e_codec_encode(
+                stream->codec, data, elements,
+                stream->buffer, stream->buffer_size
+            );
+            payload = stream->buffer;
+
+            if(chunk.payload_size == 0)
+                return false;
+        }
+
+        if(!c3e_socket_send_data(stream->socket, &chunk, sizeof(chunk)) ||
+            !c3e_socket_send_data(stream->socket, payload, chunk.payload_size))
+            return false;
+
+        data += (size_t) chunk.row_count * stream->cols;
+        count -= chunk.row_count;
+
+        stream->position += chunk.row_count;
+        stream->credits--;
+    }
+
+    return true;
+}
+
+bool c3e_matrix_stream_accept(c3e_matrix_stream* stream, c3e_socket* socket, uint32_t window) {
+    c3e_assert(stream != NULL);
+    c3e_assert(socket != NULL);
+    c3e_assert(window != 0);
+
+    c3e_stream_header header;
+    memset(stream, 0, sizeof(c3e_matrix_stream));
+
+    if(!c3e_socket_receive_data(socket, &header, sizeof(header)) ||
+        header.magic != C3E_STREAM_MAGIC ||
+        header.version != C3E_STREAM_VERSION ||
+        header.codec > C3E_CODEC_XOR_LZ ||
+        c3e_dtype_size((c3e_dtype) header.dtype) == 0 ||
+        (header.dtype != C3E_DTYPE_NATIVE && header.codec != C3E_CODEC_NONE) ||
+        header.chunk_rows == 0 || header.chunk_rows > INT_MAX || header.cols > INT_MAX ||
+        header.cols > UINT32_MAX / sizeof(c3e_number) / header.chunk_rows)
+        return false;
+
+    stream->socket = socket;
+    stream->rows = header.rows;
+    stream->cols = header.cols;
+    stream->chunk_rows = header.chunk_rows;
+    stream->window = window;
+    stream->dtype = (c3e_dtype) header.dtype;
+    stream->codec = (c3e_codec) header.codec;
+    stream->chunks = (header.rows + header.chunk_rows - 1) / header.chunk_rows;
+
+    if(stream->chunks == 0)
+        return true;
+
+    stream->block = c3e_matrix_init(header.chunk_rows, (int) header.cols);
+    if(stream->block == NULL || !c3e_matrix_stream_reserve(stream))
+        return false;
+
+    return c3e_matrix_stream_grant(stream, window);
+}
+
+c3e_matrix* c3e_matrix_stream_next(c3e_matrix_stream* stream, uint64_t* row_offset) {
+    c3e_assert(stream != NULL);
+
+    if(stream->credits != 0 && stream->granted < stream->chunks &&
+        (stream->credits >= stream->window / 2 || stream->credits == stream->chunks - stream->granted)) {
+        if(!c3e_matrix_stream_grant(stream, stream->credits))
+            return NULL;
+        stream->credits = 0;
+    }
+
+    if(stream->position >= stream->rows)
+        return NULL;
+
+    c3e_stream_chunk chunk;
+    if(!c3e_socket_receive_data(stream->socket, &chunk, sizeof(chunk)) ||
+        chunk.row_offset != stream->position ||
+        chunk.row_count == 0 || chunk.row_count > stream->chunk_rows)
+        return NULL;
+
+    size_t elements = (size_t) chunk.row_count * stream->cols;
+    if(stream->dtype != C3E_DTYPE_NATIVE) {
+        if(chunk.payload_size != elements * c3e_dtype_size(stream->dtype) ||
+            !c3e_socket_receive_data(stream->socket, stream->buffer, chunk.payload_size))
+            return NULL;
+
+        c3e_dtype_widen(stream->dtype, stream->buffer, stream->block->data, elements);
+    }
+    else if(stream->codec == C3E_CODEC_NONE) {
+        if(chunk.payload_size != elements * sizeof(c3e_number) ||
+            !c3e_socket_receive_data(stream->socket, stream->block->data, chunk.payload_size))
+            return NULL;
+    }
+    else if(chunk.payload_size > stream->buffer_size ||
+        !c3e_socket_receive_data(stream->socket, stream->buffer, chunk.payload_size) ||
+        !c3e_codec_decode(stream->buffer, chunk.payload_size, stream->block->data, elements))
+        return NULL;
+
+    stream->block->rows = chunk.row_count;
+    stream->position += chunk.row_count;
+    stream->credits++;
+
+    if(row_offset != NULL)
+        *row_offset = chunk.row_offset;
+    return stream->block;
+}
+
+void c3e_matrix_stream_close(c3e_matrix_stream* stream) {
+    if(stream == NULL)
+        return;
+
+    if(stream->block != NULL) {
+        c3e_matrix_free(stream->block);
+        stream->block = NULL;
+    }
+
+    free(stream->buffer);
+    stream->buffer = NULL;
+    stream->buffer_size = 0;
+}
+
+bool c3e_socket_send_matrix_stream(c3e_socket* socket, c3e_matrix* matrix, uint32_t chunk_rows) {
+    c3e_assert(matrix != NULL);
+
+    c3e_matrix_stream stream;
+    bool sent = c3e_matrix_stream_open(&stream, socket, matrix->rows, matrix->cols, chunk_rows, C3E_DTYPE_NATIVE) &&
+        c3e_matrix_stream_write(&stream, matrix->data, matrix->rows);
+
+    c3e_matrix_stream_close(&stream);
+    return sent;
+}
+
+c3e_matrix* c3e_socket_matrix_stream_read(c3e_socket* socket, uint32_t window) {
+    c3e_matrix_stream stream;
+    if(!c3e_matrix_stream_accept(&stream, socket, window)) {
+        c3e_matrix_stream_close(&stream);
+        return NULL;
+    }
+
+    c3e_assert(stream.rows <= UINT32_MAX && stream.cols <= UINT32_MAX);
+    c3e_matrix* matrix = c3e_matrix_init((int) stream.rows, (int) stream.cols);
+
+    if(matrix == NULL) {
+        c3e_matrix_stream_close(&stream);
+        return NULL;
+    }
+
+    uint64_t offset;
+    c3e_matrix* block;
+
+    while((block = c3e_matrix_stream_next(&stream, &offset)) != NULL)
+        memcpy(
+            matrix->data + offset * stream.cols,
+            block->data,
+            (size_t) block->rows * block->cols * sizeof(c3e_number)
+        );
+
+    bool complete = stream.position == stream.rows;
+    c3e_matrix_stream_close(&stream);
+
+    if(!complete) {
+        c3e_matrix_free(matrix);
+        return NULL;
+    }
+
+    return matrix;
 }
\ No newline at end of file
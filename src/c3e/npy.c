@@ -0,0 +1,805 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/npy.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define C3E_NPY_ALIGNMENT   64
+#define C3E_NPY_BATCH       65536
+#define C3E_NPY_HEADER_SIZE 128
+
+#define C3E_ZIP_LOCAL       0x04034b50u
+#define C3E_ZIP_CENTRAL     0x02014b50u
+#define C3E_ZIP_END         0x06054b50u
+#define C3E_ZIP64_END       0x06064b50u
+#define C3E_ZIP64_LOCATOR   0x07064b50u
+#define C3E_ZIP_PADDING     0xc3e5u
+#define C3E_ZIP_LIMIT       0xffffffffu
+
+static const uint8_t c3e_npy_magic[6] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
+
+static uint32_t c3e_npy_crc_table[256];
+static pthread_once_t c3e_npy_crc_once = PTHREAD_ONCE_INIT;
+
+static void c3e_npy_crc_init(void) {
+    for(uint32_t i = 0; i < 256; i++) {
+        uint32_t value = i;
+
+        for(int bit = 0; bit < 8; bit++)
+            value = (value & 1) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+        c3e_npy_crc_table[i] = value;
+    }
+}
+
+static uint32_t c3e_npy_crc(uint32_t crc, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*) data;
+
+    crc = ~crc;
+    for(size_t i = 0; i < size; i++)
+        crc = c3e_npy_crc_table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static inline void c3e_npy_put(uint8_t* out, uint64_t value, int size) {
+    for(int i = 0; i < size; i++)
+        out[i] = (uint8_t) (value >> (8 * i));
+}
+
+static inline uint64_t c3e_npy_get(const uint8_t* in, int size) {
+    uint64_t value = 0;
+
+    for(int i = 0; i < size; i++)
+        value |= (uint64_t) in[i] << (8 * i);
+    return value;
+}
+
+static inline uint64_t c3e_npy_align(uint64_t position) {
+    return (position + C3E_NPY_ALIGNMENT - 1) & ~((uint64_t) C3E_NPY_ALIGNMENT - 1);
+}
+
+static inline bool c3e_npy_big_endian(void) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return true;
+#else
+    return false;
+#endif
+}
+
+static inline c3e_dtype c3e_npy_native(void) {
+#ifndef C3E_32BIT_NUMBER
+    return C3E_DTYPE_FLOAT64;
+#else
+    return C3E_DTYPE_FLOAT32;
+#endif
+}
+
+static c3e_dtype c3e_npy_dtype(c3e_dtype dtype) {
+    if(dtype == C3E_DTYPE_NATIVE)
+        dtype = c3e_npy_native();
+
+    c3e_assert(dtype == C3E_DTYPE_FLOAT32 || dtype == C3E_DTYPE_FLOAT64);
+    return dtype;
+}
+
+static bool c3e_npy_write(int fd, const void* data, size_t size, uint64_t offset) {
+    const char* bytes = (const char*) data;
+
+    while(size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, (off_t) offset);
+
+        if(written < 0 && errno == EINTR)
+            continue;
+        else if(written <= 0)
+            return false;
+
+        bytes += written;
+        size -= (size_t) written;
+        offset += (uint64_t) written;
+    }
+
+    return true;
+}
+
+static size_t c3e_npy_header(uint8_t* header, c3e_dtype dtype, uint32_t rows, uint32_t cols, bool vector) {
+    char shape[32];
+
+    if(vector)
+        snprintf(shape, sizeof(shape), "(%u,)", rows);
+    else snprintf(shape, sizeof(shape), "(%u, %u)", rows, cols);
+
+    int length = snprintf(
+        (char*) header + 10, C3E_NPY_HEADER_SIZE - 10,
+        "{'descr': '%c%s', 'fortran_order': False, 'shape': %s, }",
+        c3e_npy_big_endian() ? '>' : '<',
+        dtype == C3E_DTYPE_FLOAT32 ? "f4" : "f8",
+        shape
+    );
+    size_t total = (size_t) c3e_npy_align(10 + (uint64_t) length + 1);
+
+    memcpy(header, c3e_npy_magic, sizeof(c3e_npy_magic));
+    header[6] = 1;
+    header[7] = 0;
+
+    c3e_npy_put(header + 8, total - 10, 2);
+    memset(header + 10 + length, ' ', total - 11 - (size_t) length);
+    header[total - 1] = '\n';
+
+    return total;
+}
+
+static bool c3e_npy_emit(int fd, uint64_t offset, const uint8_t* header, size_t length, const c3e_number* data, size_t count, c3e_dtype dtype, uint32_t* crc) {
+    size_t width = c3e_dtype_size(dtype);
+    size_t batch = count < C3E_NPY_BATCH ? count : C3E_NPY_BATCH;
+    void* buffer = NULL;
+
+    if(dtype != c3e_npy_native() && batch != 0 &&
+        (buffer = malloc(batch * width)) == NULL)
+        return false;
+
+    bool written = c3e_npy_write(fd, header, length, offset);
+    if(crc != NULL)
+        *crc = c3e_npy_crc(0, header, length);
+
+    offset += length;
+    for(size_t i = 0; written && i < count; i += batch) {
+        size_t chunk = count - i < batch ? count - i : batch;
+        const void* elements = data + i;
+
+        if(buffer != NULL) {
+            c3e_dtype_narrow(dtype, data + i, buffer, chunk);
+            elements = buffer;
+        }
+
+        if(crc != NULL)
+            *crc = c3e_npy_crc(*crc, elements, chunk * width);
+        written = c3e_npy_write(fd, elements, chunk * width, offset + i * width);
+    }
+
+    free(buffer);
+    return written;
+}
+
+static bool c3e_npy_save(const char* path, const c3e_number* data, uint32_t rows, uint32_t cols, bool vector, c3e_dtype dtype) {
+    c3e_assert(path != NULL);
+
+    uint8_t header[C3E_NPY_HEADER_SIZE];
+    dtype = c3e_npy_dtype(dtype);
+
+    size_t length = c3e_npy_header(header, dtype, rows, cols, vector);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(fd < 0)
+        return false;
+
+    bool written = c3e_npy_emit(fd, 0, header, length, data, (size_t) rows * cols, dtype, NULL);
+    return close(fd) == 0 && written;
+}
+
+static bool c3e_npz_put(c3e_npz_writer* writer, const char* name, const c3e_number* data, uint32_t rows, uint32_t cols, bool vector, c3e_dtype dtype) {
+    c3e_assert(writer != NULL);
+    c3e_assert(name != NULL && strlen(name) < C3E_NPY_NAME_SIZE);
+
+    char file_name[C3E_NPY_NAME_SIZE + 4];
+    snprintf(file_name, sizeof(file_name), "%s.npy", name);
+
+    for(uint32_t i = 0; i < writer->count; i++)
+        c3e_assert(strcmp(writer->members[i].name, file_name) != 0);
+
+    if(writer->count == writer->capacity) {
+        uint32_t capacity = writer->capacity == 0 ? 16 : writer->capacity * 2;
+        c3e_npz_member* members = (c3e_npz_member*) realloc(
+            writer->members,
+            capacity * sizeof(c3e_npz_member)
+        );
+
+        if(members == NULL)
+            return false;
+
+        writer->members = members;
+        writer->capacity = capacity;
+    }
+
+    uint8_t header[C3E_NPY_HEADER_SIZE];
+    dtype = c3e_npy_dtype(dtype);
+
+    size_t length = c3e_npy_header(header, dtype, rows, cols, vector);
+    size_t count = (size_t) rows * cols;
+
+    c3e_npz_member* member = &writer->members[writer->count];
+    strcpy(member->name, file_name);
+    member->offset = writer->position;
+    member->size = length + count * c3e_dtype_size(dtype);
+
+    size_t name_length = strlen(file_name);
+    bool zip64 = member->size >= C3E_ZIP_LIMIT;
+    uint64_t start = member->offset + 30 + name_length + (zip64 ? 20 : 0) + 4;
+    size_t padding = (size_t) (c3e_npy_align(start) - start);
+
+    if(!c3e_npy_emit(writer->fd, start + padding, header, length, data, count, dtype, &member->crc))
+        return false;
+
+    uint8_t local[30 + sizeof(member->name) + 24 + C3E_NPY_ALIGNMENT];
+    memset(local, 0, sizeof(local));
+
+    c3e_npy_put(local, C3E_ZIP_LOCAL, 4);
+    c3e_npy_put(local + 4, zip64 ? 45 : 20, 2);
+    c3e_npy_put(local + 12, 0x21, 2);
+    c3e_npy_put(local + 14, member->crc, 4);
+    c3e_npy_put(local + 18, zip64 ? C3E_ZIP_LIMIT : member->size, 4);
+    c3e_npy_put(local + 22, zip64 ? C3E_ZIP_LIMIT : member->size, 4);
+    c3e_npy_put(local + 26, name_length, 2);
+    c3e_npy_put(local + 28, (zip64 ? 20 : 0) + 4 + padding, 2);
+    memcpy(local + 30, file_name, name_length);
+
+    uint8_t* extra = local + 30 + name_length;
+    if(zip64) {
+        c3e_npy_put(extra, 1, 2);
+        c3e_npy_put(extra + 2, 16, 2);
+        c3e_npy_put(extra + 4, member->size, 8);
+        c3e_npy_put(extra + 12, member->size, 8);
+
+        extra += 20;
+    }
+
+    c3e_npy_put(extra, C3E_ZIP_PADDING, 2);
+    c3e_npy_put(extra + 2, padding, 2);
+
+    if(!c3e_npy_write(writer->fd, local, (size_t) (start + padding - member->offset), member->offset))
+        return false;
+
+    writer->position = start + padding + member->size;
+    writer->count++;
+
+    return true;
+}
+
+static bool c3e_npy_fits(c3e_npy_file* file, uint64_t offset, uint64_t size) {
+    return offset <= file->size && size <= file->size - offset;
+}
+
+static const char* c3e_npy_value(const char* dict, const char* key) {
+    const char* value = strstr(dict, key);
+    if(value == NULL)
+        return NULL;
+
+    value += strlen(key);
+    while(*value == ' ')
+        value++;
+
+    if(*value != ':')
+        return NULL;
+
+    do value++;
+    while(*value == ' ');
+
+    return value;
+}
+
+static bool c3e_npy_describe(const char* dict, c3e_npy_array* array) {
+    const char* descr = c3e_npy_value(dict, "'descr'");
+    const char* order = c3e_npy_value(dict, "'fortran_order'");
+    const char* shape = c3e_npy_value(dict, "'shape'");
+
+    if(descr == NULL || order == NULL || shape == NULL ||
+        descr[0] != '\'' || descr[2] != 'f' || descr[4] != '\'')
+        return false;
+
+    if(descr[1] == '<' || descr[1] == '>')
+        array->big_endian = descr[1] == '>';
+    else if(descr[1] == '=')
+        array->big_endian = c3e_npy_big_endian();
+    else return false;
+
+    if(descr[3] == '4')
+        array->dtype = C3E_DTYPE_FLOAT32;
+    else if(descr[3] == '8')
+        array->dtype = C3E_DTYPE_FLOAT64;
+    else return false;
+
+    if(strncmp(order, "True", 4) == 0)
+        array->fortran_order = true;
+    else if(strncmp(order, "False", 5) == 0)
+        array->fortran_order = false;
+    else return false;
+
+    if(*shape++ != '(')
+        return false;
+
+    uint64_t dimensions[2] = {1, 1};
+    array->dimensions = 0;
+
+    while(true) {
+        while(*shape == ' ' || *shape == ',')
+            shape++;
+
+        if(*shape == ')')
+            break;
+        else if(*shape < '0' || *shape > '9' || array->dimensions == 2)
+            return false;
+
+        char* end;
+        dimensions[array->dimensions++] = strtoull(shape, &end, 10);
+        shape = end;
+    }
+
+    if(dimensions[0] > UINT32_MAX || dimensions[1] > UINT32_MAX)
+        return false;
+
+    array->rows = (uint32_t) dimensions[0];
+    array->cols = (uint32_t) dimensions[1];
+
+    return true;
+}
+
+static bool c3e_npy_parse(c3e_npy_file* file, uint64_t offset, uint64_t size, c3e_npy_array* array) {
+    if(!c3e_npy_fits(file, offset, size) || size < 12)
+        return false;
+
+    const uint8_t* data = file->map + offset;
+    uint64_t start, length;
+
+    if(memcmp(data, c3e_npy_magic, sizeof(c3e_npy_magic)) != 0)
+        return false;
+    else if(data[6] == 1) {
+        start = 10;
+        length = c3e_npy_get(data + 8, 2);
+    }
+    else if(data[6] == 2 || data[6] == 3) {
+        start = 12;
+        length = c3e_npy_get(data + 8, 4);
+    }
+    else return false;
+
+    if(length > size - start)
+        return false;
+
+    char* dict = (char*) malloc((size_t) length + 1);
+    if(dict == NULL)
+        return false;
+
+    memcpy(dict, data + start, (size_t) length);
+    dict[length] = '\0';
+
+    bool valid = c3e_npy_describe(dict, array);
+    free(dict);
+
+    array->offset = offset + start + length;
+    return valid && (uint64_t) array->rows * array->cols * c3e_dtype_size(array->dtype) <=
+        size - start - length;
+}
+
+static bool c3e_npy_open_zip(c3e_npy_file* file) {
+    if(file->size < 22)
+        return false;
+
+    uint64_t end = file->size - 22;
+    while(c3e_npy_get(file->map + end, 4) != C3E_ZIP_END)
+        if(end == 0 || file->size - 22 - end >= 65535)
+            return false;
+        else end--;
+
+    uint64_t entries = c3e_npy_get(file->map + end + 10, 2);
+    uint64_t directory_size = c3e_npy_get(file->map + end + 12, 4);
+    uint64_t directory = c3e_npy_get(file->map + end + 16, 4);
+
+    if(entries == 0xffff || directory_size == C3E_ZIP_LIMIT || directory == C3E_ZIP_LIMIT) {
+        if(end < 20 || c3e_npy_get(file->map + end - 20, 4) != C3E_ZIP64_LOCATOR)
+            return false;
+
+        uint64_t record = c3e_npy_get(file->map + end - 12, 8);
+        if(!c3e_npy_fits(file, record, 56) || c3e_npy_get(file->map + record, 4) != C3E_ZIP64_END)
+            return false;
+
+        entries = c3e_npy_get(file->map + record + 32, 8);
+        directory_size = c3e_npy_get(file->map + record + 40, 8);
+        directory = c3e_npy_get(file->map + record + 48, 8);
+    }
+
+    if(!c3e_npy_fits(file, directory, directory_size) || entries > directory_size / 46)
+        return false;
+
+    file->arrays = (c3e_npy_array*) calloc(entries + 1, sizeof(c3e_npy_array));
+    if(file->arrays == NULL)
+        return false;
+
+    uint64_t cursor = directory;
+    for(uint64_t i = 0; i < entries; i++) {
+        const uint8_t* central = file->map + cursor;
+
+        if(!c3e_npy_fits(file, cursor, 46) || c3e_npy_get(central, 4) != C3E_ZIP_CENTRAL)
+            return false;
+
+        uint64_t flags = c3e_npy_get(central + 8, 2);
+        uint64_t method = c3e_npy_get(central + 10, 2);
+        uint64_t compressed = c3e_npy_get(central + 20, 4);
+        uint64_t uncompressed = c3e_npy_get(central + 24, 4);
+        uint64_t name_length = c3e_npy_get(central + 28, 2);
+        uint64_t extra_length = c3e_npy_get(central + 30, 2);
+        uint64_t local = c3e_npy_get(central + 42, 4);
+
+        uint64_t next = cursor + 46 + name_length + extra_length + c3e_npy_get(central + 32, 2);
+        if(next > directory + directory_size)
+            return false;
+
+        const uint8_t* extra = central + 46 + name_length;
+        const uint8_t* extra_end = extra + extra_length;
+
+        while(extra + 4 <= extra_end) {
+            const uint8_t* field = extra + 4;
+            const uint8_t* field_end = field + c3e_npy_get(extra + 2, 2);
+
+            if(c3e_npy_get(extra, 2) == 1 && field_end <= extra_end) {
+                if(uncompressed == C3E_ZIP_LIMIT && field + 8 <= field_end) {
+                    uncompressed = c3e_npy_get(field, 8);
+                    field += 8;
+                }
+
+                if(compressed == C3E_ZIP_LIMIT && field + 8 <= field_end) {
+                    compressed = c3e_npy_get(field, 8);
+                    field += 8;
+                }
+
+                if(local == C3E_ZIP_LIMIT && field + 8 <= field_end)
+                    local = c3e_npy_get(field, 8);
+            }
+
+            extra = field_end;
+        }
+
+        const char* name = (const char*) central + 46;
+        cursor = next;
+
+        if(method != 0 || (flags & 1) != 0 || compressed != uncompressed ||
+            name_length <= 4 || name_length - 4 >= C3E_NPY_NAME_SIZE ||
+            memcmp(name + name_length - 4, ".npy", 4) != 0 ||
+            !c3e_npy_fits(file, local, 30) ||
+            c3e_npy_get(file->map + local, 4) != C3E_ZIP_LOCAL)
+            continue;
+
+        uint64_t data = local + 30 +
+            c3e_npy_get(file->map + local + 26, 2) +
+            c3e_npy_get(file->map + local + 28, 2);
+        c3e_npy_array* array = &file->arrays[file->count];
+
+        if(c3e_npy_parse(file, data, compressed, array)) {
+            memcpy(array->name, name, (size_t) name_length - 4);
+            array->name[name_length - 4] = '\0';
+
+            file->count++;
+        }
+        else memset(array, 0, sizeof(c3e_npy_array));
+    }
+
+    return true;
+}
+
+static bool c3e_npy_mappable(c3e_npy_array* array) {
+    return array->dtype == c3e_npy_native() &&
+        array->big_endian == c3e_npy_big_endian() &&
+        (!array->fortran_order || array->rows == 1 || array->cols == 1) &&
+        array->offset % sizeof(c3e_number) == 0;
+}
+
+static c3e_number* c3e_npy_elements(c3e_npy_file* file, uint32_t index) {
+    c3e_npy_array* array = &file->arrays[index];
+    const uint8_t* source = file->map + array->offset;
+
+    if(c3e_npy_mappable(array))
+        return (c3e_number*) source;
+    else if(file->buffers[index] != NULL)
+        return file->buffers[index];
+
+    size_t count = (size_t) array->rows * array->cols;
+    c3e_number* target = (c3e_number*) malloc((count == 0 ? 1 : count) * sizeof(c3e_number));
+
+    if(target == NULL)
+        return NULL;
+
+    size_t width = c3e_dtype_size(array->dtype);
+    bool swap = array->big_endian != c3e_npy_big_endian();
+    bool transpose = array->fortran_order && array->rows > 1 && array->cols > 1;
+
+    if(!swap && !transpose)
+        c3e_dtype_widen(array->dtype, source, target, count);
+    else for(size_t i = 0; i < count; i++) {
+        uint8_t element[8];
+        const uint8_t* bytes = source + i * width;
+
+        for(size_t j = 0; j < width; j++)
+            element[j] = swap ? bytes[width - 1 - j] : bytes[j];
+
+        size_t position = transpose ?
+            (i % array->rows) * array->cols + i / array->rows : i;
+        c3e_dtype_widen(array->dtype, element, target + position, 1);
+    }
+
+    file->buffers[index] = target;
+    return target;
+}
+
+bool c3e_npy_save_matrix(const char* path, c3e_matrix* matrix, c3e_dtype dtype) {
+    c3e_assert(matrix != NULL);
+    return c3e_npy_save(path, matrix->data, matrix->rows, matrix->cols, false, dtype);
+}
+
+bool c3e_npy_save_vector(const char* path, c3e_vector* vector, c3e_dtype dtype) {
+    c3e_assert(vector != NULL);
+    return c3e_npy_save(path, vector->data, vector->size, 1, true, dtype);
+}
+
+c3e_npz_writer* c3e_npz_create(const char* path) {
+    c3e_assert(path != NULL);
+    pthread_once(&c3e_npy_crc_once, c3e_npy_crc_init);
+
+    c3e_npz_writer* writer = (c3e_npz_writer*) malloc(sizeof(c3e_npz_writer));
+    if(writer == NULL)
+        return NULL;
+
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    writer->position = 0;
+    writer->members = NULL;
+    writer->count = 0;
+    writer->capacity = 0;
+
+    if(writer->fd < 0) {
+        free(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+bool c3e_npz_put_matrix(c3e_npz_writer* writer, const char* name, c3e_matrix* matrix, c3e_dtype dtype) {
+    c3e_assert(matrix != NULL);
+    return c3e_npz_put(writer, name, matrix->data, matrix->rows, matrix->cols, false, dtype);
+}
+
+bool c3e_npz_put_vector(c3e_npz_writer* writer, const char* name, c3e_vector* vector, c3e_dtype dtype) {
+    c3e_assert(vector != NULL);
+    return c3e_npz_put(writer, name, vector->data, vector->size, 1, true, dtype);
+}
+
+bool c3e_npz_finish(c3e_npz_writer* writer) {
+    c3e_assert(writer != NULL);
+
+    size_t capacity = (size_t) writer->count * (46 + sizeof(writer->members[0].name) + 28) + 56 + 20 + 22;
+    uint8_t* directory = (uint8_t*) calloc(capacity, 1);
+    bool finished = directory != NULL;
+
+    if(finished) {
+        uint8_t* cursor = directory;
+
+        for(uint32_t i = 0; i < writer->count; i++) {
+            c3e_npz_member* member = &writer->members[i];
+            size_t name_length = strlen(member->name);
+
+            bool large = member->size >= C3E_ZIP_LIMIT;
+            bool far = member->offset >= C3E_ZIP_LIMIT;
+            size_t extra_length = large || far ? 4 + (large ? 16 : 0) + (far ? 8 : 0) : 0;
+
+            c3e_npy_put(cursor, C3E_ZIP_CENTRAL, 4);
+            c3e_npy_put(cursor + 4, extra_length != 0 ? 45 : 20, 2);
+            c3e_npy_put(cursor + 6, extra_length != 0 ? 45 : 20, 2);
+            c3e_npy_put(cursor + 14, 0x21, 2);
+            c3e_npy_put(cursor + 16, member->crc, 4);
+            c3e_npy_put(cursor + 20, large ? C3E_ZIP_LIMIT : member->size, 4);
+            c3e_npy_put(cursor + 24, large ? C3E_ZIP_LIMIT : member->size, 4);
+            c3e_npy_put(cursor + 28, name_length, 2);
+            c3e_npy_put(cursor + 30, extra_length, 2);
+            c3e_npy_put(cursor + 42, far ? C3E_ZIP_LIMIT : member->offset, 4);
+
+            memcpy(cursor + 46, member->name, name_length);
+            cursor += 46 + name_length;
+
+            if(extra_length != 0) {
+                c3e_npy_put(cursor, 1, 2);
+                c3e_npy_put(cursor + 2, extra_length - 4, 2);
+                cursor += 4;
+
+                if(large) {
+                    c3e_npy_put(cursor, member->size, 8);
+                    c3e_npy_put(cursor + 8, member->size, 8);
+                    cursor += 16;
+                }
+
+                if(far) {
+                    c3e_npy_put(cursor, member->offset, 8);
+                    cursor += 8;
+                }
+            }
+        }
+
+        uint64_t size = (uint64_t) (cursor - directory);
+        uint64_t offset = writer->position;
+
+        if(writer->count >= 0xffff || size >= C3E_ZIP_LIMIT || offset >= C3E_ZIP_LIMIT) {
+            c3e_npy_put(cursor, C3E_ZIP64_END, 4);
+            c3e_npy_put(cursor + 4, 44, 8);
+            c3e_npy_put(cursor + 12, 45, 2);
+            c3e_npy_put(cursor + 14, 45, 2);
+            c3e_npy_put(cursor + 24, writer->count, 8);
+            c3e_npy_put(cursor + 32, writer->count, 8);
+            c3e_npy_put(cursor + 40, size, 8);
+            c3e_npy_put(cursor + 48, offset, 8);
+
+            c3e_npy_put(cursor + 56, C3E_ZIP64_LOCATOR, 4);
+            c3e_npy_put(cursor + 64, offset + size, 8);
+            c3e_npy_put(cursor + 72, 1, 4);
+            cursor += 76;
+        }
+
+        c3e_npy_put(cursor, C3E_ZIP_END, 4);
+        c3e_npy_put(cursor + 8, writer->count >= 0xffff ? 0xffff : writer->count, 2);
+        c3e_npy_put(cursor + 10, writer->count >= 0xffff ? 0xffff : writer->count, 2);
+        c3e_npy_put(cursor + 12, size >= C3E_ZIP_LIMIT ? C3E_ZIP_LIMIT : size, 4);
+        c3e_npy_put(cursor + 16, offset >= C3E_ZIP_LIMIT ? C3E_ZIP_LIMIT : offset, 4);
+        cursor += 22;
+
+        finished = c3e_npy_write(writer->fd, directory, (size_t) (cursor - directory), offset);
+    }
+
+    finished = close(writer->fd) == 0 && finished;
+    free(directory);
+    free(writer->members);
+    free(writer);
+
+    return finished;
+}
+
+c3e_npy_file* c3e_npy_open(const char* path) {
+    c3e_assert(path != NULL);
+
+    c3e_npy_file* file = (c3e_npy_file*) calloc(1, sizeof(c3e_npy_file));
+    if(file == NULL)
+        return NULL;
+
+    struct stat status;
+    file->fd = open(path, O_RDONLY);
+
+    if(file->fd < 0 || fstat(file->fd, &status) != 0 || status.st_size < 12) {
+        if(file->fd >= 0)
+            close(file->fd);
+
+        free(file);
+        return NULL;
+    }
+
+    file->size = (size_t) status.st_size;
+    file->map = (uint8_t*) mmap(NULL, file->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file->fd, 0);
+
+    if(file->map == MAP_FAILED) {
+        close(file->fd);
+        free(file);
+
+        return NULL;
+    }
+
+    bool valid;
+    if(memcmp(file->map, c3e_npy_magic, sizeof(c3e_npy_magic)) == 0) {
+        file->arrays = (c3e_npy_array*) calloc(1, sizeof(c3e_npy_array));
+        valid = file->arrays != NULL && c3e_npy_parse(file, 0, file->size, file->arrays);
+        file->count = valid ? 1 : 0;
+    }
+    else valid = c3e_npy_open_zip(file);
+
+    file->matrices = (c3e_matrix**) calloc(file->count + 1, sizeof(c3e_matrix*));
+    file->vectors = (c3e_vector**) calloc(file->count + 1, sizeof(c3e_vector*));
+    file->buffers = (c3e_number**) calloc(file->count + 1, sizeof(c3e_number*));
+
+    if(!valid || file->matrices == NULL || file->vectors == NULL || file->buffers == NULL) {
+        file->count = 0;
+        c3e_npy_close(file);
+
+        return NULL;
+    }
+
+    return file;
+}
+
+void c3e_npy_close(c3e_npy_file* file) {
+    c3e_assert(file != NULL);
+
+    for(uint32_t i = 0; i < file->count; i++) {
+        free(file->matrices[i]);
+        free(file->vectors[i]);
+        free(file->buffers[i]);
+    }
+
+    munmap(file->map, file->size);
+    close(file->fd);
+
+    free(file->arrays);
+    free(file->matrices);
+    free(file->vectors);
+    free(file->buffers);
+    free(file);
+}
+
+c3e_npy_array* c3e_npy_find(c3e_npy_file* file, const char* name) {
+    c3e_assert(file != NULL);
+
+    if(name == NULL)
+        return file->count > 0 ? &file->arrays[0] : NULL;
+
+    for(uint32_t i = 0; i < file->count; i++)
+        if(strcmp(file->arrays[i].name, name) == 0)
+            return &file->arrays[i];
+
+    return NULL;
+}
+
+c3e_matrix* c3e_npy_matrix(c3e_npy_file* file, const char* name) {
+    c3e_npy_array* array = c3e_npy_find(file, name);
+    if(array == NULL)
+        return NULL;
+
+    uint32_t index = (uint32_t) (array - file->arrays);
+    if(file->matrices[index] != NULL)
+        return file->matrices[index];
+
+    c3e_matrix* matrix = (c3e_matrix*) malloc(sizeof(c3e_matrix));
+    if(matrix == NULL)
+        return NULL;
+
+    matrix->rows = array->rows;
+    matrix->cols = array->cols;
+    matrix->data = c3e_npy_elements(file, index);
+
+    if(matrix->data == NULL) {
+        free(matrix);
+        return NULL;
+    }
+
+    file->matrices[index] = matrix;
+    return matrix;
+}
+
+c3e_vector* c3e_npy_vector(c3e_npy_file* file, const char* name) {
+    c3e_npy_array* array = c3e_npy_find(file, name);
+    if(array == NULL || (array->rows != 1 && array->cols != 1))
+        return NULL;
+
+    uint32_t index = (uint32_t) (array - file->arrays);
+    if(file->vectors[index] != NULL)
+        return file->vectors[index];
+
+    c3e_vector* vector = (c3e_vector*) malloc(sizeof(c3e_vector));
+    if(vector == NULL)
+        return NULL;
+
+    vector->size = array->rows * array->cols;
+    vector->data = c3e_npy_elements(file, index);
+
+    if(vector->data == NULL) {
+        free(vector);
+        return NULL;
+    }
+
+    file->vectors[index] = vector;
+    return vector;
+}
\ No newline at end of file
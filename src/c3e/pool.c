@@ -0,0 +1,683 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#define _GNU_SOURCE
+
+#include <c3e/assert.h>
+#include <c3e/context.h>
+#include <c3e/pool.h>
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define C3E_POOL_DEQUE      4096
+#define C3E_POOL_SPINS      64
+#define C3E_POOL_CHUNKS     8
+
+typedef struct {
+    size_t first;
+    size_t last;
+    size_t grain;
+    size_t chunks;
+    c3e_parallel_body body;
+    c3e_parallel_reduce_body reduce;
+    c3e_parallel_join join;
+    uint8_t* slots;
+    size_t size;
+    void* context;
+    c3e_context_settings settings;
+    _Atomic size_t next;
+    _Atomic size_t completed;
+    _Atomic uint32_t finished;
+    _Atomic uint32_t references;
+} c3e_pool_job;
+
+typedef struct c3e_pool_task c3e_pool_task;
+
+struct c3e_pool_task {
+    c3e_pool_job* job;
+    size_t first;
+    size_t last;
+    bool waited;
+    _Atomic uint32_t done;
+    void (*run)(void*);
+    void* argument;
+    c3e_pool_group* group;
+    c3e_context_settings settings;
+    c3e_pool_task* next;
+};
+
+typedef struct {
+    _Alignas(64) _Atomic int64_t top;
+    _Alignas(64) _Atomic int64_t bottom;
+    _Atomic(c3e_pool_task*) buffer[C3E_POOL_DEQUE];
+    pthread_t thread;
+    uint64_t state;
+} c3e_pool_worker;
+
+static pthread_mutex_t c3e_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static c3e_pool_worker* c3e_pool_workers = NULL;
+static _Atomic uint32_t c3e_pool_count = 0;
+static _Atomic bool c3e_pool_started = false;
+static _Atomic bool c3e_pool_stopping = false;
+
+static _Atomic uint32_t c3e_pool_epoch = 0;
+static _Atomic uint32_t c3e_pool_sleepers = 0;
+
+static pthread_mutex_t c3e_pool_queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static c3e_pool_task* c3e_pool_head = NULL;
+static c3e_pool_task* c3e_pool_tail = NULL;
+static _Atomic uint32_t c3e_pool_queued = 0;
+
+static __thread c3e_pool_worker* c3e_pool_self = NULL;
+
+static void c3e_pool_wait(_Atomic uint32_t* address, uint32_t expected) {
+    syscall(SYS_futex, (uint32_t*) address, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void c3e_pool_wake(_Atomic uint32_t* address, int count) {
+    syscall(SYS_futex, (uint32_t*) address, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+static void c3e_pool_notify(void) {
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if(atomic_load_explicit(&c3e_pool_sleepers, memory_order_relaxed) != 0) {
+        atomic_fetch_add(&c3e_pool_epoch, 1);
+        c3e_pool_wake(&c3e_pool_epoch, 1);
+    }
+}
+
+static bool c3e_pool_push(c3e_pool_worker* worker, c3e_pool_task* task) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+
+    if(bottom - top >= C3E_POOL_DEQUE)
+        return false;
+
+    atomic_store_explicit(&worker->buffer[bottom % C3E_POOL_DEQUE], task, memory_order_release);
+    atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_release);
+
+    return true;
+}
+
+static c3e_pool_task* c3e_pool_pop(c3e_pool_worker* worker) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+    if(top > bottom) {
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    c3e_pool_task* task = atomic_load_explicit(&worker->buffer[bottom % C3E_POOL_DEQUE], memory_order_relaxed);
+    if(top == bottom) {
+        if(!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+            task = NULL;
+
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    }
+
+    return task;
+}
+
+static c3e_pool_task* c3e_pool_steal(c3e_pool_worker* worker) {
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_acquire);
+
+    if(top >= bottom)
+        return NULL;
+
+    c3e_pool_task* task = atomic_load_explicit(&worker->buffer[top % C3E_POOL_DEQUE], memory_order_acquire);
+    if(!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+        return NULL;
+
+    return task;
+}
+
+static void c3e_pool_inject(c3e_pool_task* task) {
+    task->next = NULL;
+
+    pthread_mutex_lock(&c3e_pool_queue_lock);
+    if(c3e_pool_tail != NULL)
+        c3e_pool_tail->next = task;
+    else c3e_pool_head = task;
+
+    c3e_pool_tail = task;
+    atomic_fetch_add(&c3e_pool_queued, 1);
+    pthread_mutex_unlock(&c3e_pool_queue_lock);
+
+    c3e_pool_notify();
+}
+
+static c3e_pool_task* c3e_pool_dequeue(void) {
+    if(atomic_load_explicit(&c3e_pool_queued, memory_order_relaxed) == 0)
+        return NULL;
+
+    pthread_mutex_lock(&c3e_pool_queue_lock);
+    c3e_pool_task* task = c3e_pool_head;
+
+    if(task != NULL) {
+        c3e_pool_head = task->next;
+
+        if(c3e_pool_head == NULL)
+            c3e_pool_tail = NULL;
+        atomic_fetch_sub(&c3e_pool_queued, 1);
+    }
+    pthread_mutex_unlock(&c3e_pool_queue_lock);
+
+    return task;
+}
+
+static c3e_pool_task* c3e_pool_find(c3e_pool_worker* self) {
+    c3e_pool_task* task = c3e_pool_pop(self);
+    if(task != NULL)
+        return task;
+
+    uint32_t count = atomic_load_explicit(&c3e_pool_count, memory_order_acquire);
+    if(count == 0)
+        return c3e_pool_dequeue();
+
+    self->state ^= self->state << 13;
+    self->state ^= self->state >> 7;
+    self->state ^= self->state << 17;
+
+    for(uint32_t i = 0, start = (uint32_t) (self->state % count); i < count; i++) {
+        c3e_pool_worker* victim = &c3e_pool_workers[(start + i) % count];
+
+        if(victim != self && (task = c3e_pool_steal(victim)) != NULL)
+            return task;
+    }
+
+    return c3e_pool_dequeue();
+}
+
+static void c3e_pool_leaf(c3e_pool_job* job, size_t chunk) {
+    size_t first = job->first + chunk * job->grain;
+    size_t last = job->last - first < job->grain ? job->last : first + job->grain;
+
+    c3e_context* context = c3e_context_current();
+    c3e_context_settings settings = context->settings;
+    context->settings = job->settings;
+
+    if(job->reduce != NULL)
+        job->reduce(first, last, job->slots + chunk * job->size, job->context);
+    else job->body(first, last, job->context);
+
+    context->settings = settings;
+}
+
+static void c3e_pool_execute(c3e_pool_task* task);
+
+static void c3e_pool_join(c3e_pool_task* task) {
+    for(uint32_t spins = 0; !atomic_load_explicit(&task->done, memory_order_acquire); spins++) {
+        c3e_pool_task* other = c3e_pool_find(c3e_pool_self);
+
+        if(other != NULL) {
+            c3e_pool_execute(other);
+            spins = 0;
+        }
+        else if(spins >= C3E_POOL_SPINS)
+            sched_yield();
+    }
+}
+
+static void c3e_pool_split(c3e_pool_job* job, size_t first, size_t last) {
+    if(last - first == 1) {
+        c3e_pool_leaf(job, first);
+        return;
+    }
+
+    size_t middle = first + (last - first) / 2;
+    c3e_pool_task right = {.job = job, .first = middle, .last = last};
+    atomic_init(&right.done, 0);
+
+    bool pushed = c3e_pool_self != NULL && c3e_pool_push(c3e_pool_self, &right);
+    if(pushed)
+        c3e_pool_notify();
+
+    c3e_pool_split(job, first, middle);
+    if(pushed)
+        c3e_pool_join(&right);
+    else c3e_pool_split(job, middle, last);
+
+    if(job->reduce != NULL)
+        job->join(job->slots + first * job->size, job->slots + middle * job->size, job->context);
+}
+
+static void c3e_pool_finish(c3e_pool_group* group) {
+    if(atomic_fetch_sub_explicit(&group->pending, 1, memory_order_acq_rel) == 1)
+        c3e_pool_wake(&group->pending, INT_MAX);
+}
+
+static void c3e_pool_execute(c3e_pool_task* task) {
+    if(task->run != NULL) {
+        c3e_pool_group* group = task->group;
+        c3e_context* context = c3e_context_current();
+        c3e_context_settings settings = context->settings;
+
+        context->settings = task->settings;
+        task->run(task->argument);
+        context->settings = settings;
+        free(task);
+
+        c3e_pool_finish(group);
+        return;
+    }
+
+    bool waited = task->waited;
+
+    c3e_pool_split(task->job, task->first, task->last);
+    atomic_store_explicit(&task->done, 1, memory_order_release);
+
+    if(waited)
+        c3e_pool_wake(&task->done, 1);
+}
+
+static void* c3e_pool_main(void* argument) {
+    c3e_pool_worker* self = (c3e_pool_worker*) argument;
+    c3e_pool_self = self;
+
+    while(!atomic_load_explicit(&c3e_pool_stopping, memory_order_acquire)) {
+        c3e_pool_task* task = NULL;
+
+        for(uint32_t spins = 0; task == NULL && spins < C3E_POOL_SPINS; spins++)
+            task = c3e_pool_find(self);
+
+        if(task == NULL) {
+            atomic_fetch_add(&c3e_pool_sleepers, 1);
+            uint32_t epoch = atomic_load(&c3e_pool_epoch);
+
+            if((task = c3e_pool_find(self)) == NULL &&
+                !atomic_load(&c3e_pool_stopping))
+                c3e_pool_wait(&c3e_pool_epoch, epoch);
+            atomic_fetch_sub(&c3e_pool_sleepers, 1);
+        }
+
+        if(task != NULL)
+            c3e_pool_execute(task);
+    }
+
+    return NULL;
+}
+
+static void c3e_pool_shutdown(void) {
+    uint32_t count = atomic_load(&c3e_pool_count);
+
+    atomic_store(&c3e_pool_stopping, true);
+    atomic_fetch_add(&c3e_pool_epoch, 1);
+    c3e_pool_wake(&c3e_pool_epoch, INT_MAX);
+
+    for(uint32_t i = 0; i < count; i++)
+        pthread_join(c3e_pool_workers[i].thread, NULL);
+
+    free(c3e_pool_workers);
+    c3e_pool_workers = NULL;
+
+    atomic_store(&c3e_pool_count, 0);
+    atomic_store(&c3e_pool_stopping, false);
+}
+
+static void c3e_pool_forked(void) {
+    c3e_pool_workers = NULL;
+    c3e_pool_head = c3e_pool_tail = NULL;
+
+    atomic_store(&c3e_pool_count, 0);
+    atomic_store(&c3e_pool_queued, 0);
+    atomic_store(&c3e_pool_sleepers, 0);
+    atomic_store(&c3e_pool_started, false);
+}
+
+static void c3e_pool_register(void) {
+    pthread_atfork(NULL, NULL, c3e_pool_forked);
+}
+
+static bool c3e_pool_create(uint32_t workers, const uint32_t* cpus) {
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, c3e_pool_register);
+
+    if(workers == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (uint32_t) online : 1;
+    }
+
+    c3e_pool_workers = (c3e_pool_worker*) aligned_alloc(64, workers * sizeof(c3e_pool_worker));
+    uint32_t started = 0;
+    for(uint32_t i = 0; c3e_pool_workers != NULL && i < workers; i++) {
+        c3e_pool_worker* worker = &c3e_pool_workers[started];
+        pthread_attr_t attributes;
+
+        memset(worker, 0, sizeof(c3e_pool_worker));
+        worker->state = 0x9e3779b97f4a7c15ull * (started + 1);
+        pthread_attr_init(&attributes);
+
+        if(cpus != NULL) {
+            cpu_set_t set;
+
+            CPU_ZERO(&set);
+            CPU_SET(cpus[i], &set);
+            pthread_attr_setaffinity_np(&attributes, sizeof(cpu_set_t), &set);
+        }
+
+        if(pthread_create(&worker->thread, &attributes, c3e_pool_main, worker) == 0)
+            atomic_store(&c3e_pool_count, ++started);
+        pthread_attr_destroy(&attributes);
+    }
+
+    atomic_store(&c3e_pool_started, true);
+    return started == workers;
+}
+
+bool c3e_pool_start(uint32_t workers, const uint32_t* cpus) {
+    c3e_assert(c3e_pool_self == NULL);
+
+    pthread_mutex_lock(&c3e_pool_lock);
+    c3e_pool_shutdown();
+
+    bool started = c3e_pool_create(workers, cpus);
+    pthread_mutex_unlock(&c3e_pool_lock);
+
+    return started;
+}
+
+void c3e_pool_stop(void) {
+    c3e_assert(c3e_pool_self == NULL);
+
+    pthread_mutex_lock(&c3e_pool_lock);
+    c3e_pool_shutdown();
+    atomic_store(&c3e_pool_started, false);
+    pthread_mutex_unlock(&c3e_pool_lock);
+}
+
+void c3e_pool_set_executor(const c3e_executor* executor) {
+    c3e_assert(executor == NULL || (executor->submit != NULL && executor->concurrency != 0));
+
+    c3e_context* context = c3e_context_current();
+    if(executor != NULL)
+        context->settings.executor = *executor;
+    else memset(&context->settings.executor, 0, sizeof(c3e_executor));
+}
+
+static const c3e_executor* c3e_pool_delegated(void) {
+    const c3e_executor* executor = &c3e_context_current()->settings.executor;
+    return executor->submit != NULL ? executor : NULL;
+}
+
+static uint32_t c3e_pool_ensure(void) {
+    if(!atomic_load(&c3e_pool_started)) {
+        pthread_mutex_lock(&c3e_pool_lock);
+
+        if(!atomic_load(&c3e_pool_started))
+            c3e_pool_create(0, NULL);
+        pthread_mutex_unlock(&c3e_pool_lock);
+    }
+
+    return atomic_load(&c3e_pool_count);
+}
+
+uint32_t c3e_pool_size(void) {
+    const c3e_executor* executor = c3e_pool_delegated();
+    if(executor != NULL)
+        return executor->concurrency;
+
+    uint32_t count = c3e_pool_ensure();
+    return count == 0 ? 1 : count;
+}
+
+static void c3e_pool_fold(c3e_pool_job* job, size_t first, size_t last) {
+    if(last - first == 1)
+        return;
+
+    size_t middle = first + (last - first) / 2;
+    c3e_pool_fold(job, first, middle);
+    c3e_pool_fold(job, middle, last);
+
+    job->join(job->slots + first * job->size, job->slots + middle * job->size, job->context);
+}
+
+static void c3e_pool_claim(c3e_pool_job* job) {
+    size_t chunk;
+
+    while((chunk = atomic_fetch_add(&job->next, 1)) < job->chunks) {
+        c3e_pool_leaf(job, chunk);
+
+        if(atomic_fetch_add(&job->completed, 1) + 1 == job->chunks) {
+            atomic_store(&job->finished, 1);
+            c3e_pool_wake(&job->finished, INT_MAX);
+        }
+    }
+}
+
+static void c3e_pool_release(c3e_pool_job* job) {
+    if(atomic_fetch_sub(&job->references, 1) == 1)
+        free(job);
+}
+
+static void c3e_pool_help(void* argument) {
+    c3e_pool_job* job = (c3e_pool_job*) argument;
+
+    c3e_pool_claim(job);
+    c3e_pool_release(job);
+}
+
+static bool c3e_pool_delegate(c3e_pool_job* job) {
+    c3e_pool_job* shared = (c3e_pool_job*) malloc(sizeof(c3e_pool_job));
+    if(shared == NULL)
+        return false;
+
+    c3e_executor executor = job->settings.executor;
+    uint32_t helpers = executor.concurrency - 1;
+
+    if(helpers > job->chunks - 1)
+        helpers = (uint32_t) (job->chunks - 1);
+
+    memcpy(shared, job, sizeof(c3e_pool_job));
+    atomic_init(&shared->next, 0);
+    atomic_init(&shared->completed, 0);
+    atomic_init(&shared->finished, 0);
+    atomic_init(&shared->references, helpers + 1);
+
+    for(uint32_t i = 0; i < helpers; i++)
+        executor.submit(c3e_pool_help, shared, executor.executor);
+
+    c3e_pool_claim(shared);
+    while(!atomic_load(&shared->finished))
+        c3e_pool_wait(&shared->finished, 0);
+
+    if(job->reduce != NULL)
+        c3e_pool_fold(job, 0, job->chunks);
+
+    c3e_pool_release(shared);
+    return true;
+}
+
+static void c3e_pool_launch(c3e_pool_job* job) {
+    c3e_context* context = c3e_context_current();
+
+    job->settings = context->settings;
+    context->counters.parallel_loops++;
+
+    if(job->chunks == 1) {
+        c3e_pool_leaf(job, 0);
+        return;
+    }
+
+    if(c3e_pool_self == NULL && job->settings.executor.submit != NULL &&
+        c3e_pool_delegate(job))
+        return;
+
+    if(c3e_pool_self != NULL || c3e_pool_size() == 1) {
+        c3e_pool_split(job, 0, job->chunks);
+        return;
+    }
+
+    c3e_pool_task root = {.job = job, .first = 0, .last = job->chunks, .waited = true};
+    atomic_init(&root.done, 0);
+
+    c3e_pool_inject(&root);
+    while(!atomic_load_explicit(&root.done, memory_order_acquire))
+        c3e_pool_wait(&root.done, 0);
+}
+
+static size_t c3e_pool_grain(size_t count, size_t grain) {
+    if(grain != 0)
+        return grain;
+
+    grain = count / ((size_t) c3e_pool_size() * C3E_POOL_CHUNKS);
+    return grain == 0 ? 1 : grain;
+}
+
+void c3e_parallel_for(size_t first, size_t last, size_t grain, c3e_parallel_body body, void* context) {
+    c3e_assert(first <= last && body != NULL);
+
+    if(first == last)
+        return;
+
+    c3e_pool_job job = {
+        .first = first,
+        .last = last,
+        .grain = c3e_pool_grain(last - first, grain),
+        .body = body,
+        .context = context
+    };
+
+    job.chunks = (last - first + job.grain - 1) / job.grain;
+    c3e_pool_launch(&job);
+}
+
+void c3e_parallel_reduce(size_t first, size_t last, size_t grain, void* result, size_t size, c3e_parallel_reduce_body body, c3e_parallel_join join, void* context) {
+    c3e_assert(first < last && result != NULL && size != 0);
+    c3e_assert(body != NULL && join != NULL);
+
+    c3e_pool_job job = {
+        .first = first,
+        .last = last,
+        .grain = c3e_pool_grain(last - first, grain),
+        .reduce = body,
+        .join = join,
+        .size = size,
+        .context = context
+    };
+
+    job.chunks = (last - first + job.grain - 1) / job.grain;
+    job.slots = (uint8_t*) malloc(job.chunks * size);
+
+    if(job.slots == NULL) {
+        body(first, last, result, context);
+        return;
+    }
+
+    c3e_pool_launch(&job);
+    memcpy(result, job.slots, size);
+    free(job.slots);
+}
+
+typedef struct {
+    void (*task)(void*);
+    uint8_t* tasks;
+    size_t size;
+} c3e_pool_batch;
+
+static void c3e_pool_invoke(size_t first, size_t last, void* context) {
+    c3e_pool_batch* batch = (c3e_pool_batch*) context;
+
+    for(size_t i = first; i < last; i++)
+        batch->task(batch->tasks + i * batch->size);
+}
+
+void c3e_parallel_invoke(void (*task)(void*), void* tasks, size_t size, uint32_t count) {
+    c3e_assert(task != NULL && (tasks != NULL || count == 0));
+
+    c3e_pool_batch batch = {task, (uint8_t*) tasks, size};
+    c3e_parallel_for(0, count, 1, c3e_pool_invoke, &batch);
+}
+
+static void c3e_pool_detached(void* argument) {
+    c3e_pool_execute((c3e_pool_task*) argument);
+}
+
+void c3e_pool_group_init(c3e_pool_group* group) {
+    c3e_assert(group != NULL);
+    atomic_init(&group->pending, 0);
+}
+
+void c3e_pool_spawn(c3e_pool_group* group, void (*task)(void*), void* argument) {
+    c3e_assert(group != NULL && task != NULL);
+
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+    c3e_pool_task* spawned = (c3e_pool_task*) calloc(1, sizeof(c3e_pool_task));
+
+    if(spawned == NULL) {
+        task(argument);
+        c3e_pool_finish(group);
+
+        return;
+    }
+
+    c3e_context* context = c3e_context_current();
+    c3e_executor executor = context->settings.executor;
+
+    spawned->run = task;
+    spawned->argument = argument;
+    spawned->group = group;
+    spawned->settings = context->settings;
+    context->counters.tasks++;
+
+    if(c3e_pool_self != NULL) {
+        if(c3e_pool_push(c3e_pool_self, spawned))
+            c3e_pool_notify();
+        else c3e_pool_execute(spawned);
+    }
+    else if(executor.submit != NULL)
+        executor.submit(c3e_pool_detached, spawned, executor.executor);
+    else if(c3e_pool_ensure() != 0)
+        c3e_pool_inject(spawned);
+    else c3e_pool_execute(spawned);
+}
+
+void c3e_pool_group_wait(c3e_pool_group* group) {
+    c3e_assert(group != NULL);
+
+    for(uint32_t spins = 0;; spins++) {
+        uint32_t pending = atomic_load_explicit(&group->pending, memory_order_acquire);
+        if(pending == 0)
+            return;
+
+        if(c3e_pool_self != NULL) {
+            c3e_pool_task* task = c3e_pool_find(c3e_pool_self);
+
+            if(task != NULL) {
+                c3e_pool_execute(task);
+                spins = 0;
+            }
+            else if(spins >= C3E_POOL_SPINS)
+                sched_yield();
+        }
+        else c3e_pool_wait(&group->pending, pending);
+    }
+}
\ No newline at end of file
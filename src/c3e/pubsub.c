@@ -0,0 +1,329 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/pubsub.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+static size_t c3e_frame_capacity(size_t count, c3e_dtype dtype, c3e_codec codec) {
+    if(dtype != C3E_DTYPE_NATIVE)
+        return count * c3e_dtype_size(dtype);
+    else if(codec == C3E_CODEC_NONE)
+        return count * sizeof(c3e_number);
+
+    size_t capacity = 0, first = 0;
+    do {
+        size_t length = count - first < C3E_CODEC_BLOCK ? count - first : C3E_CODEC_BLOCK;
+
+        capacity += sizeof(uint64_t) + c3e_codec_bound(codec, length);
+        first += length;
+    } while(first < count);
+
+    return capacity;
+}
+
+static c3e_frame* c3e_frame_init(c3e_matrix* matrix, c3e_dtype dtype, c3e_codec codec) {
+    size_t count = (size_t) matrix->rows * matrix->cols;
+    size_t capacity = c3e_frame_capacity(count, dtype, codec);
+
+    c3e_frame* frame = (c3e_frame*) malloc(sizeof(c3e_frame));
+    if(frame == NULL)
+        return NULL;
+
+    frame->data = malloc(sizeof(c3e_message_header) + capacity);
+    frame->refs = 1;
+
+    if(frame->data == NULL) {
+        free(frame);
+        return NULL;
+    }
+
+    c3e_message_header header = {0};
+    header.magic = C3E_MESSAGE_MAGIC;
+    header.dtype = (uint8_t) dtype;
+    header.codec = (uint8_t) (dtype == C3E_DTYPE_NATIVE ? codec : C3E_CODEC_NONE);
+    header.rows = matrix->rows;
+    header.cols = matrix->cols;
+
+    uint8_t* body = (uint8_t*) frame->data + sizeof(header);
+    memcpy(frame->data, &header, sizeof(header));
+
+    if(dtype == C3E_DTYPE_NATIVE && codec != C3E_CODEC_NONE) {
+        uint8_t* cursor = body;
+        size_t first = 0;
+
+        do {
+            size_t length = count - first < C3E_CODEC_BLOCK ? count - first : C3E_CODEC_BLOCK;
+            size_t left = capacity - (size_t) (cursor - body);
+            uint64_t size = c3e_codec_encode(codec, matrix->data + first, length,
+                cursor + sizeof(size), left - sizeof(size));
+
+            if(size == 0) {
+                free(frame->data);
+                free(frame);
+
+                return NULL;
+            }
+
+            memcpy(cursor, &size, sizeof(size));
+            cursor += sizeof(size) + size;
+            first += length;
+        } while(first < count);
+
+        frame->size = sizeof(header) + (size_t) (cursor - body);
+    }
+    else {
+        c3e_dtype_narrow(dtype, matrix->data, body, count);
+        frame->size = sizeof(header) + capacity;
+    }
+
+    return frame;
+}
+
+static void c3e_frame_unref(c3e_frame* frame) {
+    if(--frame->refs == 0) {
+        free(frame->data);
+        free(frame);
+    }
+}
+
+static void c3e_subscriber_drain(c3e_subscriber* subscriber) {
+    while(subscriber->count > 0) {
+        c3e_frame_unref(subscriber->queue[subscriber->head]);
+
+        subscriber->head = (subscriber->head + 1) % subscriber->broker->depth;
+        subscriber->count--;
+    }
+}
+
+static void* c3e_subscriber_run(void* argument) {
+    c3e_subscriber* subscriber = (c3e_subscriber*) argument;
+    c3e_broker* broker = subscriber->broker;
+
+    c3e_context_current()->settings = subscriber->settings;
+
+    pthread_mutex_lock(&broker->lock);
+    while(true) {
+        while(subscriber->count == 0 && !broker->stopping)
+            pthread_cond_wait(&subscriber->ready, &broker->lock);
+
+        if(subscriber->count == 0)
+            break;
+
+        c3e_frame* frame = subscriber->queue[subscriber->head];
+        subscriber->head = (subscriber->head + 1) % broker->depth;
+        subscriber->count--;
+
+        pthread_cond_broadcast(&broker->space);
+        pthread_mutex_unlock(&broker->lock);
+
+        bool sent = c3e_socket_send_data(&subscriber->socket, frame->data, frame->size);
+
+        pthread_mutex_lock(&broker->lock);
+        c3e_frame_unref(frame);
+
+        if(!sent) {
+            subscriber->alive = false;
+            c3e_subscriber_drain(subscriber);
+
+            pthread_cond_broadcast(&broker->space);
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&broker->lock);
+    return NULL;
+}
+
+c3e_broker* c3e_broker_init(uint32_t depth, c3e_dtype dtype, c3e_codec codec) {
+    c3e_assert(depth != 0);
+    c3e_assert(c3e_dtype_size(dtype) != 0);
+
+    c3e_broker* broker = (c3e_broker*) malloc(sizeof(c3e_broker));
+    if(broker == NULL)
+        return NULL;
+
+    broker->subscribers = NULL;
+    broker->count = 0;
+    broker->capacity = 0;
+    broker->depth = depth;
+    broker->dtype = dtype;
+    broker->codec = codec;
+    broker->stopping = false;
+
+    if(pthread_mutex_init(&broker->lock, NULL) != 0) {
+        free(broker);
+        return NULL;
+    }
+
+    if(pthread_cond_init(&broker->space, NULL) != 0) {
+        pthread_mutex_destroy(&broker->lock);
+        free(broker);
+
+        return NULL;
+    }
+
+    return broker;
+}
+
+void c3e_broker_free(c3e_broker* broker) {
+    c3e_assert(broker != NULL);
+
+    pthread_mutex_lock(&broker->lock);
+    broker->stopping = true;
+
+    for(uint32_t i = 0; i < broker->count; i++)
+        pthread_cond_signal(&broker->subscribers[i]->ready);
+
+    pthread_cond_broadcast(&broker->space);
+    pthread_mutex_unlock(&broker->lock);
+
+    for(uint32_t i = 0; i < broker->count; i++) {
+        c3e_subscriber* subscriber = broker->subscribers[i];
+        pthread_join(subscriber->thread, NULL);
+
+        c3e_subscriber_drain(subscriber);
+        c3e_socket_close(&subscriber->socket);
+
+        pthread_cond_destroy(&subscriber->ready);
+        free(subscriber->queue);
+        free(subscriber);
+    }
+
+    pthread_cond_destroy(&broker->space);
+    pthread_mutex_destroy(&broker->lock);
+
+    free(broker->subscribers);
+    free(broker);
+}
+
+c3e_subscriber* c3e_broker_subscribe(c3e_broker* broker, c3e_socket* socket, c3e_broker_policy policy) {
+    c3e_assert(broker != NULL);
+    c3e_assert(socket != NULL);
+
+    c3e_subscriber* subscriber = (c3e_subscriber*) malloc(sizeof(c3e_subscriber));
+    if(subscriber == NULL)
+        return NULL;
+
+    subscriber->broker = broker;
+    subscriber->socket = *socket;
+    subscriber->policy = policy;
+    subscriber->queue = (c3e_frame**) malloc(broker->depth * sizeof(c3e_frame*));
+    subscriber->head = 0;
+    subscriber->count = 0;
+    subscriber->alive = true;
+    subscriber->dropped = 0;
+    subscriber->settings = c3e_context_current()->settings;
+
+    if(subscriber->queue == NULL || pthread_cond_init(&subscriber->ready, NULL) != 0) {
+        free(subscriber->queue);
+        free(subscriber);
+
+        return NULL;
+    }
+
+    pthread_mutex_lock(&broker->lock);
+    if(broker->count == broker->capacity) {
+        uint32_t capacity = broker->capacity == 0 ? 8 : broker->capacity * 2;
+        c3e_subscriber** subscribers = (c3e_subscriber**) realloc(
+            broker->subscribers,
+            capacity * sizeof(c3e_subscriber*)
+        );
+
+        if(subscribers == NULL) {
+            pthread_mutex_unlock(&broker->lock);
+            pthread_cond_destroy(&subscriber->ready);
+
+            free(subscriber->queue);
+            free(subscriber);
+            return NULL;
+        }
+
+        broker->subscribers = subscribers;
+        broker->capacity = capacity;
+    }
+
+    if(pthread_create(&subscriber->thread, NULL, c3e_subscriber_run, subscriber) != 0) {
+        pthread_mutex_unlock(&broker->lock);
+        pthread_cond_destroy(&subscriber->ready);
+
+        free(subscriber->queue);
+        free(subscriber);
+        return NULL;
+    }
+
+    broker->subscribers[broker->count++] = subscriber;
+    pthread_mutex_unlock(&broker->lock);
+
+    return subscriber;
+}
+
+bool c3e_broker_publish(c3e_broker* broker, c3e_matrix* matrix) {
+    c3e_assert(broker != NULL);
+    c3e_assert(matrix != NULL);
+
+    c3e_frame* frame = c3e_frame_init(matrix, broker->dtype, broker->codec);
+    if(frame == NULL)
+        return false;
+
+    pthread_mutex_lock(&broker->lock);
+    for(uint32_t i = 0; i < broker->count; i++) {
+        c3e_subscriber* subscriber = broker->subscribers[i];
+
+        if(subscriber->policy == C3E_BROKER_BACKPRESSURE)
+            while(subscriber->alive && subscriber->count == broker->depth && !broker->stopping)
+                pthread_cond_wait(&broker->space, &broker->lock);
+
+        if(!subscriber->alive || broker->stopping)
+            continue;
+
+        if(subscriber->count == broker->depth) {
+            c3e_frame_unref(subscriber->queue[subscriber->head]);
+
+            subscriber->head = (subscriber->head + 1) % broker->depth;
+            subscriber->count--;
+            subscriber->dropped++;
+        }
+
+        subscriber->queue[(subscriber->head + subscriber->count) % broker->depth] = frame;
+        subscriber->count++;
+        frame->refs++;
+
+        pthread_cond_signal(&subscriber->ready);
+    }
+
+    c3e_frame_unref(frame);
+    pthread_mutex_unlock(&broker->lock);
+
+    return true;
+}
+
+uint32_t c3e_broker_alive(c3e_broker* broker) {
+    c3e_assert(broker != NULL);
+
+    uint32_t alive = 0;
+    pthread_mutex_lock(&broker->lock);
+
+    for(uint32_t i = 0; i < broker->count; i++)
+        if(broker->subscribers[i]->alive)
+            alive++;
+
+    pthread_mutex_unlock(&broker->lock);
+    return alive;
+}
\ No newline at end of file
@@ -16,37 +16,742 @@
  */
 
 #include <c3e/assert.h>
+#include <c3e/context.h>
+#include <c3e/pool.h>
 #include <c3e/random.h>
+#include <c3e/trigo.h>
 
 #include <fcntl.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
-c3e_number c3e_random() {
-    int urandom = open("/dev/urandom", O_RDONLY);
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define C3E_PHILOX_M0       0xd2511f53u
+#define C3E_PHILOX_M1       0xcd9e8d57u
+#define C3E_PHILOX_W0       0x9e3779b9u
+#define C3E_PHILOX_W1       0xbb67ae85u
+#define C3E_PHILOX_ROUNDS   10
+
+#define C3E_RNG_PARALLEL    65536
+
+#ifndef C3E_32BIT_NUMBER
+#define C3E_RNG_WORDS 2
+#else
+#define C3E_RNG_WORDS 1
+#endif
+
+#define C3E_RNG_PER_BLOCK   (4 / C3E_RNG_WORDS)
+#define C3E_RNG_SHUFFLE     65536
+
+typedef struct {
+    c3e_rng rng;
+    c3e_number* data;
+    size_t count;
+    c3e_number min;
+    c3e_number max;
+} c3e_rng_range;
+
+typedef struct {
+    c3e_rng* rng;
+    uint32_t* source;
+    uint32_t* target;
+    uint32_t count;
+    uint32_t width;
+    uint32_t level;
+} c3e_rng_shuffle_task;
+
+static inline uint64_t c3e_rng_mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+
+    return x ^ (x >> 31);
+}
+
+static void c3e_philox(const uint32_t key[2], uint64_t counter, uint64_t stream, uint32_t out[4]) {
+    uint32_t c0 = (uint32_t) counter, c1 = (uint32_t) (counter >> 32);
+    uint32_t c2 = (uint32_t) stream, c3 = (uint32_t) (stream >> 32);
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for(int round = 0; round < C3E_PHILOX_ROUNDS; round++) {
+        uint64_t p0 = (uint64_t) C3E_PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t) C3E_PHILOX_M1 * c2;
+
+        c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t) p1;
+        c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t) p0;
+
+        k0 += C3E_PHILOX_W0;
+        k1 += C3E_PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+#ifdef __SSE2__
+static inline void c3e_philox_mulhilo(__m128i x, __m128i m, __m128i* lo, __m128i* hi) {
+    __m128i even = _mm_shuffle_epi32(_mm_mul_epu32(x, m), _MM_SHUFFLE(3, 1, 2, 0));
+    __m128i odd = _mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_epi64(x, 32), m), _MM_SHUFFLE(3, 1, 2, 0));
+
+    *lo = _mm_unpacklo_epi32(even, odd);
+    *hi = _mm_unpackhi_epi32(even, odd);
+}
+
+static void c3e_philox4(const uint32_t key[2], uint64_t counter, uint64_t stream, uint32_t out[16]) {
+    uint64_t next[4] = {counter, counter + 1, counter + 2, counter + 3};
+    __m128i c0 = _mm_setr_epi32(
+        (int) (uint32_t) next[0], (int) (uint32_t) next[1],
+        (int) (uint32_t) next[2], (int) (uint32_t) next[3]
+    );
+    __m128i c1 = _mm_setr_epi32(
+        (int) (uint32_t) (next[0] >> 32), (int) (uint32_t) (next[1] >> 32),
+        (int) (uint32_t) (next[2] >> 32), (int) (uint32_t) (next[3] >> 32)
+    );
+    __m128i c2 = _mm_set1_epi32((int) (uint32_t) stream);
+    __m128i c3 = _mm_set1_epi32((int) (uint32_t) (stream >> 32));
+
+    const __m128i m0 = _mm_set1_epi32((int) C3E_PHILOX_M0);
+    const __m128i m1 = _mm_set1_epi32((int) C3E_PHILOX_M1);
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for(int round = 0; round < C3E_PHILOX_ROUNDS; round++) {
+        __m128i lo0, hi0, lo1, hi1;
+
+        c3e_philox_mulhilo(c0, m0, &lo0, &hi0);
+        c3e_philox_mulhilo(c2, m1, &lo1, &hi1);
+
+        c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32((int) k0));
+        c1 = lo1;
+        c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32((int) k1));
+        c3 = lo0;
+
+        k0 += C3E_PHILOX_W0;
+        k1 += C3E_PHILOX_W1;
+    }
+
+    __m128i t0 = _mm_unpacklo_epi32(c0, c1), t1 = _mm_unpacklo_epi32(c2, c3);
+    __m128i t2 = _mm_unpackhi_epi32(c0, c1), t3 = _mm_unpackhi_epi32(c2, c3);
+
+    _mm_storeu_si128((__m128i*) out, _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128((__m128i*) (out + 4), _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128((__m128i*) (out + 8), _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128((__m128i*) (out + 12), _mm_unpackhi_epi64(t2, t3));
+}
+#endif
+
+static inline c3e_number c3e_rng_number(const uint32_t* words) {
+#ifndef C3E_32BIT_NUMBER
+    return (c3e_number) (((uint64_t) words[0] << 21) ^ (words[1] >> 11)) * 0x1.0p-53;
+#else
+    return (c3e_number) (words[0] >> 8) * 0x1.0p-24f;
+#endif
+}
+
+void c3e_rng_init(c3e_rng* rng, uint64_t seed, uint64_t stream) {
+    c3e_assert(rng != NULL);
+
+    uint64_t key = c3e_rng_mix(seed);
+    rng->key[0] = (uint32_t) key;
+    rng->key[1] = (uint32_t) (key >> 32);
+    rng->stream = stream;
+    rng->counter = 0;
+    rng->used = 4;
+}
+
+uint32_t c3e_rng_next(c3e_rng* rng) {
+    if(rng->used == 4) {
+        c3e_philox(rng->key, rng->counter++, rng->stream, rng->block);
+        rng->used = 0;
+    }
+
+    return rng->block[rng->used++];
+}
+
+c3e_number c3e_rng_uniform(c3e_rng* rng) {
+    uint32_t words[C3E_RNG_WORDS];
+
+    for(int i = 0; i < C3E_RNG_WORDS; i++)
+        words[i] = c3e_rng_next(rng);
+    return c3e_rng_number(words);
+}
+
+void c3e_rng_fill(c3e_rng* rng, c3e_number* data, size_t count, c3e_number min, c3e_number max) {
+    c3e_assert(rng != NULL && (data != NULL || count == 0));
+
+    c3e_number range = max - min;
+    size_t i = 0;
+
+    while(i < count && rng->used != 4)
+        data[i++] = min + range * c3e_rng_uniform(rng);
+
+#ifdef __SSE2__
+    uint32_t words[16];
+    for(; count - i >= 16 / C3E_RNG_WORDS; rng->counter += 4) {
+        c3e_philox4(rng->key, rng->counter, rng->stream, words);
+
+        for(int j = 0; j < 16; j += C3E_RNG_WORDS)
+            data[i++] = min + range * c3e_rng_number(words + j);
+    }
+#endif
+
+    uint32_t block[4];
+    for(; count - i >= 4 / C3E_RNG_WORDS; rng->counter++) {
+        c3e_philox(rng->key, rng->counter, rng->stream, block);
+
+        for(int j = 0; j < 4; j += C3E_RNG_WORDS)
+            data[i++] = min + range * c3e_rng_number(block + j);
+    }
+
+    while(i < count)
+        data[i++] = min + range * c3e_rng_uniform(rng);
+}
+
+void c3e_rng_seek(c3e_rng* rng, uint64_t position) {
+    c3e_assert(rng != NULL);
+
+    rng->counter = position / C3E_RNG_PER_BLOCK;
+    rng->used = 4;
+
+    if(position % C3E_RNG_PER_BLOCK != 0) {
+        c3e_philox(rng->key, rng->counter++, rng->stream, rng->block);
+        rng->used = (uint32_t) (position % C3E_RNG_PER_BLOCK) * C3E_RNG_WORDS;
+    }
+}
+
+static uint32_t c3e_rng_threads(uint32_t threads) {
+    return threads != 0 ? threads : c3e_pool_size();
+}
+
+static void c3e_rng_fill_range(void* argument) {
+    c3e_rng_range* range = (c3e_rng_range*) argument;
+
+    c3e_rng_fill(&range->rng, range->data, range->count, range->min, range->max);
+}
+
+void c3e_rng_fill_parallel(c3e_rng* rng, c3e_number* data, size_t count, c3e_number min, c3e_number max, uint32_t threads) {
+    c3e_assert(rng != NULL && (data != NULL || count == 0));
+
+    threads = c3e_rng_threads(threads);
+    size_t head = 0;
+    while(head < count && rng->used != 4)
+        data[head++] = min + (max - min) * c3e_rng_uniform(rng);
+
+    size_t blocks = (count - head) / C3E_RNG_PER_BLOCK;
+    if(blocks / threads * C3E_RNG_PER_BLOCK < C3E_RNG_PARALLEL)
+        threads = (uint32_t) (blocks * C3E_RNG_PER_BLOCK / C3E_RNG_PARALLEL) + 1;
+
+    c3e_rng_range* ranges = (c3e_rng_range*) malloc(threads * sizeof(c3e_rng_range));
+    if(threads == 1 || ranges == NULL) {
+        free(ranges);
+        c3e_rng_fill(rng, data + head, count - head, min, max);
+
+        return;
+    }
+
+    for(uint32_t i = 0; i < threads; i++) {
+        size_t first = blocks * i / threads, last = blocks * (i + 1) / threads;
+
+        ranges[i].rng = *rng;
+        ranges[i].rng.counter = rng->counter + first;
+        ranges[i].data = data + head + first * C3E_RNG_PER_BLOCK;
+        ranges[i].count = (last - first) * C3E_RNG_PER_BLOCK;
+        ranges[i].min = min;
+        ranges[i].max = max;
+    }
+
+    c3e_parallel_invoke(c3e_rng_fill_range, ranges, sizeof(c3e_rng_range), threads);
+    free(ranges);
+
+    rng->counter += blocks;
+    c3e_rng_fill(rng, data + head + blocks * C3E_RNG_PER_BLOCK, count - head - blocks * C3E_RNG_PER_BLOCK, min, max);
+}
+
+uint32_t c3e_rng_below(c3e_rng* rng, uint32_t bound) {
+    c3e_assert(bound != 0);
+
+    uint64_t product = (uint64_t) c3e_rng_next(rng) * bound;
+    uint32_t low = (uint32_t) product;
+
+    if(low < bound) {
+        uint32_t threshold = -bound % bound;
+
+        while(low < threshold) {
+            product = (uint64_t) c3e_rng_next(rng) * bound;
+            low = (uint32_t) product;
+        }
+    }
+
+    return (uint32_t) (product >> 32);
+}
+
+static c3e_rng c3e_rng_child(c3e_rng* rng, uint64_t node) {
+    c3e_rng child = *rng;
+
+    child.stream = c3e_rng_mix(rng->stream ^ c3e_rng_mix(rng->counter + node * 0x9e3779b97f4a7c15ull));
+    child.counter = 0;
+    child.used = 4;
+
+    return child;
+}
+
+static void c3e_rng_fisher_yates(c3e_rng* rng, uint32_t* indices, uint32_t count) {
+    for(uint32_t i = count; i > 1; i--) {
+        uint32_t j = c3e_rng_below(rng, i), swap = indices[i - 1];
+
+        indices[i - 1] = indices[j];
+        indices[j] = swap;
+    }
+}
+
+static void c3e_rng_merge(c3e_rng* rng, const uint32_t* left, uint32_t left_count, const uint32_t* right, uint32_t right_count, uint32_t* out) {
+    uint32_t i = 0, j = 0, k = 0, bits = 0, remaining = 0;
+
+    while(true) {
+        if(remaining == 0) {
+            bits = c3e_rng_next(rng);
+            remaining = 32;
+        }
+
+        bool from_left = bits & 1;
+        bits >>= 1;
+        remaining--;
+
+        if(from_left && i < left_count)
+            out[k++] = left[i++];
+        else if(!from_left && j < right_count)
+            out[k++] = right[j++];
+        else break;
+    }
+
+    for(; i < left_count; i++, k++) {
+        uint32_t position = c3e_rng_below(rng, k + 1);
+
+        out[k] = out[position];
+        out[position] = left[i];
+    }
+
+    for(; j < right_count; j++, k++) {
+        uint32_t position = c3e_rng_below(rng, k + 1);
+
+        out[k] = out[position];
+        out[position] = right[j];
+    }
+}
+
+static void c3e_rng_shuffle_leaves(size_t first, size_t last, void* context) {
+    c3e_rng_shuffle_task* task = (c3e_rng_shuffle_task*) context;
+
+    for(uint32_t b = (uint32_t) first; b < last; b++) {
+        uint32_t start = b * C3E_RNG_SHUFFLE;
+        uint32_t length = task->count - start < C3E_RNG_SHUFFLE ? task->count - start : C3E_RNG_SHUFFLE;
+        c3e_rng child = c3e_rng_child(task->rng, b);
+
+        c3e_rng_fisher_yates(&child, task->source + start, length);
+    }
+}
+
+static void c3e_rng_shuffle_merges(size_t first, size_t last, void* context) {
+    c3e_rng_shuffle_task* task = (c3e_rng_shuffle_task*) context;
+
+    for(uint32_t p = (uint32_t) first; p < last; p++) {
+        uint64_t start = (uint64_t) p * 2 * task->width;
+        uint64_t middle = start + task->width < task->count ? start + task->width : task->count;
+        uint64_t end = middle + task->width < task->count ? middle + task->width : task->count;
+        c3e_rng child = c3e_rng_child(task->rng, ((uint64_t) task->level << 32) | p);
+
+        c3e_rng_merge(
+            &child,
+            task->source + start, (uint32_t) (middle - start),
+            task->source + middle, (uint32_t) (end - middle),
+            task->target + start
+        );
+    }
+}
+
+static void c3e_rng_shuffle_level(c3e_parallel_body body, c3e_rng_shuffle_task* task, uint32_t units, uint32_t threads) {
+    c3e_parallel_for(0, units, (units + threads - 1) / threads, body, task);
+}
+
+bool c3e_rng_shuffle(c3e_rng* rng, uint32_t* indices, uint32_t count, uint32_t threads) {
+    c3e_assert(rng != NULL && (indices != NULL || count == 0));
+
+    if(count <= C3E_RNG_SHUFFLE) {
+        c3e_rng_fisher_yates(rng, indices, count);
+        return true;
+    }
 
-    if(urandom == -1) {
-        srand(time(NULL));
-        return c3e_random_pseudo();
+    uint32_t* buffer = (uint32_t*) malloc((size_t) count * sizeof(uint32_t));
+    if(buffer == NULL)
+        return false;
+
+    threads = c3e_rng_threads(threads);
+    c3e_rng_shuffle_task task = {rng, indices, buffer, count, C3E_RNG_SHUFFLE, 0};
+
+    uint32_t leaves = (uint32_t) (((uint64_t) count + C3E_RNG_SHUFFLE - 1) / C3E_RNG_SHUFFLE);
+    c3e_rng_shuffle_level(c3e_rng_shuffle_leaves, &task, leaves, threads);
+
+    for(task.level = 1; task.width < count; task.level++, task.width *= 2) {
+        uint32_t pairs = (uint32_t) (((uint64_t) count + 2 * (uint64_t) task.width - 1) / (2 * (uint64_t) task.width));
+        c3e_rng_shuffle_level(c3e_rng_shuffle_merges, &task, pairs, threads);
+
+        uint32_t* swap = task.source;
+        task.source = task.target;
+        task.target = swap;
+    }
+
+    if(task.source != indices)
+        memcpy(indices, task.source, (size_t) count * sizeof(uint32_t));
+
+    free(buffer);
+    rng->counter++;
+    rng->used = 4;
+
+    return true;
+}
+
+bool c3e_rng_permutation(c3e_rng* rng, uint32_t* indices, uint32_t count, uint32_t threads) {
+    c3e_assert(indices != NULL || count == 0);
+
+    for(uint32_t i = 0; i < count; i++)
+        indices[i] = i;
+    return c3e_rng_shuffle(rng, indices, count, threads);
+}
+
+bool c3e_rng_sample(c3e_rng* rng, uint32_t population, uint32_t* indices, uint32_t count) {
+    c3e_assert(rng != NULL && count <= population);
+    c3e_assert(indices != NULL || count == 0);
+
+    uint64_t capacity = 16;
+    while(capacity < 2 * (uint64_t) count)
+        capacity *= 2;
+
+    uint32_t* table = (uint32_t*) malloc(capacity * sizeof(uint32_t));
+    if(table == NULL)
+        return false;
+
+    memset(table, 0xff, capacity * sizeof(uint32_t));
+    for(uint32_t n = 0, j = population - count; n < count; n++, j++) {
+        uint32_t chosen = c3e_rng_below(rng, j + 1);
+        uint64_t slot = c3e_rng_mix(chosen) & (capacity - 1);
+
+        while(table[slot] != UINT32_MAX && table[slot] != chosen)
+            slot = (slot + 1) & (capacity - 1);
+
+        if(table[slot] == chosen) {
+            chosen = j;
+            slot = c3e_rng_mix(chosen) & (capacity - 1);
+
+            while(table[slot] != UINT32_MAX)
+                slot = (slot + 1) & (capacity - 1);
+        }
+
+        table[slot] = chosen;
+        indices[n] = chosen;
     }
 
-    uint32_t rand_num;
-    ssize_t bytes_read = read(urandom, &rand_num, sizeof(rand_num));
+    free(table);
+    c3e_rng_fisher_yates(rng, indices, count);
+
+    return true;
+}
+
+c3e_reservoir* c3e_reservoir_init(uint32_t capacity) {
+    c3e_assert(capacity != 0);
+
+    c3e_reservoir* reservoir = (c3e_reservoir*) malloc(sizeof(c3e_reservoir));
+    if(reservoir == NULL)
+        return NULL;
+
+    reservoir->indices = (uint64_t*) malloc(capacity * sizeof(uint64_t));
+    reservoir->capacity = capacity;
+    reservoir->count = 0;
+    reservoir->seen = 0;
+    reservoir->next = 0;
+    reservoir->weight = 0;
+
+    if(reservoir->indices == NULL) {
+        free(reservoir);
+        return NULL;
+    }
+
+    return reservoir;
+}
+
+void c3e_reservoir_free(c3e_reservoir* reservoir) {
+    c3e_assert(reservoir != NULL);
+
+    free(reservoir->indices);
+    free(reservoir);
+}
+
+static void c3e_reservoir_advance(c3e_reservoir* reservoir, c3e_rng* rng) {
+    reservoir->weight *= exp(log(1 - c3e_rng_uniform(rng)) / reservoir->capacity);
+    reservoir->next += (uint64_t) floor(log(1 - c3e_rng_uniform(rng)) / log1p(-reservoir->weight)) + 1;
+}
+
+uint32_t c3e_reservoir_offer(c3e_reservoir* reservoir, c3e_rng* rng) {
+    c3e_assert(reservoir != NULL && rng != NULL);
+
+    uint64_t index = reservoir->seen++;
+    uint32_t slot;
+
+    if(reservoir->count < reservoir->capacity) {
+        slot = reservoir->count++;
+
+        if(reservoir->count == reservoir->capacity) {
+            reservoir->weight = 1;
+            reservoir->next = index;
+            c3e_reservoir_advance(reservoir, rng);
+        }
+    }
+    else if(index == reservoir->next) {
+        slot = c3e_rng_below(rng, reservoir->capacity);
+        c3e_reservoir_advance(reservoir, rng);
+    }
+    else return C3E_RESERVOIR_SKIP;
+
+    reservoir->indices[slot] = index;
+    return slot;
+}
+
+static inline c3e_number c3e_rng_open(c3e_rng* rng) {
+    return 1 - c3e_rng_uniform(rng);
+}
+
+static c3e_number c3e_rng_standard_gamma(c3e_rng* rng, c3e_number shape) {
+    if(shape < 1) {
+        c3e_number boost = pow(c3e_rng_open(rng), 1 / shape);
+        return c3e_rng_standard_gamma(rng, shape + 1) * boost;
+    }
+
+    c3e_number d = shape - (c3e_number) 1 / 3, c = 1 / sqrt(9 * d);
+    while(true) {
+        c3e_number x = c3e_rng_normal(rng, 0, 1), v = 1 + c * x;
+        if(v <= 0)
+            continue;
+
+        v = v * v * v;
+        c3e_number u = c3e_rng_open(rng), square = x * x;
+
+        if(u < 1 - (c3e_number) 0.0331 * square * square ||
+            log(u) < square / 2 + d * (1 - v + log(v)))
+            return d * v;
+    }
+}
+
+c3e_number c3e_rng_normal(c3e_rng* rng, c3e_number mean, c3e_number stddev) {
+    c3e_number radius = sqrt(-2 * log(c3e_rng_open(rng)));
+    return mean + stddev * radius * cos(2 * PI * c3e_rng_uniform(rng));
+}
+
+void c3e_rng_fill_normal(c3e_rng* rng, c3e_number* data, size_t count, c3e_number mean, c3e_number stddev) {
+    size_t pairs = count / 2 * 2;
+    c3e_rng_fill(rng, data, pairs, 0, 1);
+
+    for(size_t i = 0; i < pairs; i += 2) {
+        c3e_number radius = stddev * sqrt(-2 * log(1 - data[i]));
+        c3e_number angle = 2 * PI * data[i + 1];
+
+        data[i] = mean + radius * cos(angle);
+        data[i + 1] = mean + radius * sin(angle);
+    }
+
+    if(pairs != count)
+        data[pairs] = c3e_rng_normal(rng, mean, stddev);
+}
+
+c3e_number c3e_rng_exponential(c3e_rng* rng, c3e_number rate) {
+    c3e_assert(rate > 0);
+    return -log1p(-c3e_rng_uniform(rng)) / rate;
+}
+
+void c3e_rng_fill_exponential(c3e_rng* rng, c3e_number* data, size_t count, c3e_number rate) {
+    c3e_assert(rate > 0);
+    c3e_rng_fill(rng, data, count, 0, 1);
+
+    for(size_t i = 0; i < count; i++)
+        data[i] = -log1p(-data[i]) / rate;
+}
+
+c3e_number c3e_rng_gamma(c3e_rng* rng, c3e_number shape, c3e_number scale) {
+    c3e_assert(shape > 0 && scale > 0);
+    return scale * c3e_rng_standard_gamma(rng, shape);
+}
+
+void c3e_rng_fill_gamma(c3e_rng* rng, c3e_number* data, size_t count, c3e_number shape, c3e_number scale) {
+    c3e_assert(shape > 0 && scale > 0);
+
+    for(size_t i = 0; i < count; i++)
+        data[i] = scale * c3e_rng_standard_gamma(rng, shape);
+}
+
+c3e_number c3e_rng_poisson(c3e_rng* rng, c3e_number mean) {
+    c3e_assert(mean >= 0);
+
+    if(mean < 10) {
+        c3e_number limit = exp(-mean), product = c3e_rng_uniform(rng);
+        uint32_t k = 0;
+
+        while(product > limit) {
+            product *= c3e_rng_uniform(rng);
+            k++;
+        }
+
+        return (c3e_number) k;
+    }
+
+    c3e_number root = sqrt(mean), log_mean = log(mean);
+    c3e_number b = (c3e_number) 0.931 + (c3e_number) 2.53 * root;
+    c3e_number a = (c3e_number) -0.059 + (c3e_number) 0.02483 * b;
+    c3e_number inverse_alpha = (c3e_number) 1.1239 + (c3e_number) 1.1328 / (b - (c3e_number) 3.4);
+    c3e_number ratio = (c3e_number) 0.9277 - (c3e_number) 3.6224 / (b - 2);
+
+    while(true) {
+        c3e_number u = c3e_rng_uniform(rng) - (c3e_number) 0.5;
+        c3e_number v = c3e_rng_open(rng);
+        c3e_number us = (c3e_number) 0.5 - fabs(u);
+        c3e_number k = floor((2 * a / us + b) * u + mean + (c3e_number) 0.43);
+
+        if(us >= (c3e_number) 0.07 && v <= ratio)
+            return k;
+        else if(k < 0 || (us < (c3e_number) 0.013 && v > us))
+            continue;
+
+        if(log(v) + log(inverse_alpha) - log(a / (us * us) + b) <=
+            -mean + k * log_mean - c3e_log_gamma(k + 1))
+            return k;
+    }
+}
+
+void c3e_rng_fill_poisson(c3e_rng* rng, c3e_number* data, size_t count, c3e_number mean) {
+    for(size_t i = 0; i < count; i++)
+        data[i] = c3e_rng_poisson(rng, mean);
+}
+
+c3e_alias* c3e_alias_init(const c3e_number* weights, uint32_t count) {
+    c3e_assert(weights != NULL && count != 0);
+
+    c3e_number total = 0;
+    for(uint32_t i = 0; i < count; i++) {
+        c3e_assert(weights[i] >= 0);
+        total += weights[i];
+    }
+    c3e_assert(total > 0);
+
+    c3e_alias* alias = (c3e_alias*) malloc(sizeof(c3e_alias));
+    uint32_t* small = (uint32_t*) malloc(count * sizeof(uint32_t));
+    uint32_t* large = (uint32_t*) malloc(count * sizeof(uint32_t));
+
+    if(alias != NULL) {
+        alias->count = count;
+        alias->probability = (c3e_number*) malloc(count * sizeof(c3e_number));
+        alias->alias = (uint32_t*) malloc(count * sizeof(uint32_t));
+    }
+
+    if(alias == NULL || small == NULL || large == NULL ||
+        alias->probability == NULL || alias->alias == NULL) {
+        if(alias != NULL)
+            c3e_alias_free(alias);
+
+        free(small);
+        free(large);
+        return NULL;
+    }
+
+    uint32_t small_count = 0, large_count = 0;
+    for(uint32_t i = 0; i < count; i++) {
+        alias->probability[i] = weights[i] * count / total;
+        alias->alias[i] = i;
+
+        if(alias->probability[i] < 1)
+            small[small_count++] = i;
+        else large[large_count++] = i;
+    }
+
+    while(small_count != 0 && large_count != 0) {
+        uint32_t less = small[--small_count], more = large[large_count - 1];
+
+        alias->alias[less] = more;
+        alias->probability[more] -= 1 - alias->probability[less];
+
+        if(alias->probability[more] < 1) {
+            large_count--;
+            small[small_count++] = more;
+        }
+    }
+
+    while(large_count != 0)
+        alias->probability[large[--large_count]] = 1;
+    while(small_count != 0)
+        alias->probability[small[--small_count]] = 1;
+
+    free(small);
+    free(large);
+
+    return alias;
+}
+
+void c3e_alias_free(c3e_alias* alias) {
+    c3e_assert(alias != NULL);
+
+    free(alias->probability);
+    free(alias->alias);
+    free(alias);
+}
+
+static inline uint32_t c3e_alias_pick(c3e_alias* alias, c3e_number uniform) {
+    c3e_number scaled = uniform * alias->count;
+    uint32_t index = (uint32_t) scaled;
+
+    if(index >= alias->count)
+        index = alias->count - 1;
+    return scaled - index < alias->probability[index] ? index : alias->alias[index];
+}
+
+uint32_t c3e_rng_categorical(c3e_rng* rng, c3e_alias* alias) {
+    c3e_assert(alias != NULL);
+    return c3e_alias_pick(alias, c3e_rng_uniform(rng));
+}
+
+void c3e_rng_fill_categorical(c3e_rng* rng, c3e_alias* alias, c3e_number* data, size_t count) {
+    c3e_assert(alias != NULL);
+    c3e_rng_fill(rng, data, count, 0, 1);
+
+    for(size_t i = 0; i < count; i++)
+        data[i] = (c3e_number) c3e_alias_pick(alias, data[i]);
+}
+
+c3e_number c3e_random() {
+    c3e_context* context = c3e_context_current();
+
+    if(!context->seeded) {
+        uint64_t seed = 0;
+        int urandom = open("/dev/urandom", O_RDONLY);
+
+        if(urandom == -1 || read(urandom, &seed, sizeof(seed)) != sizeof(seed))
+            seed = (uint64_t) time(NULL) ^ (uint64_t) (uintptr_t) context;
+        if(urandom != -1)
+            close(urandom);
 
-    close(urandom);
-    if(bytes_read != sizeof(rand_num)) {
-        srand(time(NULL));
-        return c3e_random_pseudo();
+        c3e_rng_init(&context->rng, seed, 0);
+        context->seeded = true;
     }
 
-    srand(rand_num);
-    return c3e_random_pseudo();
+    return c3e_rng_uniform(&context->rng);
 }
 
 c3e_number c3e_random_pseudo() {
-    return (c3e_number) rand();
+    return c3e_rng_uniform(&c3e_context_current()->pseudo);
 }
 
 c3e_number c3e_random_bound(c3e_number min, c3e_number max) {
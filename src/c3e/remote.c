@@ -0,0 +1,456 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/context.h>
+#include <c3e/matrix.h>
+#include <c3e/remote.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+typedef struct {
+    uint32_t magic;
+    uint8_t op;
+    uint8_t reply;
+    uint16_t reserved;
+    char out[C3E_REMOTE_NAME_SIZE];
+    char left[C3E_REMOTE_NAME_SIZE];
+    char right[C3E_REMOTE_NAME_SIZE];
+    double scalar;
+} c3e_remote_request_header;
+
+typedef struct {
+    uint32_t magic;
+    uint8_t status;
+    uint8_t has_value;
+    uint16_t reserved;
+    uint32_t rows;
+    uint32_t cols;
+} c3e_remote_response_header;
+
+typedef struct {
+    c3e_remote_store* store;
+    c3e_socket client;
+    c3e_context_settings settings;
+} c3e_remote_connection;
+
+static c3e_remote_operand* c3e_remote_acquire(c3e_remote_store* store, const char* name) {
+    c3e_remote_operand* operand = NULL;
+    pthread_mutex_lock(&store->lock);
+
+    for(uint32_t i = 0; i < store->count; i++)
+        if(strcmp(store->entries[i].name, name) == 0) {
+            operand = store->entries[i].operand;
+            operand->refs++;
+
+            break;
+        }
+
+    pthread_mutex_unlock(&store->lock);
+    return operand;
+}
+
+static void c3e_remote_unref(c3e_remote_operand* operand) {
+    if(--operand->refs == 0) {
+        c3e_matrix_free(operand->matrix);
+        free(operand);
+    }
+}
+
+static void c3e_remote_release(c3e_remote_store* store, c3e_remote_operand* operand) {
+    pthread_mutex_lock(&store->lock);
+    c3e_remote_unref(operand);
+    pthread_mutex_unlock(&store->lock);
+}
+
+static c3e_remote_operand* c3e_remote_wrap(c3e_matrix* matrix) {
+    c3e_remote_operand* operand = (c3e_remote_operand*) malloc(sizeof(c3e_remote_operand));
+
+    if(operand == NULL) {
+        c3e_matrix_free(matrix);
+        return NULL;
+    }
+
+    operand->matrix = matrix;
+    operand->refs = 1;
+
+    return operand;
+}
+
+static bool c3e_remote_put(c3e_remote_store* store, const char* name, c3e_remote_operand* operand) {
+    bool stored = true;
+    uint32_t i = 0;
+
+    pthread_mutex_lock(&store->lock);
+    while(i < store->count && strcmp(store->entries[i].name, name) != 0)
+        i++;
+
+    if(i < store->count)
+        c3e_remote_unref(store->entries[i].operand);
+    else if(store->count == store->capacity) {
+        uint32_t capacity = store->capacity == 0 ? 16 : store->capacity * 2;
+        c3e_remote_entry* entries = (c3e_remote_entry*) realloc(
+            store->entries,
+            capacity * sizeof(c3e_remote_entry)
+        );
+
+        if(entries != NULL) {
+            store->entries = entries;
+            store->capacity = capacity;
+        }
+        else stored = false;
+    }
+
+    if(stored) {
+        if(i == store->count) {
+            memcpy(store->entries[i].name, name, C3E_REMOTE_NAME_SIZE);
+            store->count++;
+        }
+
+        store->entries[i].operand = operand;
+        operand->refs++;
+    }
+
+    pthread_mutex_unlock(&store->lock);
+    return stored;
+}
+
+static bool c3e_remote_drop(c3e_remote_store* store, const char* name) {
+    bool found = false;
+    pthread_mutex_lock(&store->lock);
+
+    for(uint32_t i = 0; i < store->count; i++)
+        if(strcmp(store->entries[i].name, name) == 0) {
+            c3e_remote_unref(store->entries[i].operand);
+            store->entries[i] = store->entries[--store->count];
+
+            found = true;
+            break;
+        }
+
+    pthread_mutex_unlock(&store->lock);
+    return found;
+}
+
+static bool c3e_remote_broadcastable(c3e_matrix* matrix, c3e_matrix* subject) {
+    return (matrix->rows == subject->rows || subject->rows == 1) &&
+        (matrix->cols == subject->cols || subject->cols == 1);
+}
+
+static c3e_remote_status c3e_remote_compute(c3e_remote_request_header* request, c3e_matrix* left, c3e_matrix* right, c3e_matrix** result) {
+    c3e_number scalar = (c3e_number) request->scalar;
+    *result = NULL;
+
+    switch((c3e_remote_op) request->op) {
+        case C3E_REMOTE_ADD:
+            if(!c3e_remote_broadcastable(left, right))
+                return C3E_REMOTE_INVALID;
+
+            *result = c3e_matrix_add(left, right);
+            break;
+
+        case C3E_REMOTE_SUB:
+            if(!c3e_remote_broadcastable(left, right))
+                return C3E_REMOTE_INVALID;
+
+            *result = c3e_matrix_sub(left, right);
+            break;
+
+        case C3E_REMOTE_MUL:
+            if(left->cols != right->rows)
+                return C3E_REMOTE_INVALID;
+
+            *result = c3e_matrix_mul(left, right);
+            break;
+
+        case C3E_REMOTE_DOT:
+            if(left->rows != right->rows || left->cols != right->cols)
+                return C3E_REMOTE_INVALID;
+
+            *result = c3e_matrix_dot(left, right);
+            break;
+
+        case C3E_REMOTE_TRANSPOSE:
+            *result = c3e_matrix_transpose(left);
+            break;
+
+        case C3E_REMOTE_INVERSE:
+            if(left->rows != left->cols || c3e_matrix_singular(left))
+                return C3E_REMOTE_INVALID;
+
+            *result = c3e_matrix_inverse(left);
+            break;
+
+        case C3E_REMOTE_SCALAR_ADD:
+            *result = c3e_matrix_scalar_add(left, scalar);
+            break;
+
+        case C3E_REMOTE_SCALAR_MUL:
+            *result = c3e_matrix_scalar_mul(left, scalar);
+            break;
+
+        default:
+            return C3E_REMOTE_INVALID;
+    }
+
+    return *result == NULL ? C3E_REMOTE_FAILED : C3E_REMOTE_OK;
+}
+
+static bool c3e_remote_binary(c3e_remote_op op) {
+    return op == C3E_REMOTE_ADD || op == C3E_REMOTE_SUB ||
+        op == C3E_REMOTE_MUL || op == C3E_REMOTE_DOT;
+}
+
+static c3e_remote_status c3e_remote_handle(c3e_remote_store* store, c3e_socket* client, c3e_remote_request_header* request, c3e_remote_operand** output, bool* valid) {
+    c3e_remote_op op = (c3e_remote_op) request->op;
+    *output = NULL;
+    *valid = true;
+
+    if(op == C3E_REMOTE_PUT) {
+        c3e_matrix* matrix = c3e_socket_typed_matrix_read(client);
+
+        if(matrix == NULL) {
+            *valid = false;
+            return C3E_REMOTE_FAILED;
+        }
+        else if(request->out[0] == '\0') {
+            c3e_matrix_free(matrix);
+            return C3E_REMOTE_INVALID;
+        }
+
+        *output = c3e_remote_wrap(matrix);
+        return *output == NULL ? C3E_REMOTE_FAILED : C3E_REMOTE_OK;
+    }
+    else if(op == C3E_REMOTE_DROP)
+        return c3e_remote_drop(store, request->left) ? C3E_REMOTE_OK : C3E_REMOTE_NOT_FOUND;
+
+    c3e_remote_operand* left = c3e_remote_acquire(store, request->left);
+    if(left == NULL)
+        return C3E_REMOTE_NOT_FOUND;
+    else if(op == C3E_REMOTE_GET) {
+        *output = left;
+        return C3E_REMOTE_OK;
+    }
+
+    c3e_remote_operand* right = NULL;
+    if(c3e_remote_binary(op) && (right = c3e_remote_acquire(store, request->right)) == NULL) {
+        c3e_remote_release(store, left);
+        return C3E_REMOTE_NOT_FOUND;
+    }
+
+    c3e_matrix* result;
+    c3e_remote_status status = c3e_remote_compute(
+        request,
+        left->matrix,
+        right == NULL ? NULL : right->matrix,
+        &result
+    );
+
+    c3e_remote_release(store, left);
+    if(right != NULL)
+        c3e_remote_release(store, right);
+
+    if(status == C3E_REMOTE_OK && (*output = c3e_remote_wrap(result)) == NULL)
+        status = C3E_REMOTE_FAILED;
+    return status;
+}
+
+static void* c3e_remote_connection_run(void* argument) {
+    c3e_remote_connection* connection = (c3e_remote_connection*) argument;
+    c3e_context_current()->settings = connection->settings;
+
+    c3e_remote_serve(connection->store, &connection->client);
+    c3e_socket_close(&connection->client);
+
+    free(connection);
+    return NULL;
+}
+
+c3e_remote_store* c3e_remote_store_init(void) {
+    c3e_remote_store* store = (c3e_remote_store*) malloc(sizeof(c3e_remote_store));
+    if(store == NULL)
+        return NULL;
+
+    store->entries = NULL;
+    store->count = 0;
+    store->capacity = 0;
+
+    if(pthread_mutex_init(&store->lock, NULL) != 0) {
+        free(store);
+        return NULL;
+    }
+
+    return store;
+}
+
+void c3e_remote_store_free(c3e_remote_store* store) {
+    c3e_assert(store != NULL);
+
+    for(uint32_t i = 0; i < store->count; i++)
+        c3e_remote_unref(store->entries[i].operand);
+
+    pthread_mutex_destroy(&store->lock);
+    free(store->entries);
+    free(store);
+}
+
+bool c3e_remote_serve(c3e_remote_store* store, c3e_socket* client) {
+    c3e_assert(store != NULL);
+    c3e_assert(client != NULL);
+
+    while(true) {
+        c3e_remote_request_header request;
+        uint8_t first;
+
+        if(recv(client->sockfd, &first, sizeof(first), MSG_PEEK) == 0)
+            return true;
+
+        if(!c3e_socket_receive_data(client, &request, sizeof(request)) ||
+            request.magic != C3E_REMOTE_MAGIC)
+            return false;
+
+        request.out[C3E_REMOTE_NAME_SIZE - 1] = '\0';
+        request.left[C3E_REMOTE_NAME_SIZE - 1] = '\0';
+        request.right[C3E_REMOTE_NAME_SIZE - 1] = '\0';
+
+        c3e_remote_operand* output;
+        bool valid;
+        c3e_remote_status status = c3e_remote_handle(store, client, &request, &output, &valid);
+
+        if(!valid)
+            return false;
+
+        if(output != NULL && request.out[0] != '\0' && request.op != C3E_REMOTE_GET &&
+            !c3e_remote_put(store, request.out, output))
+            status = C3E_REMOTE_FAILED;
+
+        c3e_remote_response_header response = {
+            C3E_REMOTE_MAGIC, (uint8_t) status,
+            status == C3E_REMOTE_OK && output != NULL && request.reply == C3E_REMOTE_REPLY_VALUE,
+            0,
+            output == NULL ? 0 : output->matrix->rows,
+            output == NULL ? 0 : output->matrix->cols
+        };
+
+        bool sent = c3e_socket_send_data(client, &response, sizeof(response)) &&
+            (!response.has_value ||
+                c3e_socket_send_matrix_typed(client, output->matrix, C3E_DTYPE_NATIVE));
+
+        if(output != NULL)
+            c3e_remote_release(store, output);
+
+        if(!sent)
+            return false;
+    }
+}
+
+bool c3e_remote_daemon(c3e_remote_store* store, const char* hostname, int port) {
+    c3e_assert(store != NULL);
+
+    c3e_socket server;
+    if(!c3e_socket_listen(&server, hostname, port, SOMAXCONN))
+        return false;
+
+    while(true) {
+        c3e_remote_connection* connection = (c3e_remote_connection*) malloc(sizeof(c3e_remote_connection));
+
+        if(connection == NULL || !c3e_socket_accept(&server, &connection->client)) {
+            free(connection);
+            break;
+        }
+
+        pthread_t thread;
+        connection->store = store;
+        connection->settings = c3e_context_current()->settings;
+
+        if(pthread_create(&thread, NULL, c3e_remote_connection_run, connection) != 0) {
+            c3e_socket_close(&connection->client);
+            free(connection);
+
+            continue;
+        }
+
+        pthread_detach(thread);
+    }
+
+    c3e_socket_close(&server);
+    return false;
+}
+
+bool c3e_remote_upload(c3e_socket* socket, const char* name, c3e_matrix* matrix) {
+    c3e_assert(matrix != NULL);
+
+    return c3e_remote_request(socket, C3E_REMOTE_PUT, name, NULL, NULL, 0.0, C3E_REMOTE_REPLY_HANDLE) &&
+        c3e_socket_send_matrix_typed(socket, matrix, C3E_DTYPE_NATIVE);
+}
+
+bool c3e_remote_request(c3e_socket* socket, c3e_remote_op op, const char* out, const char* left, const char* right, c3e_number scalar, c3e_remote_reply reply) {
+    c3e_assert(socket != NULL);
+    c3e_assert(out == NULL || strlen(out) < C3E_REMOTE_NAME_SIZE);
+    c3e_assert(left == NULL || strlen(left) < C3E_REMOTE_NAME_SIZE);
+    c3e_assert(right == NULL || strlen(right) < C3E_REMOTE_NAME_SIZE);
+
+    c3e_remote_request_header request;
+    memset(&request, 0, sizeof(request));
+
+    request.magic = C3E_REMOTE_MAGIC;
+    request.op = (uint8_t) op;
+    request.reply = (uint8_t) reply;
+    request.scalar = (double) scalar;
+
+    if(out != NULL)
+        strcpy(request.out, out);
+    if(left != NULL)
+        strcpy(request.left, left);
+    if(right != NULL)
+        strcpy(request.right, right);
+
+    return c3e_socket_send_data(socket, &request, sizeof(request));
+}
+
+bool c3e_remote_receive(c3e_socket* socket, c3e_remote_result* result) {
+    c3e_assert(socket != NULL);
+    c3e_assert(result != NULL);
+
+    c3e_remote_response_header response;
+    if(!c3e_socket_receive_data(socket, &response, sizeof(response)) ||
+        response.magic != C3E_REMOTE_MAGIC)
+        return false;
+
+    result->status = (c3e_remote_status) response.status;
+    result->rows = response.rows;
+    result->cols = response.cols;
+    result->value = NULL;
+
+    if(response.has_value) {
+        result->value = c3e_socket_typed_matrix_read(socket);
+
+        if(result->value == NULL ||
+            result->value->rows != response.rows ||
+            result->value->cols != response.cols) {
+            if(result->value != NULL)
+                c3e_matrix_free(result->value);
+
+            result->value = NULL;
+            return false;
+        }
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/matrix.h>
+#include <c3e/stream.h>
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+typedef struct {
+    c3e_matrix* matrix;
+    c3e_matrix* subject;
+} c3e_stream_operands;
+
+static c3e_event* c3e_event_init(void) {
+    c3e_event* event = (c3e_event*) malloc(sizeof(c3e_event));
+    if(event == NULL)
+        return NULL;
+
+    atomic_init(&event->done, 0);
+    atomic_init(&event->references, 2);
+    event->result = NULL;
+
+    return event;
+}
+
+static void c3e_event_complete(c3e_event* event, void* result) {
+    event->result = result;
+
+    atomic_store_explicit(&event->done, 1, memory_order_release);
+    syscall(SYS_futex, (uint32_t*) &event->done, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+static bool c3e_stream_push(c3e_stream* stream, c3e_stream_op op, void* argument, c3e_event* awaited, c3e_event* event) {
+    c3e_stream_entry* entry = (c3e_stream_entry*) malloc(sizeof(c3e_stream_entry));
+    if(entry == NULL)
+        return false;
+
+    entry->op = op;
+    entry->argument = argument;
+    entry->awaited = awaited;
+    entry->event = event;
+    entry->settings = c3e_context_current()->settings;
+    entry->next = NULL;
+
+    pthread_mutex_lock(&stream->lock);
+    if(stream->tail != NULL)
+        stream->tail->next = entry;
+    else stream->head = entry;
+
+    stream->tail = entry;
+    pthread_cond_signal(&stream->ready);
+    pthread_mutex_unlock(&stream->lock);
+
+    return true;
+}
+
+static void* c3e_stream_run(void* argument) {
+    c3e_stream* stream = (c3e_stream*) argument;
+
+    pthread_mutex_lock(&stream->lock);
+    while(true) {
+        while(stream->head == NULL && !stream->stopping)
+            pthread_cond_wait(&stream->ready, &stream->lock);
+
+        c3e_stream_entry* entry = stream->head;
+        if(entry == NULL)
+            break;
+
+        stream->head = entry->next;
+        if(stream->head == NULL)
+            stream->tail = NULL;
+        pthread_mutex_unlock(&stream->lock);
+
+        if(entry->awaited != NULL) {
+            c3e_event_wait(entry->awaited);
+            c3e_event_release(entry->awaited);
+        }
+
+        void* result = NULL;
+        if(entry->op != NULL) {
+            c3e_context* context = c3e_context_current();
+            c3e_context_settings settings = context->settings;
+
+            context->settings = entry->settings;
+            result = entry->op(entry->argument);
+            context->settings = settings;
+        }
+
+        if(entry->event != NULL) {
+            c3e_event_complete(entry->event, result);
+            c3e_event_release(entry->event);
+        }
+
+        free(entry);
+        pthread_mutex_lock(&stream->lock);
+    }
+
+    pthread_mutex_unlock(&stream->lock);
+    return NULL;
+}
+
+static void* c3e_stream_mul(void* argument) {
+    c3e_stream_operands* operands = (c3e_stream_operands*) argument;
+    c3e_matrix* product = c3e_matrix_mul(operands->matrix, operands->subject);
+
+    free(operands);
+    return product;
+}
+
+c3e_stream* c3e_stream_init(void) {
+    c3e_stream* stream = (c3e_stream*) malloc(sizeof(c3e_stream));
+    if(stream == NULL)
+        return NULL;
+
+    stream->head = NULL;
+    stream->tail = NULL;
+    stream->stopping = false;
+
+    pthread_mutex_init(&stream->lock, NULL);
+    pthread_cond_init(&stream->ready, NULL);
+
+    if(pthread_create(&stream->thread, NULL, c3e_stream_run, stream) != 0) {
+        pthread_mutex_destroy(&stream->lock);
+        pthread_cond_destroy(&stream->ready);
+        free(stream);
+
+        return NULL;
+    }
+
+    return stream;
+}
+
+void c3e_stream_free(c3e_stream* stream) {
+    c3e_assert(stream != NULL);
+
+    pthread_mutex_lock(&stream->lock);
+    stream->stopping = true;
+    pthread_cond_signal(&stream->ready);
+    pthread_mutex_unlock(&stream->lock);
+
+    pthread_join(stream->thread, NULL);
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->ready);
+    free(stream);
+}
+
+c3e_event* c3e_stream_enqueue(c3e_stream* stream, c3e_stream_op op, void* argument) {
+    c3e_assert(stream != NULL && op != NULL);
+
+    c3e_event* event = c3e_event_init();
+    if(event == NULL)
+        return NULL;
+
+    if(!c3e_stream_push(stream, op, argument, NULL, event)) {
+        free(event);
+        return NULL;
+    }
+
+    return event;
+}
+
+bool c3e_stream_wait_event(c3e_stream* stream, c3e_event* event) {
+    c3e_assert(stream != NULL && event != NULL);
+
+    atomic_fetch_add(&event->references, 1);
+    if(!c3e_stream_push(stream, NULL, NULL, event, NULL)) {
+        c3e_event_release(event);
+        return false;
+    }
+
+    return true;
+}
+
+c3e_event* c3e_stream_record(c3e_stream* stream) {
+    c3e_assert(stream != NULL);
+
+    c3e_event* event = c3e_event_init();
+    if(event == NULL)
+        return NULL;
+
+    if(!c3e_stream_push(stream, NULL, NULL, NULL, event)) {
+        free(event);
+        return NULL;
+    }
+
+    return event;
+}
+
+bool c3e_stream_synchronize(c3e_stream* stream) {
+    c3e_event* event = c3e_stream_record(stream);
+    if(event == NULL)
+        return false;
+
+    c3e_event_wait(event);
+    c3e_event_release(event);
+
+    return true;
+}
+
+c3e_event* c3e_stream_matrix_mul(c3e_stream* stream, c3e_matrix* matrix, c3e_matrix* subject) {
+    c3e_assert(matrix != NULL && subject != NULL);
+    c3e_assert(matrix->cols == subject->rows);
+
+    c3e_stream_operands* operands = (c3e_stream_operands*) malloc(sizeof(c3e_stream_operands));
+    if(operands == NULL)
+        return NULL;
+
+    operands->matrix = matrix;
+    operands->subject = subject;
+
+    c3e_event* event = c3e_stream_enqueue(stream, c3e_stream_mul, operands);
+    if(event == NULL)
+        free(operands);
+
+    return event;
+}
+
+bool c3e_event_query(c3e_event* event) {
+    c3e_assert(event != NULL);
+    return atomic_load_explicit(&event->done, memory_order_acquire) != 0;
+}
+
+void* c3e_event_wait(c3e_event* event) {
+    c3e_assert(event != NULL);
+
+    while(!atomic_load_explicit(&event->done, memory_order_acquire))
+        syscall(SYS_futex, (uint32_t*) &event->done, FUTEX_WAIT_PRIVATE, 0, NULL, NULL, 0);
+
+    return event->result;
+}
+
+void c3e_event_release(c3e_event* event) {
+    c3e_assert(event != NULL);
+
+    if(atomic_fetch_sub(&event->references, 1) == 1)
+        free(event);
+}
\ No newline at end of file
@@ -17,41 +17,66 @@
 
 #include <c3e/matrix.h>
 #include <c3e/matrix_tuple.h>
+#include <c3e/memory.h>
 #include <c3e/svd.h>
 #include <c3e/vector.h>
 
+static c3e_matrix* c3e_svd_rotate(c3e_matrix* basis, c3e_matrix* rotation) {
+    c3e_matrix* out = c3e_matrix_mul(basis, rotation);
+
+    c3e_matrix_free(basis);
+    c3e_memory_idle(out->data);
+
+    return out;
+}
+
 c3e_svd c3e_svd_init(c3e_matrix* matrix) {
     int x = matrix->rows, y = matrix->cols;
-    c3e_matrix_tuple left_sg, right_sg;
 
     c3e_matrix* left = c3e_matrix_identity(x);
     c3e_matrix* right = c3e_matrix_identity(y);
     c3e_matrix* singular = c3e_matrix_copy(matrix);
 
+    c3e_memory_idle(left->data);
+    c3e_memory_idle(right->data);
+
     for(int i = 0; i < 100; i++) {
-        left_sg = c3e_matrix_qr_decomp(singular);
-        singular = left_sg.b;
-        left = c3e_matrix_mul(left, left_sg.a);
+        c3e_matrix_tuple left_sg = c3e_matrix_qr_decomp(singular);
+        left = c3e_svd_rotate(left, left_sg.a);
+
+        c3e_matrix* flipped = c3e_matrix_transpose(left_sg.b);
+        c3e_matrix_tuple right_sg = c3e_matrix_qr_decomp(flipped);
+        right = c3e_svd_rotate(right, right_sg.a);
 
-        right_sg = c3e_matrix_qr_decomp(c3e_matrix_transpose(singular));
+        c3e_matrix_free(singular);
         singular = c3e_matrix_transpose(right_sg.b);
-        right = c3e_matrix_mul(right, right_sg.a);
 
-        if(c3e_vector_all_close(c3e_matrix_diagonal(singular, 0), c3e_vector_zeros(singular->rows)))
+        c3e_matrix_free(flipped);
+        c3e_matrix_tuple_free(left_sg);
+        c3e_matrix_tuple_free(right_sg);
+
+        c3e_vector* diagonal = c3e_matrix_diagonal(singular, 0);
+        c3e_vector* zeros = c3e_vector_zeros(singular->rows);
+        bool converged = c3e_vector_all_close(diagonal, zeros);
+
+        c3e_vector_free(diagonal);
+        c3e_vector_free(zeros);
+
+        if(converged)
             break;
     }
 
     c3e_vector* sigma = c3e_matrix_diagonal(singular, 0);
-
     c3e_matrix_free(singular);
-    c3e_matrix_tuple_free(left_sg);
-    c3e_matrix_tuple_free(right_sg);
+
+    c3e_memory_touch(left->data);
 
     c3e_svd svd;
     svd.singular = sigma;
     svd.left = left;
     svd.right = c3e_matrix_transpose(right);
 
+    c3e_matrix_free(right);
     return svd;
 }
 
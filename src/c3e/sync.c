@@ -0,0 +1,299 @@
+/*
+ * Copyright 2024 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <c3e/assert.h>
+#include <c3e/matrix.h>
+#include <c3e/sync.h>
+#include <c3e/vector.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t magic;
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t tile_rows;
+    uint32_t tile_cols;
+    uint32_t count;
+} c3e_sync_header;
+
+typedef struct {
+    uint32_t tile_row;
+    uint32_t tile_col;
+} c3e_sync_tile;
+
+static inline uint64_t c3e_sync_mix(uint64_t hash, uint64_t word) {
+    hash ^= word * 0x9E3779B97F4A7C15ull;
+    hash = (hash << 31) | (hash >> 33);
+
+    return hash * 0xC2B2AE3D27D4EB4Full;
+}
+
+static uint64_t c3e_sync_hash_tile(c3e_matrix_sync* sync, uint32_t tile_row, uint32_t tile_col) {
+    uint32_t row = tile_row * sync->tile_rows, col = tile_col * sync->tile_cols;
+    uint32_t rows = sync->matrix->rows - row < sync->tile_rows ?
+        sync->matrix->rows - row : sync->tile_rows;
+    size_t bytes = (size_t) (sync->matrix->cols - col < sync->tile_cols ?
+        sync->matrix->cols - col : sync->tile_cols) * sizeof(c3e_number);
+
+    uint64_t hash = 0x27D4EB2F165667C5ull;
+    for(uint32_t i = 0; i < rows; i++) {
+        const uint8_t* data = (const uint8_t*) &MATRIX_ELEM(sync->matrix, row + i, col);
+        size_t j = 0;
+
+        for(; j + sizeof(uint64_t) <= bytes; j += sizeof(uint64_t)) {
+            uint64_t word;
+
+            memcpy(&word, data + j, sizeof(word));
+            hash = c3e_sync_mix(hash, word);
+        }
+
+        for(; j < bytes; j++)
+            hash = c3e_sync_mix(hash, data[j]);
+    }
+
+    return hash;
+}
+
+static void c3e_sync_tile_extent(c3e_matrix* matrix, uint32_t tile_rows, uint32_t tile_cols, c3e_sync_tile tile, uint32_t* rows, uint32_t* cols) {
+    uint32_t row = tile.tile_row * tile_rows, col = tile.tile_col * tile_cols;
+
+    *rows = matrix->rows - row < tile_rows ? matrix->rows - row : tile_rows;
+    *cols = matrix->cols - col < tile_cols ? matrix->cols - col : tile_cols;
+}
+
+c3e_matrix_sync* c3e_matrix_sync_init(c3e_matrix* matrix, uint32_t tile_rows, uint32_t tile_cols, c3e_sync_mode mode) {
+    c3e_assert(matrix != NULL);
+    c3e_assert(tile_rows != 0 && tile_cols != 0);
+
+    c3e_matrix_sync* sync = (c3e_matrix_sync*) malloc(sizeof(c3e_matrix_sync));
+    if(sync == NULL)
+        return NULL;
+
+    sync->matrix = matrix;
+    sync->mode = mode;
+    sync->tile_rows = tile_rows;
+    sync->tile_cols = tile_cols;
+    sync->tiles_down = (matrix->rows + tile_rows - 1) / tile_rows;
+    sync->tiles_across = (matrix->cols + tile_cols - 1) / tile_cols;
+    sync->last_sent = 0;
+
+    size_t tiles = (size_t) sync->tiles_down * sync->tiles_across;
+    sync->hashes = (uint64_t*) calloc(tiles, sizeof(uint64_t));
+    sync->dirty = (bool*) malloc(tiles * sizeof(bool));
+
+    if((sync->hashes == NULL || sync->dirty == NULL) && tiles != 0) {
+        c3e_matrix_sync_free(sync);
+        return NULL;
+    }
+
+    for(size_t i = 0; i < tiles; i++)
+        sync->dirty[i] = true;
+    return sync;
+}
+
+void c3e_matrix_sync_free(c3e_matrix_sync* sync) {
+    c3e_assert(sync != NULL);
+
+    free(sync->hashes);
+    free(sync->dirty);
+    free(sync);
+}
+
+void c3e_matrix_sync_mark(c3e_matrix_sync* sync, uint32_t row, uint32_t col, uint32_t rows, uint32_t cols) {
+    c3e_assert(sync != NULL);
+    c3e_assert(row + rows <= sync->matrix->rows);
+    c3e_assert(col + cols <= sync->matrix->cols);
+
+    if(rows == 0 || cols == 0)
+        return;
+
+    for(uint32_t i = row / sync->tile_rows; i <= (row + rows - 1) / sync->tile_rows; i++)
+        for(uint32_t j = col / sync->tile_cols; j <= (col + cols - 1) / sync->tile_cols; j++)
+            sync->dirty[(size_t) i * sync->tiles_across + j] = true;
+}
+
+bool c3e_matrix_sync_send(c3e_socket* socket, c3e_matrix_sync* sync) {
+    return c3e_matrix_sync_broadcast(&socket, 1, sync);
+}
+
+bool c3e_matrix_sync_broadcast(c3e_socket** sockets, uint32_t count, c3e_matrix_sync* sync) {
+    c3e_assert(sockets != NULL);
+    c3e_assert(sync != NULL);
+
+    size_t tiles = (size_t) sync->tiles_down * sync->tiles_across;
+    c3e_sync_tile* changed = (c3e_sync_tile*) malloc(tiles * sizeof(c3e_sync_tile));
+
+    if(changed == NULL && tiles != 0)
+        return false;
+
+    uint32_t changed_count = 0;
+    size_t elements = 0;
+
+    for(uint32_t i = 0; i < sync->tiles_down; i++)
+        for(uint32_t j = 0; j < sync->tiles_across; j++) {
+            size_t index = (size_t) i * sync->tiles_across + j;
+            bool send = sync->dirty[index];
+
+            if(sync->mode == C3E_SYNC_HASH || send) {
+                uint64_t hash = c3e_sync_hash_tile(sync, i, j);
+
+                send = send || hash != sync->hashes[index];
+                sync->hashes[index] = hash;
+            }
+
+            if(send) {
+                uint32_t rows, cols;
+                c3e_sync_tile tile = {i, j};
+
+                c3e_sync_tile_extent(sync->matrix, sync->tile_rows, sync->tile_cols, tile, &rows, &cols);
+                changed[changed_count++] = tile;
+                elements += (size_t) rows * cols;
+            }
+        }
+
+    c3e_vector packed = {(uint32_t) elements, NULL};
+    c3e_assert(elements <= UINT32_MAX);
+
+    if(elements != 0) {
+        packed.data = (c3e_number*) malloc(elements * sizeof(c3e_number));
+
+        if(packed.data == NULL) {
+            free(changed);
+            return false;
+        }
+    }
+
+    c3e_number* cursor = packed.data;
+    for(uint32_t k = 0; k < changed_count; k++) {
+        uint32_t rows, cols;
+        c3e_sync_tile_extent(sync->matrix, sync->tile_rows, sync->tile_cols, changed[k], &rows, &cols);
+
+        for(uint32_t i = 0; i < rows; i++, cursor += cols)
+            memcpy(
+                cursor,
+                &MATRIX_ELEM(
+                    sync->matrix,
+                    changed[k].tile_row * sync->tile_rows + i,
+                    changed[k].tile_col * sync->tile_cols
+                ),
+                cols * sizeof(c3e_number)
+            );
+    }
+
+    c3e_sync_header header = {
+        C3E_SYNC_MAGIC,
+        sync->matrix->rows, sync->matrix->cols,
+        sync->tile_rows, sync->tile_cols,
+        changed_count
+    };
+
+    bool sent = true;
+    for(uint32_t i = 0; sent && i < count; i++)
+        sent = c3e_socket_send_data(sockets[i], &header, sizeof(header)) &&
+            (changed_count == 0 || (
+                c3e_socket_send_data(sockets[i], changed, changed_count * sizeof(c3e_sync_tile)) &&
+                c3e_socket_send_vector_typed(sockets[i], &packed, C3E_DTYPE_NATIVE)
+            ));
+
+    if(sent) {
+        memset(sync->dirty, 0, tiles * sizeof(bool));
+        sync->last_sent = changed_count;
+    }
+    else for(uint32_t k = 0; k < changed_count; k++)
+        sync->dirty[(size_t) changed[k].tile_row * sync->tiles_across + changed[k].tile_col] = true;
+
+    free(packed.data);
+    free(changed);
+
+    return sent;
+}
+
+int c3e_matrix_sync_receive(c3e_socket* socket, c3e_matrix* matrix) {
+    c3e_assert(socket != NULL);
+    c3e_assert(matrix != NULL);
+
+    c3e_sync_header header;
+    if(!c3e_socket_receive_data(socket, &header, sizeof(header)) ||
+        header.magic != C3E_SYNC_MAGIC ||
+        header.rows != matrix->rows || header.cols != matrix->cols ||
+        header.tile_rows == 0 || header.tile_cols == 0)
+        return -1;
+
+    if(header.count == 0)
+        return 0;
+
+    uint32_t tiles_down = (uint32_t) (((uint64_t) header.rows + header.tile_rows - 1) / header.tile_rows);
+    uint32_t tiles_across = (uint32_t) (((uint64_t) header.cols + header.tile_cols - 1) / header.tile_cols);
+
+    if(header.count > (uint64_t) tiles_down * tiles_across)
+        return -1;
+
+    c3e_sync_tile* changed = (c3e_sync_tile*) malloc((size_t) header.count * sizeof(c3e_sync_tile));
+    if(changed == NULL)
+        return -1;
+
+    if(!c3e_socket_receive_data(socket, changed, (size_t) header.count * sizeof(c3e_sync_tile))) {
+        free(changed);
+        return -1;
+    }
+
+    size_t elements = 0;
+    for(uint32_t k = 0; k < header.count; k++) {
+        uint32_t rows, cols;
+
+        if(changed[k].tile_row >= tiles_down || changed[k].tile_col >= tiles_across) {
+            free(changed);
+            return -1;
+        }
+
+        c3e_sync_tile_extent(matrix, header.tile_rows, header.tile_cols, changed[k], &rows, &cols);
+        elements += (size_t) rows * cols;
+    }
+
+    c3e_vector* packed = c3e_socket_typed_vector_read(socket);
+    if(packed == NULL || packed->size != elements) {
+        if(packed != NULL)
+            c3e_vector_free(packed);
+
+        free(changed);
+        return -1;
+    }
+
+    c3e_number* cursor = packed->data;
+    for(uint32_t k = 0; k < header.count; k++) {
+        uint32_t rows, cols;
+        c3e_sync_tile_extent(matrix, header.tile_rows, header.tile_cols, changed[k], &rows, &cols);
+
+        for(uint32_t i = 0; i < rows; i++, cursor += cols)
+            memcpy(
+                &MATRIX_ELEM(
+                    matrix,
+                    changed[k].tile_row * header.tile_rows + i,
+                    changed[k].tile_col * header.tile_cols
+                ),
+                cursor,
+                cols * sizeof(c3e_number)
+            );
+    }
+
+    c3e_vector_free(packed);
+    free(changed);
+
+    return (int) header.count;
+}
\ No newline at end of file
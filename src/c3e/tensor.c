@@ -17,6 +17,7 @@
 
 #include <c3e/assert.h>
 #include <c3e/matrix.h>
+#include <c3e/random.h>
 #include <c3e/tensor.h>
 #include <c3e/vector.h>
 
@@ -336,23 +337,25 @@ c3e_tensor* c3e_tensor_fill(size_t dsize, uint32_t dims, int rows, int cols, c3e
 }
 
 c3e_tensor* c3e_tensor_random(size_t dsize, uint32_t dims, int rows, int cols, int seed) {
-    c3e_assert(dsize != rows * cols);
-
-    c3e_matrix* matrices[dims];
-    for(uint32_t i = 0; i < dims; i++)
-        matrices[i] = c3e_matrix_random(rows, cols, seed);
-
-    return c3e_tensor_init(dsize, dims, matrices, c3e_vector_random(dsize, seed));
+    return c3e_tensor_random_bound(dsize, dims, rows, cols, seed, 0.0, 1.0);
 }
 
 c3e_tensor* c3e_tensor_random_bound(size_t dsize, uint32_t dims, int rows, int cols, int seed, c3e_number min, c3e_number max) {
     c3e_assert(dsize != rows * cols);
 
+    c3e_rng rng;
+    c3e_rng_init(&rng, (uint64_t) (uint32_t) seed, 0);
+
     c3e_matrix* matrices[dims];
-    for(uint32_t i = 0; i < dims; i++)
-        matrices[i] = c3e_matrix_random_bound(rows, cols, seed, min, max);
+    for(uint32_t i = 0; i < dims; i++) {
+        matrices[i] = c3e_matrix_init(rows, cols);
+        c3e_rng_fill_parallel(&rng, matrices[i]->data, (size_t) rows * cols, min, max, 0);
+    }
+
+    c3e_vector* data = c3e_vector_init(dsize);
+    c3e_rng_fill_parallel(&rng, data->data, dsize, min, max, 0);
 
-    return c3e_tensor_init(dsize, dims, matrices, c3e_vector_random_bound(dsize, seed, min, max));
+    return c3e_tensor_init(dsize, dims, matrices, data);
 }
 
 bool c3e_tensor_equals(c3e_tensor* tensor, c3e_tensor* subject) {
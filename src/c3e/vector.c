@@ -17,6 +17,7 @@
 
 #include <c3e/assert.h>
 #include <c3e/matrix.h>
+#include <c3e/memory.h>
 #include <c3e/random.h>
 #include <c3e/trigo.h>
 #include <c3e/vector.h>
@@ -27,7 +28,7 @@
 c3e_vector* c3e_vector_init(size_t size) {
     c3e_vector* vector = (c3e_vector*) malloc(sizeof(c3e_vector));
     vector->size = size;
-    vector->data = (c3e_number*) calloc(size, sizeof(c3e_number));
+    vector->data = (c3e_number*) c3e_memory_alloc(size * sizeof(c3e_number));
 
     return vector;
 }
@@ -40,7 +41,7 @@ c3e_vector* c3e_vector_create(size_t size, c3e_number* data) {
 }
 
 void c3e_vector_free(c3e_vector* vector) {
-    free(vector->data);
+    c3e_memory_free(vector->data);
     free(vector);
 }
 
@@ -233,17 +234,15 @@ c3e_vector* c3e_vector_fill(size_t size, c3e_number values) {
 }
 
 c3e_vector* c3e_vector_random(size_t size, int seed) {
-    c3e_vector* out = c3e_vector_init(size);
-    for(int i = 0; i < size; i++)
-        out->data[i] = c3e_random() / (c3e_number) RAND_MAX;
-
-    return out;
+    return c3e_vector_random_bound(size, seed, 0.0, 1.0);
 }
 
 c3e_vector* c3e_vector_random_bound(size_t size, int seed, c3e_number min, c3e_number max) {
     c3e_vector* out = c3e_vector_init(size);
-    for(int i = 0; i < size; i++)
-        out->data[i] = c3e_random_bound(min, max) / (c3e_number) RAND_MAX;
+
+    c3e_rng rng;
+    c3e_rng_init(&rng, (uint64_t) (uint32_t) seed, 0);
+    c3e_rng_fill_parallel(&rng, out->data, size, min, max, 0);
 
     return out;
 }
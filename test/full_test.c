@@ -16,9 +16,16 @@
  */
 
 #include <c3e.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
 #include <time.h>
+#include <unistd.h>
 
 void print_vector(const char* name, c3e_vector* vector) {
     printf("%s: [\r\n", name);
@@ -485,6 +492,1867 @@ void test_tensor() {
     c3e_tensor_free(tensor2);
 }
 
+static void* send_coded(void* argument) {
+    c3e_socket* sender = (c3e_socket*) argument;
+    c3e_matrix* matrix = c3e_matrix_init(3, (int) C3E_CODEC_BLOCK);
+
+    for(int i = 0; i < matrix->rows * matrix->cols; i++)
+        matrix->data[i] = sin(i * 1e-3) + 1e-4 * cos(i * 7.31);
+
+    if(c3e_socket_negotiate_codec(sender, C3E_CODEC_XOR_LZ))
+        c3e_socket_send_matrix(sender, matrix);
+
+    c3e_matrix_free(matrix);
+    return NULL;
+}
+
+void test_codec() {
+    size_t count = 2 * C3E_CODEC_BLOCK + 5;
+    c3e_vector* signal = c3e_vector_init(count);
+
+    for(size_t i = 0; i < count; i++)
+        signal->data[i] = sin(i * 1e-3) + 1e-4 * cos(i * 7.31);
+
+    size_t capacity = c3e_codec_bound(C3E_CODEC_XOR_LZ, count);
+    void* encoded = malloc(capacity);
+    size_t size = c3e_codec_encode(C3E_CODEC_XOR_LZ, signal->data, count, encoded, capacity);
+
+    c3e_vector* decoded = c3e_vector_init(count);
+    bool lossless = size != 0 &&
+        c3e_codec_decode(encoded, size, decoded->data, count) &&
+        c3e_vector_equals(signal, decoded);
+
+    printf("Codec round trip is lossless: %s\r\n", lossless ? "yes" : "no");
+
+    int fds[2];
+    bool streamed = false;
+
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0) {
+        c3e_socket sender = {NULL, 0, fds[1]}, receiver = {NULL, 0, fds[0]};
+        pthread_t thread;
+
+        pthread_create(&thread, NULL, send_coded, &sender);
+        if(c3e_socket_negotiate_codec(&receiver, C3E_CODEC_XOR_LZ)) {
+            c3e_matrix* matrix = c3e_socket_matrix_read(&receiver);
+
+            streamed = matrix->rows == 3;
+            for(int i = 0; streamed && i < matrix->rows * matrix->cols; i++)
+                streamed = matrix->data[i] == sin(i * 1e-3) + 1e-4 * cos(i * 7.31);
+            c3e_matrix_free(matrix);
+        }
+
+        pthread_join(thread, NULL);
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    printf("Codec blocks streamed losslessly: %s\r\n", streamed ? "yes" : "no");
+
+    free(encoded);
+    c3e_vector_free(decoded);
+    c3e_vector_free(signal);
+}
+
+void test_net() {
+    int fds[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("Error: Failed to create socket pair.\r\n");
+        return;
+    }
+
+    int rows = 1000, cols = 8;
+    c3e_matrix* matrix = c3e_matrix_init(rows, cols);
+    for(int i = 0; i < rows * cols; i++)
+        matrix->data[i] = (c3e_number) (i % 97) / 7.0;
+
+    pid_t pid = fork();
+    if(pid == 0) {
+        c3e_socket sender = {NULL, 0, fds[1]};
+        close(fds[0]);
+
+        bool sent = c3e_socket_negotiate_codec(&sender, C3E_CODEC_XOR_LZ) &&
+            c3e_socket_send_matrix_stream(&sender, matrix, 64);
+        close(fds[1]);
+        _exit(sent ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    c3e_socket receiver = {NULL, 0, fds[0]};
+    close(fds[1]);
+
+    c3e_vector* x = c3e_vector_ones(cols);
+    c3e_vector* y = c3e_vector_zeros(rows);
+
+    c3e_matrix_stream stream;
+    c3e_matrix* block;
+    uint64_t offset;
+    int blocks = 0;
+
+    if(c3e_socket_negotiate_codec(&receiver, C3E_CODEC_XOR_LZ) &&
+        c3e_matrix_stream_accept(&stream, &receiver, 4)) {
+        while((block = c3e_matrix_stream_next(&stream, &offset)) != NULL) {
+            for(uint32_t i = 0; i < block->rows; i++)
+                for(uint32_t j = 0; j < block->cols; j++)
+                    y->data[offset + i] += MATRIX_ELEM(block, i, j) * x->data[j];
+            blocks++;
+        }
+
+        c3e_matrix_stream_close(&stream);
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+    close(fds[0]);
+
+    bool matches = true;
+    for(int i = 0; i < rows; i++) {
+        c3e_number expected = 0.0;
+
+        for(int j = 0; j < cols; j++)
+            expected += MATRIX_ELEM(matrix, i, j);
+        matches = matches && expected == y->data[i];
+    }
+
+    printf("Streamed blocks received: %d\r\n", blocks);
+    printf("Streamed GEMV matches: %s\r\n", matches && WEXITSTATUS(status) == 0 ? "yes" : "no");
+
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("Error: Failed to create socket pair.\r\n");
+        return;
+    }
+
+    c3e_stream_header forged = {C3E_STREAM_MAGIC, C3E_STREAM_VERSION, C3E_DTYPE_NATIVE, C3E_CODEC_NONE,
+        1, ((uint64_t) 1 << 32) + 1, 1, 0};
+    c3e_socket forger = {NULL, 0, fds[1]};
+    receiver.sockfd = fds[0];
+
+    bool rejected = c3e_socket_send_data(&forger, &forged, sizeof(forged)) &&
+        c3e_socket_matrix_stream_read(&receiver, 4) == NULL;
+    close(fds[0]);
+    close(fds[1]);
+
+    printf("Oversized stream header rejected: %s\r\n", rejected ? "yes" : "no");
+
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("Error: Failed to create socket pair.\r\n");
+        return;
+    }
+
+    pid = fork();
+    if(pid == 0) {
+        c3e_socket sender = {NULL, 0, fds[1]};
+        close(fds[0]);
+
+        bool sent = c3e_socket_send_matrix_typed(&sender, matrix, C3E_DTYPE_BFLOAT16);
+        close(fds[1]);
+        _exit(sent ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fds[1]);
+    receiver.sockfd = fds[0];
+    receiver.codec = C3E_CODEC_NONE;
+
+    c3e_matrix* reduced = c3e_socket_typed_matrix_read(&receiver);
+    waitpid(pid, &status, 0);
+    close(fds[0]);
+
+    c3e_number error = 0.0;
+    if(reduced != NULL) {
+        for(int i = 0; i < rows * cols; i++)
+            if(fabs(reduced->data[i] - matrix->data[i]) > error)
+                error = fabs(reduced->data[i] - matrix->data[i]);
+        c3e_matrix_free(reduced);
+    }
+
+    printf("bfloat16 matrix received: %s\r\n", reduced != NULL ? "yes" : "no");
+    printf("bfloat16 max abs error: %f\r\n", error);
+
+    c3e_vector_free(x);
+    c3e_vector_free(y);
+    c3e_matrix_free(matrix);
+}
+
+void test_sync() {
+    int fds[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("Error: Failed to create socket pair.\r\n");
+        return;
+    }
+
+    c3e_matrix* params = c3e_matrix_full(64, 64, 0.5);
+    pid_t pid = fork();
+
+    if(pid == 0) {
+        c3e_socket sender = {NULL, 0, fds[1]};
+        close(fds[0]);
+
+        c3e_matrix_sync* sync = c3e_matrix_sync_init(params, 16, 16, C3E_SYNC_HASH);
+        bool sent = c3e_matrix_sync_send(&sender, sync);
+
+        MATRIX_ELEM(params, 40, 3) = 2.0;
+        MATRIX_ELEM(params, 41, 5) = 3.0;
+        sent = sent && c3e_matrix_sync_send(&sender, sync);
+
+        c3e_matrix_sync_free(sync);
+        close(fds[1]);
+        _exit(sent ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    c3e_socket receiver = {NULL, 0, fds[0]};
+    close(fds[1]);
+
+    c3e_matrix* replica = c3e_matrix_zeros(64, 64);
+    int full = c3e_matrix_sync_receive(&receiver, replica);
+    int delta = c3e_matrix_sync_receive(&receiver, replica);
+
+    int status;
+    waitpid(pid, &status, 0);
+    close(fds[0]);
+
+    MATRIX_ELEM(params, 40, 3) = 2.0;
+    MATRIX_ELEM(params, 41, 5) = 3.0;
+
+    printf("Tiles in initial sync: %d\r\n", full);
+    printf("Tiles in delta sync: %d\r\n", delta);
+    printf("Replica matches: %s\r\n", c3e_matrix_all_close(params, replica) ? "yes" : "no");
+
+    int wire[2], cut[2];
+    bool rejected = false;
+
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, wire) == 0 &&
+        socketpair(AF_UNIX, SOCK_STREAM, 0, cut) == 0) {
+        c3e_socket sender = {NULL, 0, wire[1]}, truncated = {NULL, 0, cut[0]};
+        c3e_matrix_sync* sync = c3e_matrix_sync_init(params, 16, 16, C3E_SYNC_HASH);
+
+        char bytes[65536];
+        ssize_t length = 0;
+
+        if(c3e_matrix_sync_send(&sender, sync)) {
+            shutdown(wire[1], SHUT_WR);
+            length = recv(wire[0], bytes, sizeof(bytes), MSG_WAITALL);
+        }
+
+        if(length > 64 && send(cut[1], bytes, (size_t) length - 64, 0) == length - 64) {
+            shutdown(cut[1], SHUT_WR);
+
+            c3e_matrix_fill(replica, 7.0);
+            rejected = c3e_matrix_sync_receive(&truncated, replica) == -1 &&
+                c3e_matrix_sum(replica) == 7.0 * 64 * 64;
+        }
+
+        c3e_matrix_sync_free(sync);
+        close(wire[0]);
+        close(wire[1]);
+        close(cut[0]);
+        close(cut[1]);
+    }
+
+    printf("Truncated delta rejected: %s\r\n", rejected ? "yes" : "no");
+
+    c3e_matrix_free(replica);
+    c3e_matrix_free(params);
+}
+
+void test_sendfile() {
+    char path[] = "/tmp/c3e_sendfile_XXXXXX";
+    int fd = mkstemp(path);
+    int fds[2];
+
+    if(fd < 0 || socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("Error: Failed to create test file or socket pair.\r\n");
+        return;
+    }
+
+    c3e_matrix* stored = c3e_matrix_init(256, 256);
+    for(uint32_t i = 0; i < stored->rows * stored->cols; i++)
+        stored->data[i] = (c3e_number) i * 0.25;
+
+    uint64_t prefix = 0xC3E;
+    bool written = write(fd, &prefix, sizeof(prefix)) == sizeof(prefix) &&
+        write(fd, stored->data, stored->rows * stored->cols * sizeof(c3e_number)) ==
+            (ssize_t) (stored->rows * stored->cols * sizeof(c3e_number));
+
+    pid_t pid = fork();
+    if(pid == 0) {
+        c3e_socket sender = {NULL, 0, fds[1]};
+        close(fds[0]);
+
+        bool sent = written &&
+            c3e_socket_send_file_matrix(&sender, fd, sizeof(prefix), stored->rows, stored->cols, C3E_DTYPE_NATIVE);
+        _exit(sent ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    c3e_socket receiver = {NULL, 0, fds[0]};
+    close(fds[1]);
+
+    c3e_matrix* received = c3e_socket_typed_matrix_read(&receiver);
+    int status;
+
+    waitpid(pid, &status, 0);
+    close(fds[0]);
+    close(fd);
+    unlink(path);
+
+    printf("Matrix served from file: %s\r\n", WIFEXITED(status) && WEXITSTATUS(status) == 0 ? "yes" : "no");
+    printf("Served matrix matches: %s\r\n",
+        received != NULL && c3e_matrix_all_close(stored, received) ? "yes" : "no");
+
+    if(received != NULL)
+        c3e_matrix_free(received);
+    c3e_matrix_free(stored);
+}
+
+void test_archive() {
+    char path[] = "/tmp/c3e_archive_XXXXXX";
+    int fd = mkstemp(path);
+
+    if(fd < 0) {
+        printf("Error: Failed to create test file.\r\n");
+        return;
+    }
+    close(fd);
+
+    c3e_matrix* weights = c3e_matrix_init(100, 30);
+    for(uint32_t i = 0; i < weights->rows * weights->cols; i++)
+        weights->data[i] = sin((c3e_number) i);
+
+    c3e_matrix* smooth = c3e_matrix_full(64, 64, 1.5);
+    c3e_vector* bias = c3e_vector_fill(10, 0.25);
+
+    c3e_matrix* slices[] = {c3e_matrix_full(2, 3, 1.0), c3e_matrix_full(4, 1, 2.0)};
+    c3e_tensor* tensor = c3e_tensor_init(3, 2, slices, c3e_vector_fill(3, 7.0));
+
+    c3e_archive_writer* writer = c3e_archive_create(path);
+    bool written = writer != NULL &&
+        c3e_archive_put_matrix(writer, "weights", weights, C3E_DTYPE_NATIVE, C3E_CODEC_NONE) &&
+        c3e_archive_put_matrix(writer, "smooth", smooth, C3E_DTYPE_NATIVE, C3E_CODEC_XOR_LZ) &&
+        c3e_archive_put_vector(writer, "bias", bias, C3E_DTYPE_BFLOAT16, C3E_CODEC_NONE) &&
+        c3e_archive_put_tensor(writer, "tensor", tensor, C3E_DTYPE_FLOAT32, C3E_CODEC_NONE);
+    written = writer != NULL && c3e_archive_finish(writer) && written;
+
+    c3e_archive* archive = c3e_archive_open(path);
+    c3e_matrix* loaded = archive == NULL ? NULL : c3e_archive_matrix(archive, "weights");
+    c3e_matrix* decoded = archive == NULL ? NULL : c3e_archive_matrix(archive, "smooth");
+    c3e_vector* narrow = archive == NULL ? NULL : c3e_archive_vector(archive, "bias");
+    c3e_tensor* restored = archive == NULL ? NULL : c3e_archive_tensor(archive, "tensor");
+
+    bool mapped = loaded != NULL &&
+        (uint8_t*) loaded->data >= archive->map &&
+        (uint8_t*) loaded->data < archive->map + archive->size &&
+        (uintptr_t) loaded->data % C3E_ARCHIVE_ALIGNMENT == 0;
+
+    printf("Archive written: %s\r\n", written ? "yes" : "no");
+    printf("Matrix mapped in place: %s\r\n", mapped ? "yes" : "no");
+    printf("Mapped matrix matches: %s\r\n",
+        loaded != NULL && c3e_matrix_all_close(weights, loaded) ? "yes" : "no");
+    printf("Compressed matrix matches: %s\r\n",
+        decoded != NULL && c3e_matrix_all_close(smooth, decoded) ? "yes" : "no");
+    printf("Narrowed vector matches: %s\r\n",
+        narrow != NULL && narrow->size == 10 && narrow->data[9] == 0.25 ? "yes" : "no");
+    printf("Tensor restored: %s\r\n",
+        restored != NULL && restored->dimensions == 2 &&
+        c3e_matrix_all_close(slices[1], restored->matrices[1]) &&
+        restored->data->data[2] == 7.0 ? "yes" : "no");
+
+    int fds[2];
+    if(archive != NULL && socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0) {
+        pid_t pid = fork();
+
+        if(pid == 0) {
+            c3e_socket sender = {NULL, 0, fds[1]};
+            close(fds[0]);
+
+            _exit(c3e_socket_send_archive_entry(&sender, archive, "weights") ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        c3e_socket receiver = {NULL, 0, fds[0]};
+        close(fds[1]);
+
+        c3e_matrix* served = c3e_socket_typed_matrix_read(&receiver);
+        waitpid(pid, NULL, 0);
+        close(fds[0]);
+
+        printf("Archive entry served: %s\r\n",
+            served != NULL && c3e_matrix_all_close(weights, served) ? "yes" : "no");
+        if(served != NULL)
+            c3e_matrix_free(served);
+    }
+
+    if(archive != NULL)
+        c3e_archive_close(archive);
+    unlink(path);
+
+    c3e_tensor_free(tensor);
+    c3e_vector_free(bias);
+    c3e_matrix_free(smooth);
+    c3e_matrix_free(weights);
+}
+
+void test_npy() {
+    char matrix_path[] = "/tmp/c3e_npy_XXXXXX";
+    char foreign_path[] = "/tmp/c3e_npy_XXXXXX";
+    char archive_path[] = "/tmp/c3e_npz_XXXXXX";
+
+    int fds[] = {mkstemp(matrix_path), mkstemp(foreign_path), mkstemp(archive_path)};
+    for(int i = 0; i < 3; i++)
+        if(fds[i] >= 0)
+            close(fds[i]);
+
+    c3e_matrix* matrix = c3e_matrix_init(3, 4);
+    for(uint32_t i = 0; i < 12; i++)
+        matrix->data[i] = (c3e_number) i / 4.0;
+
+    c3e_vector* vector = c3e_vector_fill(5, 0.5);
+    bool saved = c3e_npy_save_matrix(matrix_path, matrix, C3E_DTYPE_NATIVE);
+
+    c3e_npy_file* file = c3e_npy_open(matrix_path);
+    c3e_matrix* loaded = file == NULL ? NULL : c3e_npy_matrix(file, NULL);
+
+    printf("NPY saved: %s\r\n", saved ? "yes" : "no");
+    printf("NPY mapped in place: %s\r\n",
+        loaded != NULL && (uint8_t*) loaded->data >= file->map &&
+        (uint8_t*) loaded->data < file->map + file->size ? "yes" : "no");
+    printf("NPY matrix matches: %s\r\n",
+        loaded != NULL && c3e_matrix_all_close(matrix, loaded) ? "yes" : "no");
+
+    if(file != NULL)
+        c3e_npy_close(file);
+
+    const char* dict = "{'descr': '>f8', 'fortran_order': True, 'shape': (3, 4), }";
+    uint8_t header[128] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0, 118, 0};
+
+    memset(header + 10, ' ', 117);
+    memcpy(header + 10, dict, strlen(dict));
+    header[127] = '\n';
+
+    FILE* foreign = fopen(foreign_path, "wb");
+    if(foreign != NULL) {
+        fwrite(header, 1, sizeof(header), foreign);
+
+        for(uint32_t col = 0; col < 4; col++)
+            for(uint32_t row = 0; row < 3; row++) {
+                double value = (double) matrix->data[row * 4 + col];
+                uint8_t bytes[8], swapped[8];
+
+                memcpy(bytes, &value, 8);
+                for(int i = 0; i < 8; i++)
+                    swapped[i] = bytes[7 - i];
+                fwrite(swapped, 1, 8, foreign);
+            }
+
+        fclose(foreign);
+    }
+
+    file = c3e_npy_open(foreign_path);
+    loaded = file == NULL ? NULL : c3e_npy_matrix(file, NULL);
+
+    printf("Big-endian Fortran order converted: %s\r\n",
+        loaded != NULL && c3e_matrix_all_close(matrix, loaded) ? "yes" : "no");
+
+    if(file != NULL)
+        c3e_npy_close(file);
+
+    c3e_npz_writer* writer = c3e_npz_create(archive_path);
+    bool written = writer != NULL &&
+        c3e_npz_put_matrix(writer, "weights", matrix, C3E_DTYPE_NATIVE) &&
+        c3e_npz_put_vector(writer, "bias", vector, C3E_DTYPE_FLOAT32);
+    written = writer != NULL && c3e_npz_finish(writer) && written;
+
+    file = c3e_npy_open(archive_path);
+    loaded = file == NULL ? NULL : c3e_npy_matrix(file, "weights");
+    c3e_vector* bias = file == NULL ? NULL : c3e_npy_vector(file, "bias");
+
+    printf("NPZ written: %s\r\n", written ? "yes" : "no");
+    printf("NPZ member mapped in place: %s\r\n",
+        loaded != NULL && (uint8_t*) loaded->data >= file->map &&
+        (uint8_t*) loaded->data < file->map + file->size &&
+        (uintptr_t) loaded->data % 64 == 0 ? "yes" : "no");
+    printf("NPZ members match: %s\r\n",
+        loaded != NULL && bias != NULL && c3e_matrix_all_close(matrix, loaded) &&
+        bias->size == 5 && bias->data[4] == 0.5 ? "yes" : "no");
+
+    if(file != NULL)
+        c3e_npy_close(file);
+
+    unlink(matrix_path);
+    unlink(foreign_path);
+    unlink(archive_path);
+
+    c3e_vector_free(vector);
+    c3e_matrix_free(matrix);
+}
+
+void test_csv() {
+    char path[] = "/tmp/c3e_csv_XXXXXX";
+    int fd = mkstemp(path);
+
+    if(fd < 0) {
+        printf("Error: Failed to create test file.\r\n");
+        return;
+    }
+    close(fd);
+
+    c3e_matrix* matrix = c3e_matrix_init(2000, 7);
+    for(uint32_t i = 0; i < matrix->rows * matrix->cols; i++)
+        matrix->data[i] = (i % 5 == 0) ? (c3e_number) (i % 1000) : sin((c3e_number) i) * 1e3;
+
+    bool written = c3e_csv_write(path, matrix, ',', 4);
+    c3e_matrix* loaded = c3e_csv_read(path, ',', false, 3);
+
+    printf("CSV written: %s\r\n", written ? "yes" : "no");
+    printf("CSV round trip exact: %s\r\n",
+        loaded != NULL && loaded->rows == matrix->rows && loaded->cols == matrix->cols &&
+        memcmp(loaded->data, matrix->data, matrix->rows * matrix->cols * sizeof(c3e_number)) == 0 ?
+        "yes" : "no");
+
+    if(loaded != NULL)
+        c3e_matrix_free(loaded);
+
+    FILE* file = fopen(path, "wb");
+    if(file != NULL) {
+        fputs("x\ty\tz\r\n1.5\t\"-2e3\"\t 0.125\r\n\r\n3\t\t1e-5\r\n", file);
+        fclose(file);
+    }
+
+    loaded = c3e_csv_read(path, '\t', true, 2);
+    printf("TSV with header parsed: %s\r\n",
+        loaded != NULL && loaded->rows == 2 && loaded->cols == 3 &&
+        loaded->data[0] == 1.5 && loaded->data[1] == -2000.0 && loaded->data[2] == 0.125 &&
+        loaded->data[3] == 3.0 && isnan(loaded->data[4]) && loaded->data[5] == (c3e_number) 1e-5 ?
+        "yes" : "no");
+
+    if(loaded != NULL)
+        c3e_matrix_free(loaded);
+
+    file = fopen(path, "wb");
+    if(file != NULL) {
+        fputs("1,2,3\n4,5\n", file);
+        fclose(file);
+    }
+
+    loaded = c3e_csv_read(path, ',', false, 1);
+    printf("Ragged rows rejected: %s\r\n", loaded == NULL ? "yes" : "no");
+
+    if(loaded != NULL)
+        c3e_matrix_free(loaded);
+
+    unlink(path);
+    c3e_matrix_free(matrix);
+}
+
+void test_disk_matrix() {
+    char paths[4][32];
+    c3e_disk_matrix* disks[4] = {NULL, NULL, NULL, NULL};
+
+    c3e_matrix* left = c3e_matrix_init(90, 40);
+    c3e_matrix* right = c3e_matrix_init(40, 30);
+    c3e_matrix* other = c3e_matrix_init(90, 40);
+
+    for(uint32_t i = 0; i < 90 * 40; i++) {
+        left->data[i] = sin((c3e_number) i);
+        other->data[i] = cos((c3e_number) i);
+    }
+
+    for(uint32_t i = 0; i < 40 * 30; i++)
+        right->data[i] = (c3e_number) (i % 7) - 3.0;
+
+    uint32_t shapes[4][2] = {{90, 40}, {40, 30}, {90, 40}, {90, 30}};
+    for(int i = 0; i < 4; i++) {
+        strcpy(paths[i], "/tmp/c3e_disk_XXXXXX");
+
+        int fd = mkstemp(paths[i]);
+        if(fd >= 0) {
+            close(fd);
+            disks[i] = c3e_disk_matrix_create(paths[i], shapes[i][0], shapes[i][1], 4096);
+        }
+    }
+
+    bool ready = disks[0] != NULL && disks[1] != NULL && disks[2] != NULL && disks[3] != NULL &&
+        c3e_disk_matrix_write_rows(disks[0], 0, left) &&
+        c3e_disk_matrix_write_rows(disks[1], 0, right) &&
+        c3e_disk_matrix_write_rows(disks[2], 0, other);
+
+    printf("Disk matrices created: %s\r\n", ready ? "yes" : "no");
+
+    if(ready) {
+        c3e_matrix* expected = c3e_matrix_add(left, other);
+        c3e_matrix* actual = c3e_disk_matrix_add(disks[2], disks[0], disks[2]) ?
+            c3e_disk_matrix_read_rows(disks[2], 0, 90) : NULL;
+
+        printf("Chunked addition matches: %s\r\n",
+            actual != NULL && c3e_matrix_all_close(expected, actual) ? "yes" : "no");
+        printf("Chunked reductions match: %s\r\n",
+            fabs(c3e_disk_matrix_sum(disks[0]) - c3e_matrix_sum(left)) < 1e-9 &&
+            c3e_disk_matrix_max(disks[0]) == c3e_matrix_max(left) &&
+            c3e_disk_matrix_min(disks[0]) == c3e_matrix_min(left) ? "yes" : "no");
+
+        c3e_matrix_free(expected);
+        if(actual != NULL)
+            c3e_matrix_free(actual);
+
+        c3e_vector* vector = c3e_vector_fill(40, 0.5);
+        c3e_vector* product = c3e_disk_matrix_gemv(disks[0], vector);
+        bool gemv = product != NULL && product->size == 90;
+
+        for(uint32_t i = 0; gemv && i < 90; i++) {
+            c3e_number sum = 0.0;
+
+            for(uint32_t j = 0; j < 40; j++)
+                sum += left->data[i * 40 + j] * 0.5;
+            gemv = fabs(product->data[i] - sum) < 1e-9;
+        }
+        printf("Chunked GEMV matches: %s\r\n", gemv ? "yes" : "no");
+
+        c3e_vector_free(vector);
+        if(product != NULL)
+            c3e_vector_free(product);
+
+        expected = c3e_matrix_mul(left, right);
+        actual = c3e_disk_matrix_mul(disks[3], disks[0], disks[1]) ?
+            c3e_disk_matrix_read_rows(disks[3], 0, 90) : NULL;
+
+        printf("Blocked GEMM matches: %s\r\n",
+            actual != NULL && c3e_matrix_all_close(expected, actual) ? "yes" : "no");
+
+        c3e_matrix_free(expected);
+        if(actual != NULL)
+            c3e_matrix_free(actual);
+    }
+
+    for(int i = 0; i < 4; i++) {
+        if(disks[i] != NULL)
+            c3e_disk_matrix_close(disks[i]);
+        unlink(paths[i]);
+    }
+
+    c3e_matrix_free(left);
+    c3e_matrix_free(right);
+    c3e_matrix_free(other);
+}
+
+typedef struct {
+    c3e_matrix* matrix;
+    int seed;
+    bool intact;
+} memory_worker;
+
+static void* fill_busy(void* argument) {
+    memory_worker* worker = (memory_worker*) argument;
+    c3e_matrix* matrix = worker->matrix;
+
+    for(int pass = 0; pass < 4; pass++)
+        for(int i = 0; i < matrix->rows * matrix->cols; i++)
+            matrix->data[i] = (c3e_number) (i + pass);
+
+    return NULL;
+}
+
+static void* spill_idle(void* argument) {
+    memory_worker* worker = (memory_worker*) argument;
+    c3e_matrix* matrices[6];
+
+    for(int i = 0; i < 6; i++) {
+        matrices[i] = c3e_matrix_full(128, 128, (c3e_number) (worker->seed * 10 + i));
+        c3e_memory_idle(matrices[i]->data);
+    }
+
+    worker->intact = true;
+    for(int i = 0; i < 6; i++) {
+        c3e_memory_touch(matrices[i]->data);
+        MATRIX_ELEM(matrices[i], 0, 0) += 1.0;
+
+        worker->intact &= c3e_matrix_sum(matrices[i]) ==
+            (c3e_number) (worker->seed * 10 + i) * 128 * 128 + 1.0;
+        c3e_matrix_free(matrices[i]);
+    }
+
+    return NULL;
+}
+
+void test_memory() {
+    size_t resident = c3e_memory_resident();
+    c3e_memory_set_budget(resident + ((size_t) 3 << 20));
+
+    c3e_matrix* matrices[8];
+    for(int i = 0; i < 8; i++) {
+        matrices[i] = c3e_matrix_init(256, 256);
+        c3e_matrix_fill(matrices[i], (c3e_number) i);
+        c3e_memory_idle(matrices[i]->data);
+    }
+
+    printf("Buffers spilled: %s\r\n", c3e_memory_spilled() > 0 ? "yes" : "no");
+    printf("Within budget: %s\r\n",
+        c3e_memory_resident() <= resident + ((size_t) 3 << 20) ? "yes" : "no");
+
+    bool intact = true;
+    for(int i = 0; intact && i < 8; i++)
+        intact = c3e_matrix_sum(matrices[i]) == (c3e_number) i * 256 * 256;
+    printf("Spilled data intact: %s\r\n", intact ? "yes" : "no");
+
+    c3e_memory_touch(matrices[0]->data);
+    MATRIX_ELEM(matrices[0], 3, 4) = 42.0;
+    printf("Spilled data writable: %s\r\n", MATRIX_ELEM(matrices[0], 3, 4) == 42.0 ? "yes" : "no");
+
+    memory_worker busy = {c3e_matrix_init(1024, 1024), 0, true};
+    pthread_t filler;
+    pthread_create(&filler, NULL, fill_busy, &busy);
+
+    for(int i = 1; i < 8; i++) {
+        c3e_matrix* pressure = c3e_matrix_init(256, 256);
+
+        c3e_memory_idle(pressure->data);
+        c3e_matrix_free(pressure);
+    }
+    pthread_join(filler, NULL);
+
+    for(int i = 0; i < 1024 * 1024; i++)
+        busy.intact &= busy.matrix->data[i] == (c3e_number) (i + 3);
+    printf("Busy buffer kept while spilling: %s\r\n", busy.intact ? "yes" : "no");
+    c3e_matrix_free(busy.matrix);
+
+    memory_worker workers[4];
+    pthread_t threads[4];
+
+    for(int i = 0; i < 4; i++) {
+        workers[i] = (memory_worker) {NULL, i, false};
+        pthread_create(&threads[i], NULL, spill_idle, &workers[i]);
+    }
+
+    bool concurrent = true;
+    for(int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+        concurrent &= workers[i].intact;
+    }
+    printf("Concurrent spills intact: %s\r\n", concurrent ? "yes" : "no");
+
+    size_t accounted = c3e_memory_resident();
+    c3e_matrix* borrowed = (c3e_matrix*) malloc(sizeof(c3e_matrix));
+
+    borrowed->rows = borrowed->cols = 128;
+    borrowed->data = (c3e_number*) malloc(128 * 128 * sizeof(c3e_number));
+    c3e_matrix_free(borrowed);
+    printf("Caller buffer freed: %s\r\n", c3e_memory_resident() == accounted ? "yes" : "no");
+
+    for(int i = 0; i < 8; i++)
+        c3e_matrix_free(matrices[i]);
+    c3e_memory_set_budget(0);
+
+    printf("Accounting released: %s\r\n",
+        c3e_memory_resident() == resident && c3e_memory_spilled() == 0 ? "yes" : "no");
+
+    c3e_matrix* square = c3e_matrix_init(96, 96);
+    for(int i = 0; i < 96; i++)
+        for(int j = 0; j < 96; j++)
+            MATRIX_ELEM(square, i, j) = (i == j ? 96.0 : 0.0) + sin((c3e_number) (i * 96 + j));
+
+    c3e_svd expected = c3e_svd_init(square);
+    c3e_memory_set_budget(c3e_memory_resident() + ((size_t) 256 << 10));
+
+    c3e_svd budgeted = c3e_svd_init(square);
+    c3e_memory_set_budget(0);
+
+    printf("Decomposition spilled: %s\r\n", c3e_memory_spilled() > 0 ? "yes" : "no");
+    printf("Decomposition under budget matches: %s\r\n",
+        c3e_matrix_all_close(expected.left, budgeted.left) &&
+        c3e_matrix_all_close(expected.right, budgeted.right) &&
+        c3e_vector_all_close(expected.singular, budgeted.singular) ? "yes" : "no");
+
+    c3e_svd_free(budgeted);
+    c3e_svd_free(expected);
+    c3e_matrix_free(square);
+}
+
+static void checkpoint_done(const char* path, bool success, void* context) {
+    *(int*) context = success ? 1 : -1;
+}
+
+void test_checkpoint() {
+    char path[] = "/tmp/c3e_checkpoint_XXXXXX";
+    int fd = mkstemp(path);
+
+    if(fd < 0) {
+        printf("Error: Failed to create test file.\r\n");
+        return;
+    }
+    close(fd);
+
+    c3e_matrix* weights = c3e_matrix_full(50, 20, 0.5);
+    c3e_vector* bias = c3e_vector_fill(20, 0.125);
+    c3e_matrix* slices[] = {c3e_matrix_full(3, 3, 2.0), c3e_matrix_full(3, 3, 4.0)};
+    c3e_tensor* tensor = c3e_tensor_init(2, 2, slices, c3e_vector_fill(2, 1.0));
+
+    int done = 0;
+    c3e_checkpoint* checkpoint = c3e_checkpoint_begin(path, C3E_DTYPE_NATIVE);
+    bool snapshotted = checkpoint != NULL &&
+        c3e_checkpoint_add_matrix(checkpoint, "weights", weights) &&
+        c3e_checkpoint_add_vector(checkpoint, "bias", bias) &&
+        c3e_checkpoint_add_tensor(checkpoint, "tensor", tensor);
+
+    c3e_matrix_fill(weights, 9.0);
+    bias->data[0] = 9.0;
+    c3e_matrix_fill(tensor->matrices[1], 9.0);
+
+    bool committed = snapshotted && c3e_checkpoint_commit(checkpoint, checkpoint_done, &done);
+    bool written = checkpoint != NULL && c3e_checkpoint_wait(checkpoint);
+
+    printf("Checkpoint written: %s\r\n", committed && written ? "yes" : "no");
+    printf("Callback notified: %s\r\n", done == 1 ? "yes" : "no");
+
+    char temporary[sizeof(path) + 4];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+    printf("Temporary file renamed: %s\r\n", access(temporary, F_OK) != 0 ? "yes" : "no");
+
+    c3e_archive* archive = c3e_archive_open(path);
+    c3e_matrix* loaded = archive == NULL ? NULL : c3e_archive_matrix(archive, "weights");
+    c3e_vector* restored = archive == NULL ? NULL : c3e_archive_vector(archive, "bias");
+    c3e_tensor* copy = archive == NULL ? NULL : c3e_archive_tensor(archive, "tensor");
+
+    printf("Snapshot unaffected by later writes: %s\r\n",
+        loaded != NULL && loaded->rows == 50 && c3e_matrix_max(loaded) == 0.5 &&
+        restored != NULL && restored->data[0] == 0.125 &&
+        copy != NULL && MATRIX_ELEM(copy->matrices[1], 2, 2) == 4.0 ? "yes" : "no");
+
+    if(archive != NULL)
+        c3e_archive_close(archive);
+    unlink(path);
+
+    c3e_matrix_free(weights);
+    c3e_vector_free(bias);
+    c3e_tensor_free(tensor);
+}
+
+void test_loader() {
+    c3e_matrix* features = c3e_matrix_init(103, 4);
+    c3e_matrix* labels = c3e_matrix_init(103, 1);
+
+    for(uint32_t i = 0; i < 103; i++) {
+        for(uint32_t j = 0; j < 4; j++)
+            MATRIX_ELEM(features, i, j) = (c3e_number) i;
+        MATRIX_ELEM(labels, i, 0) = (c3e_number) (2 * i);
+    }
+
+    c3e_matrix* sources[] = {features, labels};
+    c3e_loader* loader = c3e_loader_init(sources, 2, 10, 3, 2, true, 42);
+
+    if(loader == NULL) {
+        printf("Error: Failed to create loader.\r\n");
+        return;
+    }
+
+    bool aligned = true, covered = true, reordered = false;
+    uint32_t order[2][103];
+
+    for(uint32_t epoch = 0; epoch < 2; epoch++) {
+        bool seen[103] = {false};
+        uint32_t visited = 0;
+
+        for(uint32_t b = 0; b < loader->batches; b++) {
+            c3e_matrix** batch = c3e_loader_next(loader);
+
+            for(uint32_t i = 0; i < batch[0]->rows; i++) {
+                uint32_t row = (uint32_t) MATRIX_ELEM(batch[0], i, 0);
+
+                aligned = aligned && MATRIX_ELEM(batch[0], i, 3) == row &&
+                    MATRIX_ELEM(batch[1], i, 0) == 2 * row;
+                covered = covered && row < 103 && !seen[row];
+
+                if(row < 103) {
+                    seen[row] = true;
+                    order[epoch][visited++] = row;
+                }
+            }
+
+            if(b == loader->batches - 1)
+                covered = covered && batch[0]->rows == 3 && visited == 103;
+            c3e_loader_release(loader);
+        }
+    }
+
+    for(uint32_t i = 0; i < 103; i++)
+        reordered = reordered || order[0][i] != order[1][i];
+
+    printf("Batches aligned across sources: %s\r\n", aligned ? "yes" : "no");
+    printf("Every row visited once per epoch: %s\r\n", covered ? "yes" : "no");
+    printf("Epochs shuffled differently: %s\r\n", reordered ? "yes" : "no");
+
+    c3e_loader_free(loader);
+    c3e_matrix_free(features);
+    c3e_matrix_free(labels);
+}
+
+void test_random() {
+    c3e_matrix* first = c3e_matrix_random(300, 300, 7);
+    c3e_matrix* second = c3e_matrix_random(300, 300, 7);
+    c3e_matrix* other = c3e_matrix_random(300, 300, 8);
+
+    size_t size = 300 * 300 * sizeof(c3e_number);
+    printf("Same seed reproduces: %s\r\n", memcmp(first->data, second->data, size) == 0 ? "yes" : "no");
+    printf("Different seeds differ: %s\r\n", memcmp(first->data, other->data, size) != 0 ? "yes" : "no");
+
+    bool bounded = true;
+    c3e_number mean = 0.0;
+
+    for(uint32_t i = 0; i < 300 * 300; i++) {
+        bounded = bounded && first->data[i] >= 0.0 && first->data[i] < 1.0;
+        mean += first->data[i];
+    }
+    mean /= 300 * 300;
+
+    printf("Uniform in [0, 1): %s\r\n", bounded && fabs(mean - 0.5) < 0.01 ? "yes" : "no");
+
+    c3e_rng bulk, single;
+    c3e_rng_init(&bulk, 99, 3);
+    c3e_rng_init(&single, 99, 3);
+
+    c3e_number values[37];
+    c3e_rng_uniform(&bulk);
+    c3e_rng_fill(&bulk, values, 37, -2.0, 2.0);
+    c3e_rng_uniform(&single);
+
+    bool matching = true;
+    for(int i = 0; i < 37; i++)
+        matching = matching && values[i] == -2.0 + 4.0 * c3e_rng_uniform(&single);
+    printf("Bulk fill matches single draws: %s\r\n", matching ? "yes" : "no");
+
+    size_t count = 1000003;
+    c3e_number* serial = (c3e_number*) malloc(count * sizeof(c3e_number));
+    c3e_number* parallel = (c3e_number*) malloc(count * sizeof(c3e_number));
+
+    c3e_rng_init(&single, 5, 0);
+    c3e_rng_uniform(&single);
+    c3e_rng_fill(&single, serial, count, 0.0, 1.0);
+
+    c3e_number next = c3e_rng_uniform(&single);
+    bool identical = true;
+    for(uint32_t threads = 1; threads <= 8; threads *= 2) {
+        c3e_rng_init(&bulk, 5, 0);
+        c3e_rng_uniform(&bulk);
+        c3e_rng_fill_parallel(&bulk, parallel, count, 0.0, 1.0, threads);
+
+        identical = identical && memcmp(serial, parallel, count * sizeof(c3e_number)) == 0 &&
+            c3e_rng_uniform(&bulk) == next;
+    }
+    printf("Parallel fill independent of threads: %s\r\n", identical ? "yes" : "no");
+
+    c3e_rng_init(&bulk, 5, 0);
+    c3e_rng_seek(&bulk, 1 + 12345);
+    printf("Seek lands on the same element: %s\r\n", c3e_rng_uniform(&bulk) == serial[12345] ? "yes" : "no");
+
+    free(serial);
+    free(parallel);
+
+    c3e_number ambient = c3e_random();
+    printf("Ambient random in [0, 1): %s\r\n", ambient >= 0.0 && ambient < 1.0 ? "yes" : "no");
+
+    c3e_matrix_free(first);
+    c3e_matrix_free(second);
+    c3e_matrix_free(other);
+}
+
+static void moments(c3e_number* data, size_t count, c3e_number* mean, c3e_number* variance) {
+    c3e_number sum = 0.0, squares = 0.0;
+
+    for(size_t i = 0; i < count; i++)
+        sum += data[i];
+    *mean = sum / count;
+
+    for(size_t i = 0; i < count; i++)
+        squares += (data[i] - *mean) * (data[i] - *mean);
+    *variance = squares / (count - 1);
+}
+
+void test_distributions() {
+    size_t count = 200001;
+    c3e_vector* sample = c3e_vector_init(count);
+    c3e_number mean, variance;
+
+    c3e_rng rng;
+    c3e_rng_init(&rng, 2024, 0);
+
+    c3e_rng_fill_normal(&rng, sample->data, count, 3.0, 2.0);
+    moments(sample->data, count, &mean, &variance);
+    printf("Normal moments: %s\r\n", fabs(mean - 3.0) < 0.03 && fabs(variance - 4.0) < 0.08 ? "yes" : "no");
+
+    c3e_rng_fill_exponential(&rng, sample->data, count, 0.5);
+    moments(sample->data, count, &mean, &variance);
+    printf("Exponential moments: %s\r\n", fabs(mean - 2.0) < 0.03 && fabs(variance - 4.0) < 0.15 ? "yes" : "no");
+
+    c3e_rng_fill_gamma(&rng, sample->data, count, 2.5, 2.0);
+    moments(sample->data, count, &mean, &variance);
+    bool gamma = fabs(mean - 5.0) < 0.05 && fabs(variance - 10.0) < 0.3;
+
+    c3e_rng_fill_gamma(&rng, sample->data, count, 0.5, 1.0);
+    moments(sample->data, count, &mean, &variance);
+    printf("Gamma moments: %s\r\n", gamma && fabs(mean - 0.5) < 0.01 && fabs(variance - 0.5) < 0.02 ? "yes" : "no");
+
+    c3e_rng_fill_poisson(&rng, sample->data, count, 3.0);
+    moments(sample->data, count, &mean, &variance);
+    bool poisson = fabs(mean - 3.0) < 0.03 && fabs(variance - 3.0) < 0.06;
+
+    c3e_rng_fill_poisson(&rng, sample->data, count, 40.0);
+    moments(sample->data, count, &mean, &variance);
+    printf("Poisson moments: %s\r\n", poisson && fabs(mean - 40.0) < 0.1 && fabs(variance - 40.0) < 0.8 &&
+        sample->data[0] == floor(sample->data[0]) ? "yes" : "no");
+
+    c3e_number weights[] = {1.0, 0.0, 2.0, 7.0};
+    c3e_alias* alias = c3e_alias_init(weights, 4);
+    size_t frequencies[4] = {0};
+
+    c3e_rng_fill_categorical(&rng, alias, sample->data, count);
+    for(size_t i = 0; i < count; i++)
+        frequencies[(size_t) sample->data[i]]++;
+
+    printf("Categorical frequencies: %s\r\n",
+        frequencies[1] == 0 &&
+        fabs((c3e_number) frequencies[0] / count - 0.1) < 0.005 &&
+        fabs((c3e_number) frequencies[2] / count - 0.2) < 0.005 &&
+        fabs((c3e_number) frequencies[3] / count - 0.7) < 0.005 ? "yes" : "no");
+
+    c3e_alias_free(alias);
+    c3e_vector_free(sample);
+}
+
+void test_sampling() {
+    uint32_t count = 1000000;
+    uint32_t* indices = (uint32_t*) malloc(count * sizeof(uint32_t));
+    uint32_t* other = (uint32_t*) malloc(count * sizeof(uint32_t));
+    bool* seen = (bool*) calloc(count, sizeof(bool));
+
+    c3e_rng rng;
+    c3e_rng_init(&rng, 2024, 0);
+    c3e_rng_permutation(&rng, indices, count, 1);
+
+    bool valid = true, moved = false;
+    for(uint32_t i = 0; i < count; i++) {
+        valid = valid && indices[i] < count && !seen[indices[i]];
+        seen[indices[i] % count] = true;
+        moved = moved || indices[i] != i;
+    }
+    printf("Permutation valid: %s\r\n", valid && moved ? "yes" : "no");
+
+    bool same = true;
+    for(uint32_t threads = 2; threads <= 8; threads *= 4) {
+        c3e_rng_init(&rng, 2024, 0);
+        c3e_rng_permutation(&rng, other, count, threads);
+        same = same && memcmp(indices, other, count * sizeof(uint32_t)) == 0;
+    }
+    printf("Permutation thread independent: %s\r\n", same ? "yes" : "no");
+
+    uint32_t population = 4000000000u;
+    c3e_rng_sample(&rng, population, indices, 1000);
+
+    bool unique = true;
+    for(uint32_t i = 0; i < 1000; i++)
+        for(uint32_t j = i + 1; j < 1000; j++)
+            unique = unique && indices[i] != indices[j];
+    printf("Sample distinct: %s\r\n", unique ? "yes" : "no");
+
+    c3e_rng_sample(&rng, 1000, indices, 1000);
+    memset(seen, 0, 1000 * sizeof(bool));
+
+    bool full = true;
+    for(uint32_t i = 0; i < 1000; i++) {
+        full = full && indices[i] < 1000 && !seen[indices[i] % 1000];
+        seen[indices[i] % 1000] = true;
+    }
+    printf("Sample of whole population: %s\r\n", full ? "yes" : "no");
+
+    c3e_reservoir* reservoir = c3e_reservoir_init(100);
+    uint64_t stream = 100000;
+    uint32_t kept = 0;
+
+    for(uint64_t i = 0; i < stream; i++)
+        if(c3e_reservoir_offer(reservoir, &rng) != C3E_RESERVOIR_SKIP)
+            kept++;
+
+    memset(seen, 0, stream * sizeof(bool));
+    bool held = reservoir->count == 100 && reservoir->seen == stream;
+    for(uint32_t i = 0; held && i < reservoir->count; i++) {
+        held = reservoir->indices[i] < stream && !seen[reservoir->indices[i]];
+        seen[reservoir->indices[i]] = true;
+    }
+    printf("Reservoir sample: %s\r\n", held && kept > 100 && kept < 2000 ? "yes" : "no");
+    c3e_reservoir_free(reservoir);
+
+    c3e_matrix* matrix = c3e_matrix_init(5, 3);
+    for(uint32_t i = 0; i < 15; i++)
+        matrix->data[i] = i;
+
+    uint32_t rows[] = {4, 0, 4, 2};
+    c3e_matrix* gathered = c3e_matrix_gather_rows(matrix, rows, 4);
+
+    bool gather = gathered->rows == 4 && gathered->cols == 3;
+    for(uint32_t i = 0; gather && i < 4; i++)
+        gather = memcmp(&MATRIX_ELEM(gathered, i, 0), &MATRIX_ELEM(matrix, rows[i], 0), 3 * sizeof(c3e_number)) == 0;
+    printf("Gathered rows: %s\r\n", gather ? "yes" : "no");
+
+    uint32_t permutation[] = {3, 0, 4, 1, 2};
+    c3e_matrix_permute_rows(matrix, permutation);
+
+    bool permute = true;
+    for(uint32_t i = 0; i < 5; i++)
+        permute = permute && MATRIX_ELEM(matrix, i, 0) == permutation[i] * 3 &&
+            MATRIX_ELEM(matrix, i, 2) == permutation[i] * 3 + 2;
+    printf("Permuted rows: %s\r\n", permute ? "yes" : "no");
+
+    c3e_matrix_free(gathered);
+    c3e_matrix_free(matrix);
+    free(indices);
+    free(other);
+    free(seen);
+}
+
+void quarter_disk(c3e_rng* rng, uint64_t first, uint32_t paths, c3e_vector* scratch, c3e_number* values, void* context) {
+    (void) first;
+    (void) context;
+
+    c3e_rng_fill(rng, scratch->data, 2 * paths, 0.0, 1.0);
+    for(uint32_t i = 0; i < paths; i++) {
+        c3e_number x = scratch->data[2 * i], y = scratch->data[2 * i + 1];
+
+        values[2 * i] = x * x + y * y <= 1.0 ? 4.0 : 0.0;
+        values[2 * i + 1] = x;
+    }
+}
+
+void test_montecarlo() {
+    c3e_montecarlo* single = c3e_montecarlo_run(quarter_disk, NULL, 2000003, 2, 4096, 8192, 2024, 1);
+    c3e_montecarlo* parallel = c3e_montecarlo_run(quarter_disk, NULL, 2000003, 2, 4096, 8192, 2024, 8);
+
+    c3e_number pi = single->mean->data[0];
+    printf("Pi estimate: %s\r\n", fabs(pi - PI) < 4.0 * single->error->data[0] ? "yes" : "no");
+    printf("Uniform moments: %s\r\n",
+        fabs(single->mean->data[1] - 0.5) < 0.002 &&
+        fabs(single->variance->data[1] - 1.0 / 12.0) < 0.001 ? "yes" : "no");
+    printf("Standard error: %s\r\n",
+        fabs(single->error->data[0] - sqrt(pi * (4.0 - pi) / 2000003.0)) < 1e-5 ? "yes" : "no");
+    printf("Thread count independent: %s\r\n",
+        memcmp(single->mean->data, parallel->mean->data, 2 * sizeof(c3e_number)) == 0 &&
+        memcmp(single->variance->data, parallel->variance->data, 2 * sizeof(c3e_number)) == 0 ? "yes" : "no");
+
+    c3e_montecarlo_free(single);
+    c3e_montecarlo_free(parallel);
+}
+
+void square_range(size_t first, size_t last, void* context) {
+    c3e_number* data = (c3e_number*) context;
+
+    for(size_t i = first; i < last; i++)
+        data[i] = (c3e_number) i * i;
+}
+
+void sum_range(size_t first, size_t last, void* partial, void* context) {
+    c3e_number* data = (c3e_number*) context;
+    c3e_number sum = 0.0;
+
+    for(size_t i = first; i < last; i++)
+        sum += data[i];
+    *(c3e_number*) partial = sum;
+}
+
+void add_partial(void* partial, const void* other, void* context) {
+    (void) context;
+    *(c3e_number*) partial += *(const c3e_number*) other;
+}
+
+void nested_range(size_t first, size_t last, void* context) {
+    c3e_number* data = (c3e_number*) context;
+
+    for(size_t i = first; i < last; i++)
+        c3e_parallel_reduce(0, 1000, 10, &data[i], sizeof(c3e_number), sum_range, add_partial, data + 1000 * (i + 1));
+}
+
+void* run_submitted(void* argument) {
+    void** job = (void**) argument;
+
+    ((void (*)(void*)) job[0])(job[1]);
+    free(job);
+
+    return NULL;
+}
+
+void thread_executor(void (*task)(void*), void* argument, void* executor) {
+    void** job = (void**) malloc(2 * sizeof(void*));
+    pthread_t thread;
+
+    (void) executor;
+    job[0] = (void*) task;
+    job[1] = argument;
+
+    if(pthread_create(&thread, NULL, run_submitted, job) == 0)
+        pthread_detach(thread);
+    else run_submitted(job);
+}
+
+void lazy_executor(void (*task)(void*), void* argument, void* executor) {
+    void** pending = (void**) executor;
+
+    pending[0] = (void*) task;
+    pending[1] = argument;
+}
+
+void test_pool() {
+    size_t count = 1000000;
+    c3e_number* data = (c3e_number*) malloc(count * sizeof(c3e_number));
+
+    c3e_parallel_for(0, count, 0, square_range, data);
+    bool filled = true;
+    for(size_t i = 0; i < count; i++)
+        filled = filled && data[i] == (c3e_number) i * i;
+    printf("Parallel for: %s\r\n", filled ? "yes" : "no");
+
+    c3e_number sum, single, pinned;
+    c3e_parallel_reduce(0, count, 1000, &sum, sizeof(c3e_number), sum_range, add_partial, data);
+
+    c3e_pool_start(1, NULL);
+    c3e_parallel_reduce(0, count, 1000, &single, sizeof(c3e_number), sum_range, add_partial, data);
+
+    uint32_t cpus[] = {0, 0, 0};
+    bool affinity = c3e_pool_start(3, cpus);
+    c3e_parallel_reduce(0, count, 1000, &pinned, sizeof(c3e_number), sum_range, add_partial, data);
+
+    printf("Parallel reduce: %s\r\n", fabs(sum - 333332833333500000.0) / sum < 1e-12 ? "yes" : "no");
+    printf("Reduce independent of pool size: %s\r\n", sum == single && sum == pinned ? "yes" : "no");
+    printf("Pinned workers: %s\r\n", affinity && c3e_pool_size() == 3 ? "yes" : "no");
+
+    c3e_pool_start(4, NULL);
+    for(size_t i = 1000; i < count; i++)
+        data[i] = 1.0;
+
+    c3e_parallel_for(0, 64, 1, nested_range, data);
+    bool nested = true;
+    for(size_t i = 0; i < 64; i++)
+        nested = nested && data[i] == 1000.0;
+    printf("Nested parallelism: %s\r\n", nested ? "yes" : "no");
+
+    c3e_executor executor = {thread_executor, 4, NULL};
+    c3e_pool_set_executor(&executor);
+    c3e_parallel_reduce(0, count, 1000, &single, sizeof(c3e_number), sum_range, add_partial, data);
+
+    void* pending[2] = {NULL, NULL};
+    c3e_executor lazy = {lazy_executor, 2, pending};
+    c3e_pool_set_executor(&lazy);
+    c3e_parallel_reduce(0, count, 1000, &pinned, sizeof(c3e_number), sum_range, add_partial, data);
+
+    ((void (*)(void*)) pending[0])(pending[1]);
+    c3e_pool_set_executor(NULL);
+    c3e_parallel_reduce(0, count, 1000, &sum, sizeof(c3e_number), sum_range, add_partial, data);
+
+    printf("Custom executor: %s\r\n", sum == single && sum == pinned ? "yes" : "no");
+    c3e_pool_stop();
+    free(data);
+}
+
+typedef struct {
+    uint32_t order[100];
+    _Atomic uint32_t count;
+    _Atomic uint32_t flag;
+} stream_log;
+
+void* log_op(void* argument) {
+    stream_log* log = (stream_log*) argument;
+    uint32_t index = atomic_load(&log->count);
+
+    log->order[index] = index;
+    atomic_store(&log->count, index + 1);
+
+    return (void*) (uintptr_t) index;
+}
+
+void* slow_op(void* argument) {
+    stream_log* log = (stream_log*) argument;
+
+    usleep(20000);
+    atomic_store(&log->flag, 1);
+
+    return NULL;
+}
+
+void* read_flag_op(void* argument) {
+    stream_log* log = (stream_log*) argument;
+    return (void*) (uintptr_t) atomic_load(&log->flag);
+}
+
+void* await_flag_op(void* argument) {
+    stream_log* log = (stream_log*) argument;
+
+    for(uint32_t i = 0; i < 2000 && !atomic_load(&log->flag); i++)
+        usleep(1000);
+    return (void*) (uintptr_t) atomic_load(&log->flag);
+}
+
+static _Atomic uint32_t stream_failures = 0;
+
+static void count_stream_failure(const char* filename, int line) {
+    atomic_fetch_add(&stream_failures, 1);
+}
+
+void* failing_op(void* argument) {
+    c3e_assert(false);
+    return argument;
+}
+
+void test_stream() {
+    c3e_stream* first = c3e_stream_init();
+    c3e_stream* second = c3e_stream_init();
+    stream_log log = {{0}, 0, 0};
+
+    c3e_event* events[100];
+    for(uint32_t i = 0; i < 100; i++)
+        events[i] = c3e_stream_enqueue(first, log_op, &log);
+    c3e_stream_synchronize(first);
+
+    bool ordered = atomic_load(&log.count) == 100;
+    for(uint32_t i = 0; i < 100; i++) {
+        ordered = ordered && c3e_event_query(events[i]) && log.order[i] == i &&
+            (uintptr_t) c3e_event_wait(events[i]) == i;
+        c3e_event_release(events[i]);
+    }
+    printf("In-order execution: %s\r\n", ordered ? "yes" : "no");
+
+    c3e_event* slow = c3e_stream_enqueue(first, slow_op, &log);
+    c3e_stream_wait_event(second, slow);
+
+    c3e_event* read = c3e_stream_enqueue(second, read_flag_op, &log);
+    printf("Cross-stream dependency: %s\r\n", (uintptr_t) c3e_event_wait(read) == 1 ? "yes" : "no");
+
+    c3e_event_release(slow);
+    c3e_event_release(read);
+
+    atomic_store(&log.flag, 0);
+    c3e_event* waiting = c3e_stream_enqueue(first, await_flag_op, &log);
+    c3e_event* setting = c3e_stream_enqueue(second, slow_op, &log);
+    printf("Concurrent streams: %s\r\n", (uintptr_t) c3e_event_wait(waiting) == 1 ? "yes" : "no");
+
+    c3e_event_release(waiting);
+    c3e_event_release(setting);
+
+    c3e_matrix* a = c3e_matrix_random(64, 48, 7);
+    c3e_matrix* b = c3e_matrix_random(48, 32, 8);
+    c3e_event* future = c3e_stream_matrix_mul(first, a, b);
+    c3e_matrix* expected = c3e_matrix_mul(a, b);
+    c3e_matrix* product = (c3e_matrix*) c3e_event_wait(future);
+
+    printf("Asynchronous product: %s\r\n", product != NULL &&
+        memcmp(product->data, expected->data, 64 * 32 * sizeof(c3e_number)) == 0 ? "yes" : "no");
+
+    c3e_event_release(future);
+    c3e_matrix_free(product);
+    c3e_matrix_free(expected);
+    c3e_matrix_free(a);
+    c3e_matrix_free(b);
+
+    c3e_assert_handler(count_stream_failure);
+    c3e_event* failed = c3e_stream_enqueue(second, failing_op, &log);
+
+    c3e_event_wait(failed);
+    c3e_assert_remove_handler();
+
+    printf("Operation uses enqueuing handler: %s\r\n", atomic_load(&stream_failures) == 1 ? "yes" : "no");
+    c3e_event_release(failed);
+
+    c3e_stream_free(first);
+    c3e_stream_free(second);
+}
+
+typedef struct {
+    uint32_t** cursor;
+    uint32_t value;
+} graph_step;
+
+void record_order(void* argument) {
+    graph_step* step = (graph_step*) argument;
+    *(*step->cursor)++ = step->value;
+}
+
+void test_graph() {
+    uint32_t order[4], *cursor = order;
+    uint32_t first_block, second_block;
+    c3e_graph* graph = c3e_graph_init();
+
+    graph_step step = {&cursor, 0};
+
+    c3e_graph_access write_first = {&first_block, C3E_GRAPH_WRITE};
+    c3e_graph_access read_first = {&first_block, C3E_GRAPH_READ};
+    c3e_graph_access writes[2] = {{&first_block, C3E_GRAPH_WRITE}, {&second_block, C3E_GRAPH_WRITE}};
+
+    step.value = 1;
+    c3e_graph_submit(graph, record_order, &step, sizeof(step), &write_first, 1);
+    step.value = 2;
+    c3e_graph_submit(graph, record_order, &step, sizeof(step), &read_first, 1);
+    step.value = 3;
+    c3e_graph_submit(graph, record_order, &step, sizeof(step), writes, 2);
+
+    bool ran = c3e_graph_run(graph);
+    printf("Graph dependencies: %s\r\n", ran && cursor - order == 3 &&
+        order[0] == 1 && order[1] == 2 && order[2] == 3 ? "yes" : "no");
+    c3e_graph_free(graph);
+
+    int order_size = 203;
+    c3e_matrix* base = c3e_matrix_random(order_size, order_size, 11);
+    c3e_matrix* spd = c3e_matrix_zeros(order_size, order_size);
+
+    for(int i = 0; i < order_size; i++)
+        for(int j = 0; j < order_size; j++) {
+            c3e_number sum = i == j ? order_size : 0.0;
+
+            for(int p = 0; p < order_size; p++)
+                sum += MATRIX_ELEM(base, i, p) * MATRIX_ELEM(base, j, p);
+            MATRIX_ELEM(spd, i, j) = sum;
+        }
+
+    c3e_pool_start(4, NULL);
+    c3e_matrix* reference = c3e_matrix_cholesky_decomp(spd);
+    c3e_matrix* tiled = c3e_matrix_cholesky_tiled(spd, 32);
+
+    c3e_number difference = 0.0;
+    for(int i = 0; i < order_size * order_size; i++)
+        difference = fmax(difference, fabs(tiled->data[i] - reference->data[i]));
+    printf("Tiled Cholesky: %s\r\n", difference < 1e-9 ? "yes" : "no");
+
+    MATRIX_ELEM(spd, 150, 150) = -1.0;
+    c3e_matrix* failed = c3e_matrix_cholesky_tiled(spd, 32);
+    printf("Tiled Cholesky rejects indefinite: %s\r\n", failed == NULL ? "yes" : "no");
+
+    c3e_pool_stop();
+    c3e_matrix_free(base);
+    c3e_matrix_free(spd);
+    c3e_matrix_free(reference);
+    c3e_matrix_free(tiled);
+}
+
+static _Atomic uint32_t context_failures = 0;
+
+static void count_failure(const char* filename, int line) {
+    atomic_fetch_add(&context_failures, 1);
+}
+
+static void* probe_handler(void* argument) {
+    *(bool*) argument = c3e_assert_has_handler();
+    return NULL;
+}
+
+static void probe_writer(const char* path, bool success, void* context) {
+    *(bool*) context = success && c3e_assert_has_handler();
+}
+
+static void* arena_alloc(size_t size, void* state) {
+    void* data = NULL;
+
+    (*(uint32_t*) state)++;
+    return posix_memalign(&data, 64, size) == 0 ? data : NULL;
+}
+
+static void arena_free(void* data, void* state) {
+    (*(uint32_t*) state)--;
+    free(data);
+}
+
+static void* failing_alloc(size_t size, void* state) {
+    return NULL;
+}
+
+static void failing_body(size_t first, size_t last, void* context) {
+    for(size_t i = first; i < last; i++)
+        c3e_assert(i % 2 == 0);
+}
+
+void test_context() {
+    c3e_context first, second;
+    c3e_context_init(&first, 21);
+    c3e_context_init(&second, 21);
+
+    c3e_context* previous = c3e_context_use(&first);
+    c3e_number first_draw = c3e_random();
+    c3e_context_use(&second);
+    c3e_number second_draw = c3e_random();
+    c3e_context_use(previous);
+
+    printf("Context seeds: %s\r\n", first_draw == second_draw ? "yes" : "no");
+
+    bool other_handler = true;
+    pthread_t thread;
+
+    c3e_assert_handler(count_failure);
+    pthread_create(&thread, NULL, probe_handler, &other_handler);
+    pthread_join(thread, NULL);
+    printf("Context handler per thread: %s\r\n", c3e_assert_has_handler() && !other_handler ? "yes" : "no");
+
+    uint32_t blocks = 0;
+    c3e_context arena;
+    c3e_context_init(&arena, 0);
+
+    arena.settings.allocator = (c3e_allocator) {arena_alloc, arena_free, &blocks};
+    previous = c3e_context_use(&arena);
+
+    c3e_matrix* matrix = c3e_matrix_zeros(16, 16);
+    uint32_t live = blocks;
+    c3e_matrix_free(matrix);
+
+    printf("Context allocator: %s\r\n", live == 1 && blocks == 0 &&
+        arena.counters.allocations == 1 && arena.counters.frees == 1 &&
+        arena.counters.bytes == 16 * 16 * sizeof(c3e_number) ? "yes" : "no");
+
+    arena.settings.allocator.alloc = failing_alloc;
+    c3e_matrix* failed = c3e_matrix_init(16, 16);
+    printf("Context allocation error: %s\r\n", failed == NULL &&
+        c3e_context_take_error() == ENOMEM && c3e_context_take_error() == 0 ? "yes" : "no");
+    c3e_context_use(previous);
+
+    c3e_pool_start(4, NULL);
+    c3e_parallel_for(0, 64, 1, failing_body, NULL);
+    c3e_pool_stop();
+
+    printf("Context handler in pool: %s\r\n", atomic_load(&context_failures) == 32 ? "yes" : "no");
+
+    char path[] = "/tmp/c3e_context_XXXXXX";
+    int fd = mkstemp(path);
+    bool writer_handler = false;
+
+    if(fd >= 0) {
+        close(fd);
+
+        c3e_checkpoint* checkpoint = c3e_checkpoint_begin(path, C3E_DTYPE_NATIVE);
+        c3e_checkpoint_commit(checkpoint, probe_writer, &writer_handler);
+        c3e_checkpoint_wait(checkpoint);
+        unlink(path);
+    }
+
+    printf("Context handler in library threads: %s\r\n", writer_handler ? "yes" : "no");
+    c3e_assert_remove_handler();
+}
+
+void test_remote() {
+    int fds[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("Error: Failed to create socket pair.\r\n");
+        return;
+    }
+
+    pid_t pid = fork();
+    if(pid == 0) {
+        c3e_socket client = {NULL, 0, fds[1]};
+        c3e_remote_store* store = c3e_remote_store_init();
+
+        close(fds[0]);
+        bool served = c3e_remote_serve(store, &client);
+
+        c3e_remote_store_free(store);
+        close(fds[1]);
+        _exit(served ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    c3e_socket server = {NULL, 0, fds[0]};
+    close(fds[1]);
+
+    c3e_matrix* a = c3e_matrix_init(3, 3);
+    c3e_matrix* b = c3e_matrix_identity(3);
+    c3e_number values[] = {4, 7, 2, 3, 6, 1, 2, 5, 3};
+
+    c3e_matrix_set_elements(a, values);
+    MATRIX_ELEM(b, 0, 2) = 2.0;
+
+    c3e_remote_upload(&server, "a", a);
+    c3e_remote_upload(&server, "b", b);
+    c3e_remote_request(&server, C3E_REMOTE_MUL, "ab", "a", "b", 0.0, C3E_REMOTE_REPLY_HANDLE);
+    c3e_remote_request(&server, C3E_REMOTE_SCALAR_MUL, NULL, "ab", NULL, 2.0, C3E_REMOTE_REPLY_VALUE);
+    c3e_remote_request(&server, C3E_REMOTE_ADD, NULL, "ab", "missing", 0.0, C3E_REMOTE_REPLY_VALUE);
+
+    c3e_matrix* large = c3e_matrix_full(16, 16, 0.25);
+    c3e_matrix* flat = c3e_matrix_ones(16, 16);
+
+    for(int i = 0; i < 16; i++)
+        MATRIX_ELEM(large, i, i) = 8.0;
+
+    c3e_remote_upload(&server, "large", large);
+    c3e_remote_upload(&server, "flat", flat);
+    c3e_remote_request(&server, C3E_REMOTE_INVERSE, NULL, "large", NULL, 0.0, C3E_REMOTE_REPLY_VALUE);
+    c3e_remote_request(&server, C3E_REMOTE_INVERSE, NULL, "flat", NULL, 0.0, C3E_REMOTE_REPLY_VALUE);
+
+    c3e_remote_result results[9];
+    bool received = true;
+
+    for(int i = 0; i < 9 && received; i++)
+        received = c3e_remote_receive(&server, &results[i]);
+    close(fds[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+
+    c3e_matrix* ab = c3e_matrix_mul(a, b);
+    c3e_matrix* expected = c3e_matrix_scalar_mul(ab, 2.0);
+
+    printf("Pipelined requests answered: %s\r\n", received ? "yes" : "no");
+    printf("Handle result shape: %dx%d\r\n", received ? results[2].rows : 0, received ? results[2].cols : 0);
+    printf("Value result matches: %s\r\n",
+        received && results[3].value != NULL && c3e_matrix_all_close(expected, results[3].value) ? "yes" : "no");
+    printf("Missing operand reported: %s\r\n",
+        received && results[4].status == C3E_REMOTE_NOT_FOUND ? "yes" : "no");
+
+    c3e_matrix* eye = c3e_matrix_identity(16);
+    c3e_matrix* identity = received && results[7].value != NULL ?
+        c3e_matrix_mul(large, results[7].value) : NULL;
+    printf("Large inverse computed: %s\r\n",
+        identity != NULL && c3e_matrix_all_close(identity, eye) ? "yes" : "no");
+    printf("Singular inverse rejected: %s\r\n",
+        received && results[8].status == C3E_REMOTE_INVALID ? "yes" : "no");
+    printf("Server exited cleanly: %s\r\n",
+        WIFEXITED(status) && WEXITSTATUS(status) == 0 ? "yes" : "no");
+
+    if(received && results[3].value != NULL)
+        c3e_matrix_free(results[3].value);
+    if(received && results[7].value != NULL)
+        c3e_matrix_free(results[7].value);
+    if(identity != NULL)
+        c3e_matrix_free(identity);
+
+    c3e_matrix_free(eye);
+    c3e_matrix_free(large);
+    c3e_matrix_free(flat);
+    c3e_matrix_free(expected);
+    c3e_matrix_free(ab);
+    c3e_matrix_free(b);
+    c3e_matrix_free(a);
+}
+
+void test_pubsub() {
+    int fast[2], gone[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fast) != 0 ||
+        socketpair(AF_UNIX, SOCK_STREAM, 0, gone) != 0) {
+        printf("Error: Failed to create socket pair.\r\n");
+        return;
+    }
+
+    int frames = 50;
+    pid_t reader = fork();
+
+    if(reader == 0) {
+        c3e_socket socket = {NULL, 0, fast[1]};
+        close(fast[0]);
+        close(gone[0]);
+        close(gone[1]);
+
+        int received = 0;
+        c3e_matrix* frame = NULL;
+
+        for(int i = 0; i < frames; i++) {
+            if(frame != NULL)
+                c3e_matrix_free(frame);
+
+            if((frame = c3e_socket_typed_matrix_read(&socket)) == NULL)
+                break;
+            received++;
+        }
+
+        bool last = frame != NULL && MATRIX_ELEM(frame, 63, 63) == frames - 1;
+        _exit(received == frames && last ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    pid_t leaver = fork();
+    if(leaver == 0) {
+        c3e_socket socket = {NULL, 0, gone[1]};
+        close(gone[0]);
+        close(fast[0]);
+        close(fast[1]);
+
+        c3e_matrix* frame = c3e_socket_typed_matrix_read(&socket);
+        _exit(frame != NULL ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fast[1]);
+    close(gone[1]);
+
+    c3e_broker* broker = c3e_broker_init(4, C3E_DTYPE_NATIVE, C3E_CODEC_XOR_LZ);
+    c3e_socket fast_socket = {NULL, 0, fast[0]};
+    c3e_socket gone_socket = {NULL, 0, gone[0]};
+
+    c3e_broker_subscribe(broker, &fast_socket, C3E_BROKER_BACKPRESSURE);
+    c3e_broker_subscribe(broker, &gone_socket, C3E_BROKER_DROP_OLDEST);
+
+    c3e_matrix* frame = c3e_matrix_init(64, 64);
+    for(int i = 0; i < frames; i++) {
+        c3e_matrix_fill(frame, (c3e_number) i);
+        c3e_broker_publish(broker, frame);
+    }
+
+    int fast_status, gone_status;
+    waitpid(reader, &fast_status, 0);
+    waitpid(leaver, &gone_status, 0);
+
+    for(int i = 0; i < 100 && c3e_broker_alive(broker) != 1; i++) {
+        c3e_broker_publish(broker, frame);
+        usleep(10000);
+    }
+
+    printf("Backpressured subscriber got every frame: %s\r\n",
+        WIFEXITED(fast_status) && WEXITSTATUS(fast_status) == 0 ? "yes" : "no");
+    printf("Departed subscriber detected: %s\r\n", c3e_broker_alive(broker) == 1 ? "yes" : "no");
+
+    c3e_broker_free(broker);
+    c3e_matrix_free(frame);
+
+    int large[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, large) != 0) {
+        printf("Error: Failed to create socket pair.\r\n");
+        return;
+    }
+
+    c3e_matrix* published = c3e_matrix_init(512, 512);
+    for(uint32_t i = 0; i < published->rows * published->cols; i++)
+        published->data[i] = sin((c3e_number) i * 1e-3) + 1e-4 * cos((c3e_number) i * 7.31);
+
+    pid_t listener = fork();
+    if(listener == 0) {
+        c3e_socket socket = {NULL, 0, large[1]};
+        close(large[0]);
+
+        c3e_matrix* received = c3e_socket_typed_matrix_read(&socket);
+        _exit(received != NULL && c3e_matrix_all_close(published, received) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(large[1]);
+
+    c3e_broker* coded = c3e_broker_init(1, C3E_DTYPE_NATIVE, C3E_CODEC_XOR_LZ);
+    c3e_socket large_socket = {NULL, 0, large[0]};
+
+    c3e_broker_subscribe(coded, &large_socket, C3E_BROKER_BACKPRESSURE);
+    c3e_broker_publish(coded, published);
+
+    int large_status;
+    waitpid(listener, &large_status, 0);
+
+    printf("Large coded frame received: %s\r\n",
+        WIFEXITED(large_status) && WEXITSTATUS(large_status) == 0 ? "yes" : "no");
+
+    c3e_broker_free(coded);
+    c3e_matrix_free(published);
+}
+
+bool run_collective(uint32_t rank, uint32_t size, int port) {
+    const char* hosts[] = {"127.0.0.1", "127.0.0.1", "127.0.0.1", "127.0.0.1"};
+    c3e_group* group = c3e_group_init(rank, size, hosts, port);
+
+    if(group == NULL)
+        return false;
+
+    size_t count = 40000;
+    c3e_vector* ring = c3e_vector_fill(count, (c3e_number) rank + 1);
+    c3e_vector* tree = c3e_vector_fill(count, (c3e_number) rank + 1);
+    c3e_vector* broadcast = c3e_vector_fill(count, rank == 2 ? 7.0 : 0.0);
+
+    bool passed = c3e_group_all_reduce_vector(group, ring, C3E_COLLECTIVE_RING) &&
+        c3e_group_all_reduce_vector(group, tree, C3E_COLLECTIVE_TREE) &&
+        c3e_group_broadcast(group, broadcast->data, count, 2, C3E_COLLECTIVE_TREE);
+
+    c3e_number expected = (c3e_number) (size * (size + 1)) / 2;
+    for(size_t i = 0; passed && i < count; i++)
+        passed = ring->data[i] == expected &&
+            tree->data[i] == expected &&
+            broadcast->data[i] == 7.0;
+
+    c3e_vector_free(ring);
+    c3e_vector_free(tree);
+    c3e_vector_free(broadcast);
+    c3e_group_free(group);
+
+    return passed;
+}
+
+void test_collective() {
+    uint32_t size = 4;
+    int port = 40000 + (getpid() % 5000) * 4;
+    pid_t children[3];
+
+    for(uint32_t rank = 1; rank < size; rank++)
+        if((children[rank - 1] = fork()) == 0)
+            _exit(run_collective(rank, size, port) ? EXIT_SUCCESS : EXIT_FAILURE);
+
+    bool passed = run_collective(0, size, port);
+    for(uint32_t rank = 1; rank < size; rank++) {
+        int status;
+
+        waitpid(children[rank - 1], &status, 0);
+        passed = passed && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    printf("Ring/tree all-reduce and broadcast over 4 processes: %s\r\n", passed ? "passed" : "failed");
+}
+
+bool run_summa(uint32_t rank, uint32_t size, int port, bool* matched) {
+    const char* hosts[] = {"127.0.0.1", "127.0.0.1", "127.0.0.1", "127.0.0.1"};
+    c3e_group* group = c3e_group_init(rank, size, hosts, port);
+
+    if(group == NULL)
+        return false;
+
+    c3e_matrix* a = c3e_matrix_init(37, 29);
+    c3e_matrix* b = c3e_matrix_init(29, 23);
+
+    for(uint32_t i = 0; i < a->rows; i++)
+        for(uint32_t j = 0; j < a->cols; j++)
+            MATRIX_ELEM(a, i, j) = (c3e_number) ((i * 7 + j * 3) % 11) - 5.0;
+
+    for(uint32_t i = 0; i < b->rows; i++)
+        for(uint32_t j = 0; j < b->cols; j++)
+            MATRIX_ELEM(b, i, j) = (c3e_number) ((i * 5 + j * 2) % 13) - 6.0;
+
+    c3e_dist_matrix* left = c3e_dist_matrix_init(group, 2, 2, a->rows, a->cols);
+    c3e_dist_matrix* right = c3e_dist_matrix_init(group, 2, 2, b->rows, b->cols);
+    c3e_dist_matrix* product = NULL;
+    c3e_matrix* gathered = c3e_matrix_init(a->rows, b->cols);
+
+    bool passed = left != NULL && right != NULL &&
+        c3e_dist_matrix_scatter(left, a, 0) &&
+        c3e_dist_matrix_scatter(right, b, 0) &&
+        (product = c3e_dist_matrix_mul(left, right, 8)) != NULL &&
+        c3e_dist_matrix_gather(product, gathered, 0);
+
+    if(passed && rank == 0) {
+        c3e_matrix* expected = c3e_matrix_mul(a, b);
+
+        *matched = true;
+        for(uint32_t i = 0; i < expected->rows * expected->cols; i++)
+            *matched = *matched && fabs(expected->data[i] - gathered->data[i]) < 1e-9;
+
+        c3e_matrix_free(expected);
+    }
+
+    if(product != NULL)
+        c3e_dist_matrix_free(product);
+    if(left != NULL)
+        c3e_dist_matrix_free(left);
+    if(right != NULL)
+        c3e_dist_matrix_free(right);
+
+    c3e_matrix_free(gathered);
+    c3e_matrix_free(a);
+    c3e_matrix_free(b);
+    c3e_group_free(group);
+
+    return passed;
+}
+
+void test_dist_matrix() {
+    uint32_t size = 4;
+    int port = 20000 + (getpid() % 5000) * 4;
+    pid_t children[3];
+    bool matched = false;
+
+    for(uint32_t rank = 1; rank < size; rank++)
+        if((children[rank - 1] = fork()) == 0)
+            _exit(run_summa(rank, size, port, &matched) ? EXIT_SUCCESS : EXIT_FAILURE);
+
+    bool passed = run_summa(0, size, port, &matched);
+    for(uint32_t rank = 1; rank < size; rank++) {
+        int status;
+
+        waitpid(children[rank - 1], &status, 0);
+        passed = passed && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    printf("SUMMA product on a 2x2 process grid: %s\r\n", passed ? "completed" : "failed");
+    printf("Distributed product matches local product: %s\r\n", matched ? "yes" : "no");
+}
+
 int main() {
     printf("----------------Vector Tests----------------\r\n\r\n");
     test_vector();
@@ -502,5 +2370,91 @@ int main() {
     test_tensor();
     printf("\r\n");
 
+    printf("----------------Codec Tests-----------------\r\n\r\n");
+    test_codec();
+    printf("\r\n");
+
+    printf("----------------Network Tests---------------\r\n\r\n");
+    test_net();
+    printf("\r\n");
+
+    printf("----------------Sync Tests------------------\r\n\r\n");
+    test_sync();
+    printf("\r\n");
+
+    printf("--------------Sendfile Tests----------------\r\n\r\n");
+    test_sendfile();
+    printf("\r\n");
+
+    printf("---------------Archive Tests----------------\r\n\r\n");
+    test_archive();
+    printf("\r\n");
+
+    printf("-----------------NPY Tests------------------\r\n\r\n");
+    test_npy();
+    printf("\r\n");
+
+    printf("-----------------CSV Tests------------------\r\n\r\n");
+    test_csv();
+    printf("\r\n");
+
+    printf("-------------Disk Matrix Tests--------------\r\n\r\n");
+    test_disk_matrix();
+    printf("\r\n");
+
+    printf("----------------Memory Tests----------------\r\n\r\n");
+    test_memory();
+    printf("\r\n");
+
+    printf("--------------Checkpoint Tests--------------\r\n\r\n");
+    test_checkpoint();
+    printf("\r\n");
+
+    printf("----------------Loader Tests----------------\r\n\r\n");
+    test_loader();
+    printf("\r\n");
+
+    printf("----------------Random Tests----------------\r\n\r\n");
+    test_random();
+    printf("\r\n");
+
+    printf("-------------Distribution Tests-------------\r\n\r\n");
+    test_distributions();
+    printf("\r\n");
+
+    printf("--------------Sampling Tests----------------\r\n\r\n");
+    test_sampling();
+
+    printf("-------------Monte Carlo Tests--------------\r\n\r\n");
+    test_montecarlo();
+
+    printf("----------------Pool Tests------------------\r\n\r\n");
+    test_pool();
+
+    printf("---------------Stream Tests-----------------\r\n\r\n");
+    test_stream();
+
+    printf("---------------Graph Tests------------------\r\n\r\n");
+    test_graph();
+
+    printf("--------------Context Tests-----------------\r\n\r\n");
+    test_context();
+
+    printf("---------------Remote Tests-----------------\r\n\r\n");
+    test_remote();
+    printf("\r\n");
+
+    printf("---------------PubSub Tests-----------------\r\n\r\n");
+    test_pubsub();
+    printf("\r\n");
+
+    printf("-------------Collective Tests---------------\r\n\r\n");
+    test_collective();
+    printf("\r\n");
+
+    printf("-------------Dist Matrix Tests--------------\r\n\r\n");
+    test_dist_matrix();
+    printf("\r\n");
+
     return 0;
 }